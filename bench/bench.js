@@ -0,0 +1,247 @@
+/**
+ * Benchmark of the numjs.linalg bindings over a grid of sizes, dtypes and thread counts.
+ * Every case is timed twice: through the JS wrapper (argument checks, out validation, views) and by calling the
+ * native binding directly with the same buffers, so the wrapper overhead shows up separately from the Eigen work.
+ * Both calls write into preallocated outputs, allocation is not part of the timings.
+ *
+ * Run from the repo root after building the addon:
+ * $ npm run bench -- --sizes 2,64,512 --dtypes float64 --threads 1,8 --out bench.json
+ * $ npm run bench -- --quick --compare bench.json <- prints the time ratio of every case to a previous run
+ *
+ * Options:
+ * --functions dot,inv,...   the benchmarks to run, all of them by default (see BENCHMARKS)
+ * --sizes 2,4,...,4096      the matrix sizes n, every benchmark uses n x n operands
+ * --quick                   sizes up to 256 only
+ * --dtypes float64,float32  the dtypes to run
+ * --threads 1,N             the set_num_threads values, 1 and the number of cores by default
+ * --min-time 200            the minimum time in ms spent on each of the wrapper and native loops
+ * --out file.json           writes the results there instead of stdout
+ * --compare file.json       prints the wrapper and native time ratios against the results of a previous run
+ */
+var fs = require('fs');
+var os = require('os');
+var numjs_linalg = require('../numjs.linalg');
+// the build of the bindings numjs_linalg loaded for this CPU
+var isa = numjs_linalg.cpu_features().isa;
+var linalg = require('../build/Release/numjs.linalg' + (isa === "sse2" ? "" : "." + isa));
+
+var DEFAULT_SIZES = [2, 3, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096];
+
+// a n x n matrix with entries in [-1, 1] / sqrt(n), so powers and products stay finite
+function random(n, dtype) {
+    var matrix = numjs_linalg.empty(n, n, dtype), scale = 1 / Math.sqrt(n);
+    for (var i = 0; i < matrix.data.length; i++) {
+        matrix.data[i] = (2 * Math.random() - 1) * scale;
+    }
+    return matrix;
+}
+
+// a well conditioned symmetric positive definite n x n matrix
+function spd(n, dtype) {
+    var a = random(n, dtype);
+    return numjs_linalg.expr(a).mul(numjs_linalg.transpose(a)).add(numjs_linalg.eye(n, n, dtype)).eval();
+}
+
+function vector(n, dtype) {
+    var x = new (dtype === 'float32' ? Float32Array : Float64Array)(n);
+    for (var i = 0; i < n; i++) {
+        x[i] = 2 * Math.random() - 1;
+    }
+    return x;
+}
+
+/**
+ * Every benchmark builds its inputs for a size and dtype and returns the wrapper and the native call, optionally
+ * with the number of floating point operations of one call (reported as GFLOP/s).
+ */
+var BENCHMARKS = {
+    dot: function (n, dtype) {
+        var a = random(n, dtype), x = numjs_linalg.empty(n, 1, dtype), out = numjs_linalg.empty(n, 1, dtype);
+        x.data.set(vector(n, dtype));
+        return {
+            flops: 2 * n * n,
+            wrapper: function () { numjs_linalg.dot(a, x, out); },
+            native: function () { linalg.dot(n, n, a.data, n, 1, x.data, out.data, n, false, n, false); }
+        };
+    },
+    mat_mul: function (n, dtype) {
+        var a = random(n, dtype), b = random(n, dtype), out = numjs_linalg.empty(n, n, dtype);
+        return {
+            flops: 2 * n * n * n,
+            wrapper: function () { numjs_linalg.matrix_mul(a, b, out); },
+            native: function () { linalg.mat_mul(n, n, a.data, n, n, b.data, out.data, n, false, n, false); }
+        };
+    },
+    inv: function (n, dtype) {
+        var a = spd(n, dtype), out = numjs_linalg.empty(n, n, dtype);
+        return {
+            flops: 2 * n * n * n,
+            wrapper: function () { numjs_linalg.inv(a, out); },
+            native: function () { linalg.inv(a.data, n, n, out.data); }
+        };
+    },
+    det: function (n, dtype) {
+        var a = spd(n, dtype);
+        return {
+            flops: 2 * n * n * n / 3,
+            wrapper: function () { numjs_linalg.det(a); },
+            native: function () { linalg.det(a.data, n, n); }
+        };
+    },
+    svd: function (n, dtype) {
+        var a = random(n, dtype), out = {u: numjs_linalg.empty(n, n, dtype), s: vector(n, dtype), v: numjs_linalg.empty(n, n, dtype)};
+        return {
+            wrapper: function () { numjs_linalg.svd(a, false, true, out); },
+            native: function () { linalg.svd(a.data, n, n, false, true, out.u.data, out.s, out.v.data, 0); }
+        };
+    },
+    cholesky: function (n, dtype) {
+        var a = spd(n, dtype), out = numjs_linalg.empty(n, n, dtype);
+        return {
+            flops: n * n * n / 3,
+            wrapper: function () { numjs_linalg.cholesky(a, out); },
+            native: function () { linalg.cholesky(a.data, n, n, out.data); }
+        };
+    },
+    get_eigen_values: function (n, dtype) {
+        var a = random(n, dtype), out = vector(2 * n, dtype);
+        return {
+            wrapper: function () { numjs_linalg.matrix_eigen_values(a, out); },
+            native: function () { linalg.get_eigen_values(n, n, a.data, out); }
+        };
+    },
+    solve: function (n, dtype) {
+        var a = spd(n, dtype), b = vector(n, dtype), x = vector(n, dtype);
+        return {
+            wrapper: function () { numjs_linalg.matrix_solve_linear(a, b, x); },
+            native: function () { linalg.solve_linear_system_householder_qr(n, n, a.data, b, x, n, false); }
+        };
+    },
+    tril: function (n, dtype) {
+        var a = random(n, dtype), out = numjs_linalg.empty(n, n, dtype);
+        return {
+            wrapper: function () { numjs_linalg.tril(a, out); },
+            native: function () { linalg.tril(a.data, n, n, out.data); }
+        };
+    },
+    triu: function (n, dtype) {
+        var a = random(n, dtype), out = numjs_linalg.empty(n, n, dtype);
+        return {
+            wrapper: function () { numjs_linalg.triu(a, out); },
+            native: function () { linalg.triu(a.data, n, n, out.data); }
+        };
+    },
+    matrix_power: function (n, dtype) {
+        var a = random(n, dtype), out = numjs_linalg.empty(n, n, dtype);
+        return {
+            flops: 2 * 2 * n * n * n,
+            wrapper: function () { numjs_linalg.matrix_power(a, 3, out); },
+            native: function () { linalg.matrix_power(a.data, n, n, 3, out.data); }
+        };
+    }
+};
+
+function parseArgs(argv) {
+    var options = {};
+    for (var i = 0; i < argv.length; i++) {
+        var name = argv[i].replace(/^--/, "");
+        if (name === "quick") {
+            options.quick = true;
+        }
+        else {
+            options[name] = argv[++i];
+        }
+    }
+    return options;
+}
+
+function list(value, fallback) {
+    return value === undefined ? fallback : value.split(",").filter(function (item) { return item !== ""; });
+}
+
+// the mean time of one call in ns, over as many calls as fit in minTime ms (at least one after a warm up call)
+function time(body, minTime) {
+    body();
+    var iterations = 0, start = process.hrtime(), elapsed;
+    do {
+        body();
+        iterations++;
+        elapsed = process.hrtime(start);
+    } while (elapsed[0] * 1e3 + elapsed[1] / 1e6 < minTime);
+
+    return {ns: (elapsed[0] * 1e9 + elapsed[1]) / iterations, iterations: iterations};
+}
+
+function key(result) {
+    return [result.function, result.size, result.dtype, result.threads].join(" ");
+}
+
+function run(options) {
+    var functions = list(options.functions, Object.keys(BENCHMARKS)),
+        sizes = list(options.sizes, DEFAULT_SIZES).map(Number).filter(function (n) { return !options.quick || n <= 256; }),
+        dtypes = list(options.dtypes, ["float64", "float32"]),
+        threads = list(options.threads, [1, os.cpus().length]).map(Number).filter(function (t, i, all) { return all.indexOf(t) === i; }),
+        minTime = Number(options["min-time"] || 200), results = [];
+
+    functions.forEach(function (name) {
+        if (!BENCHMARKS.hasOwnProperty(name)) {
+            throw new Error("Unknown benchmark " + name + ", expected one of " + Object.keys(BENCHMARKS).join(", "));
+        }
+    });
+
+    threads.forEach(function (threadCount) {
+        numjs_linalg.set_num_threads(threadCount);
+        functions.forEach(function (name) {
+            dtypes.forEach(function (dtype) {
+                sizes.forEach(function (n) {
+                    var bench = BENCHMARKS[name](n, dtype), wrapper = time(bench.wrapper, minTime),
+                        native = time(bench.native, minTime), result = {
+                            function: name, size: n, dtype: dtype, threads: threadCount,
+                            iterations: wrapper.iterations + native.iterations,
+                            wrapperNs: wrapper.ns, nativeNs: native.ns, overheadNs: wrapper.ns - native.ns
+                        };
+                    if (bench.flops) {
+                        result.gflops = bench.flops / native.ns;
+                    }
+                    results.push(result);
+                    process.stderr.write(key(result) + ": " + (native.ns / 1e3).toFixed(2) + " us native, " +
+                        (result.overheadNs / 1e3).toFixed(2) + " us wrapper overhead\n");
+                });
+            });
+        });
+    });
+
+    return {
+        meta: {
+            version: require('../package.json').version, node: process.version, platform: process.platform,
+            arch: process.arch, cpu: os.cpus()[0].model, cores: os.cpus().length, isa: isa, date: new Date().toISOString()
+        },
+        results: results
+    };
+}
+
+function compare(report, baseline) {
+    var base = {};
+    baseline.results.forEach(function (result) { base[key(result)] = result; });
+
+    report.results.forEach(function (result) {
+        var previous = base[key(result)];
+        if (previous) {
+            process.stderr.write(key(result) + ": native x" + (result.nativeNs / previous.nativeNs).toFixed(2) +
+                ", wrapper x" + (result.wrapperNs / previous.wrapperNs).toFixed(2) + "\n");
+        }
+    });
+}
+
+var options = parseArgs(process.argv.slice(2)), report = run(options), json = JSON.stringify(report, null, 2);
+
+if (options.out) {
+    fs.writeFileSync(options.out, json + "\n");
+}
+else {
+    process.stdout.write(json + "\n");
+}
+
+if (options.compare) {
+    compare(report, JSON.parse(fs.readFileSync(options.compare, "utf8")));
+}
@@ -0,0 +1,126 @@
+/**
+  *  Microbenchmark for the fixed size (2x2, 3x3, 4x4) paths of the kernels in numjs.linalg.cpp.
+  *  Times the same operation on the same buffers mapped as Eigen::MatrixXd (the dynamic path every size
+  *  used to take) and as Eigen::Matrix<double, N, N> (the path DispatchFixedSize picks for N = 2..4).
+  *
+  *  Build and run from the repo root (same Eigen folder as binding.gyp):
+  *  $ g++ -O2 -DNDEBUG -I../eigen-3.4.0 bench/fixed_size.cpp -o build/fixed_size && build/fixed_size
+  *  > cl /O2 /EHsc /DNDEBUG /I..\eigen-3.4.0 bench\fixed_size.cpp /Fe:build\fixed_size.exe
+*/
+#include <Eigen/Dense>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static const int kMatrices = 1024;
+static const int kRounds = 200;
+
+static double sink = 0;
+
+template <typename Body>
+static double NanosPerOp(Body body){
+    body(); // warm up
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; round++) {
+        body();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(kRounds) * kMatrices);
+}
+
+template <int N>
+static void Run(const char *name, std::vector<double> &a, std::vector<double> &b, std::vector<double> &res){
+    using Dyn = Eigen::MatrixXd;
+    using Fix = Eigen::Matrix<double, N, N>;
+    using Vec = Eigen::Matrix<double, N, 1>;
+    const int n = N;
+
+    double inverseDyn = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            Eigen::Map<Dyn> out(&res[i * n * n], n, n);
+            out = Eigen::Map<const Dyn>(&a[i * n * n], n, n).inverse();
+        }
+    });
+    double inverseFix = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            Eigen::Map<Fix> out(&res[i * n * n]);
+            out = Eigen::Map<const Fix>(&a[i * n * n]).inverse();
+        }
+    });
+
+    double detDyn = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            sink += Eigen::Map<const Dyn>(&a[i * n * n], n, n).determinant();
+        }
+    });
+    double detFix = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            sink += Eigen::Map<const Fix>(&a[i * n * n]).determinant();
+        }
+    });
+
+    double mulDyn = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            Eigen::Map<Dyn> out(&res[i * n * n], n, n);
+            out = Eigen::Map<const Dyn>(&a[i * n * n], n, n) * Eigen::Map<const Dyn>(&b[i * n * n], n, n);
+        }
+    });
+    double mulFix = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            Eigen::Map<Fix> out(&res[i * n * n]);
+            out.noalias() = Eigen::Map<const Fix>(&a[i * n * n]) * Eigen::Map<const Fix>(&b[i * n * n]);
+        }
+    });
+
+    double cholDyn = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            Eigen::Map<Dyn> out(&res[i * n * n], n, n);
+            out = Eigen::Map<const Dyn>(&b[i * n * n], n, n).llt().matrixL();
+        }
+    });
+    double cholFix = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            Eigen::Map<Fix> out(&res[i * n * n]);
+            out = Eigen::LLT<Fix>(Eigen::Map<const Fix>(&b[i * n * n])).matrixL();
+        }
+    });
+
+    double solveDyn = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            Eigen::Map<Eigen::VectorXd> x(&res[i * n * n], n);
+            x = Eigen::Map<const Dyn>(&a[i * n * n], n, n).householderQr().solve(Eigen::Map<const Eigen::VectorXd>(&b[i * n * n], n));
+        }
+    });
+    double solveFix = NanosPerOp([&]() {
+        for (int i = 0; i < kMatrices; i++) {
+            Eigen::Map<Vec> x(&res[i * n * n]);
+            x = Eigen::HouseholderQR<Fix>(Eigen::Map<const Fix>(&a[i * n * n])).solve(Eigen::Map<const Vec>(&b[i * n * n]));
+        }
+    });
+
+    std::printf("%-4s %-10s %10.1f %10.1f %8.1fx\n", name, "inv", inverseDyn, inverseFix, inverseDyn / inverseFix);
+    std::printf("%-4s %-10s %10.1f %10.1f %8.1fx\n", name, "det", detDyn, detFix, detDyn / detFix);
+    std::printf("%-4s %-10s %10.1f %10.1f %8.1fx\n", name, "mat_mul", mulDyn, mulFix, mulDyn / mulFix);
+    std::printf("%-4s %-10s %10.1f %10.1f %8.1fx\n", name, "cholesky", cholDyn, cholFix, cholDyn / cholFix);
+    std::printf("%-4s %-10s %10.1f %10.1f %8.1fx\n", name, "solve", solveDyn, solveFix, solveDyn / solveFix);
+}
+
+template <int N>
+static void RunSize(const char *name){
+    std::vector<double> a(kMatrices * N * N), b(kMatrices * N * N), res(kMatrices * N * N);
+    for (int i = 0; i < kMatrices; i++) {
+        Eigen::Map<Eigen::Matrix<double, N, N> > first(&a[i * N * N]);
+        Eigen::Map<Eigen::Matrix<double, N, N> > second(&b[i * N * N]);
+        first = Eigen::Matrix<double, N, N>::Random() + N * Eigen::Matrix<double, N, N>::Identity();
+        second = first * first.transpose(); // positive definite for the cholesky timings
+    }
+    Run<N>(name, a, b, res);
+}
+
+int main(){
+    std::printf("%-4s %-10s %10s %10s %9s\n", "size", "op", "dyn ns", "fixed ns", "speedup");
+    RunSize<2>("2x2");
+    RunSize<3>("3x3");
+    RunSize<4>("4x4");
+    return sink == 42.0;
+}
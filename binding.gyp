@@ -1,12 +1,69 @@
 {
+  # numjs.linalg is the baseline build (SSE2 on x86), numjs.linalg.avx2 and numjs.linalg.avx512 are the same
+  # sources built for wider SIMD. numjs.linalg.js loads the widest one cpu_features reports as supported.
+  "variables": {
+    # Apple clang ships without libomp: OpenMP on macOS is opt-in, with Homebrew's libomp
+    # (node-gyp configure -- -Dmac_openmp=true, -Dlibomp_prefix=/usr/local/opt/libomp on Intel Macs)
+    "mac_openmp%": "false",
+    "libomp_prefix%": "/opt/homebrew/opt/libomp"
+  },
+  "target_defaults": {
+    "include_dirs": [
+      "<!(node -e \"require('nan')\")",
+		"..\\eigen-3.4.0\\"
+    ],
+    "conditions": [
+      [ "OS=='win'", {
+        "msvs_settings": {
+          "VCCLCompilerTool": { "OpenMP": "true" }
+        }
+      }],
+      [ "OS=='mac' and mac_openmp=='true'", {
+        "xcode_settings": {
+          "OTHER_CPLUSPLUSFLAGS": [ "-Xpreprocessor", "-fopenmp", "-I<(libomp_prefix)/include" ],
+          "OTHER_LDFLAGS": [ "-L<(libomp_prefix)/lib", "-lomp" ]
+        }
+      }],
+      [ "OS!='win' and OS!='mac'", {
+        "cflags_cc": [ "-fopenmp" ],
+        "ldflags": [ "-fopenmp" ]
+      }]
+    ]
+  },
   "targets": [
     {
       "target_name": "numjs.linalg",
-      "sources": [ "numjs.linalg.cpp" ],
-      "include_dirs": [
-        "<!(node -e \"require('nan')\")",
-		"..\\eigen-eigen-10219c95fe65\\"
-      ]
+      "sources": [ "numjs.linalg.cpp" ]
+    },
+    {
+      "target_name": "numjs.linalg.cpu",
+      "sources": [ "cpu_features.cpp" ]
     }
+  ],
+  "conditions": [
+    [ "target_arch=='x64' or target_arch=='ia32'", {
+      "targets": [
+        {
+          "target_name": "numjs.linalg.avx2",
+          "sources": [ "numjs.linalg.cpp" ],
+          "cflags_cc": [ "-mavx2", "-mfma" ],
+          "xcode_settings": { "OTHER_CPLUSPLUSFLAGS": [ "-mavx2", "-mfma" ] },
+          "msvs_settings": {
+            "VCCLCompilerTool": { "AdditionalOptions": [ "/arch:AVX2" ] }
+          }
+        },
+        {
+          "target_name": "numjs.linalg.avx512",
+          "sources": [ "numjs.linalg.cpp" ],
+          "cflags_cc": [ "-mavx512f", "-mavx512dq", "-mavx512bw", "-mavx512vl", "-mavx2", "-mfma" ],
+          "xcode_settings": {
+            "OTHER_CPLUSPLUSFLAGS": [ "-mavx512f", "-mavx512dq", "-mavx512bw", "-mavx512vl", "-mavx2", "-mfma" ]
+          },
+          "msvs_settings": {
+            "VCCLCompilerTool": { "AdditionalOptions": [ "/arch:AVX512" ] }
+          }
+        }
+      ]
+    }]
   ]
 }
@@ -0,0 +1,102 @@
+#include <nan.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+/**
+  *  The CPU probe loaded by numjs.linalg.js before the bindings, to pick the widest build of numjs.linalg.cpp the
+  *  CPU can run (see binding.gyp). It is compiled without any instruction set flag and holds no Eigen code, so it
+  *  loads on every x86 CPU, and on other architectures where it reports no feature at all.
+*/
+using v8::Local;
+using v8::Object;
+
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+#define NUMJS_X86 1
+
+// registers[0..3] = eax, ebx, ecx, edx of cpuid leaf, subleaf
+static void Cpuid(unsigned int leaf, unsigned int subleaf, unsigned int registers[4]){
+#if defined(_MSC_VER)
+    int values[4];
+    __cpuidex(values, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) {
+        registers[i] = (unsigned int)values[i];
+    }
+#else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+// the register state the OS saves on context switches (XCR0), the wide registers are only usable when it saves them
+static unsigned long long Xgetbv(){
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+#endif
+
+static void SetFeature(Local<Object> features, const char *name, bool value){
+    Nan::Set(features, Nan::New(name).ToLocalChecked(), Nan::New(value));
+}
+
+/**
+  *  CpuFeatures:
+  *  Return value: an Object of Booleans {sse2, sse4_2, avx, avx2, fma, avx512f, avx512dq, avx512bw, avx512vl},
+  *                true when both the CPU and the OS support the instruction set.
+*/
+NAN_METHOD(CpuFeatures){
+    bool sse2 = false, sse42 = false, avx = false, avx2 = false, fma = false, avx512f = false, avx512dq = false,
+        avx512bw = false, avx512vl = false;
+
+#ifdef NUMJS_X86
+    unsigned int registers[4];
+    Cpuid(0, 0, registers);
+    unsigned int maxLeaf = registers[0];
+
+    Cpuid(1, 0, registers);
+    sse2 = (registers[3] & (1u << 26)) != 0;
+    sse42 = (registers[2] & (1u << 20)) != 0;
+    bool osxsave = (registers[2] & (1u << 27)) != 0;
+    bool cpuAvx = (registers[2] & (1u << 28)) != 0, cpuFma = (registers[2] & (1u << 12)) != 0;
+
+    // XMM and YMM state (bits 1, 2) for AVX, opmask and ZMM state (bits 5, 6, 7) on top of them for AVX-512
+    unsigned long long xcr0 = osxsave ? Xgetbv() : 0;
+    bool osAvx = (xcr0 & 0x6) == 0x6, osAvx512 = (xcr0 & 0xe6) == 0xe6;
+
+    avx = cpuAvx && osAvx;
+    fma = cpuFma && osAvx;
+    if (maxLeaf >= 7) {
+        Cpuid(7, 0, registers);
+        avx2 = osAvx && (registers[1] & (1u << 5)) != 0;
+        avx512f = osAvx512 && (registers[1] & (1u << 16)) != 0;
+        avx512dq = osAvx512 && (registers[1] & (1u << 17)) != 0;
+        avx512bw = osAvx512 && (registers[1] & (1u << 30)) != 0;
+        avx512vl = osAvx512 && (registers[1] & (1u << 31)) != 0;
+    }
+#endif
+
+    Local<Object> features = Nan::New<Object>();
+    SetFeature(features, "sse2", sse2);
+    SetFeature(features, "sse4_2", sse42);
+    SetFeature(features, "avx", avx);
+    SetFeature(features, "avx2", avx2);
+    SetFeature(features, "fma", fma);
+    SetFeature(features, "avx512f", avx512f);
+    SetFeature(features, "avx512dq", avx512dq);
+    SetFeature(features, "avx512bw", avx512bw);
+    SetFeature(features, "avx512vl", avx512vl);
+    info.GetReturnValue().Set(features);
+}
+
+void Init(v8::Local<v8::Object> exports) {
+	exports->Set(Nan::New("cpu_features").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(CpuFeatures)->GetFunction());
+}
+
+NODE_MODULE(cpu_features, Init)
@@ -1,10 +1,240 @@
 #include <nan.h>
 #include <Eigen/SVD>
 #include <iostream>
+#include <functional>
+#include <vector>
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/IterativeLinearSolvers>
+#include <unsupported/Eigen/MatrixFunctions>
+#include <limits>
+#include <climits>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <type_traits>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace v8;
 
+template <typename T> using MatrixX = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+template <typename T> using VectorX = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+/**
+  *  ScalarArray:
+  *  Every binding is a template on the scalar type T (float or double) and is instantiated for both.
+  *  The exported function picks the instantiation from its output buffer: a Float32Array runs the
+  *  single precision kernels, anything else the double ones. Input buffers must be of the same type,
+  *  ScalarArray<T>::Is rejects the other one instead of reinterpreting its bytes.
+*/
+template <typename T> struct ScalarArray;
+
+template <> struct ScalarArray<double> {
+    static bool Is(v8::Local<v8::Value> value) { return value->IsFloat64Array(); }
+    static v8::Local<v8::Float64Array> New(size_t length) {
+        return New(v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), length * sizeof(double)), length);
+    }
+    static v8::Local<v8::Float64Array> New(v8::Local<v8::ArrayBuffer> buffer, size_t length, size_t byteOffset = 0) {
+        return v8::Float64Array::New(buffer, byteOffset, length);
+    }
+};
+
+template <> struct ScalarArray<float> {
+    static bool Is(v8::Local<v8::Value> value) { return value->IsFloat32Array(); }
+    static v8::Local<v8::Float32Array> New(size_t length) {
+        return New(v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), length * sizeof(float)), length);
+    }
+    static v8::Local<v8::Float32Array> New(v8::Local<v8::ArrayBuffer> buffer, size_t length, size_t byteOffset = 0) {
+        return v8::Float32Array::New(buffer, byteOffset, length);
+    }
+};
+
+/**
+  *  KernelWorker:
+  *  Runs a kernel on the libuv threadpool and calls back with (err) on the main thread once it is done.
+  *  Kernels only touch raw buffers, so the binding queuing the worker must pin every typed array
+  *  it hands over (SaveToPersistent) to keep the buffers alive until the callback fires.
+*/
+class KernelWorker : public Nan::AsyncWorker {
+public:
+    KernelWorker(Nan::Callback *callback, std::function<bool()> kernel, const char *errorMessage)
+        : Nan::AsyncWorker(callback), kernel(kernel), errorMessage(errorMessage) {}
+
+    void Execute() {
+        if (!kernel()) {
+            SetErrorMessage(errorMessage);
+        }
+    }
+
+private:
+    std::function<bool()> kernel;
+    const char *errorMessage;
+};
+
+/**
+  *  DispatchFixedSize:
+  *  Calls Kernel<N>::run(n, args...) with N = n for 2x2, 3x3 and 4x4 matrices and N = Eigen::Dynamic otherwise.
+  *  Maps of Eigen::Matrix<T, N, N> use Eigen's closed-form inverses and determinants, fully unrolled
+  *  products and stack temporaries, which matters for the small geometry matrices.
+*/
+template <template <int> class Kernel, typename... Args>
+static auto DispatchFixedSize(size_t n, Args... args) -> decltype(Kernel<Eigen::Dynamic>::run(n, args...)){
+    switch (n) {
+        case 2: return Kernel<2>::run(n, args...);
+        case 3: return Kernel<3>::run(n, args...);
+        case 4: return Kernel<4>::run(n, args...);
+        default: return Kernel<Eigen::Dynamic>::run(n, args...);
+    }
+}
+
+template <typename T>
+static bool Overlaps(const T *a, size_t lengthA, const T *b, size_t lengthB){
+    return a < b + lengthB && b < a + lengthA;
+}
+
+/**
+  *  StridedView:
+  *  A matrix argument which may be a view into a larger column-major buffer (numjs block and transpose).
+  *  The stored block has element (i, j) at data[i + j * ld], and the argument is the transpose of that
+  *  block when transposed is set. Bindings which accept views take ld and transposed as optional trailing
+  *  arguments (see ReadView), without them the buffer is the usual dense rows x cols matrix.
+*/
+template <typename T>
+struct StridedView {
+    using Map = Eigen::Map <const MatrixX<T>, 0, Eigen::OuterStride<> >;
+
+    const T *data;
+    size_t rows, cols;
+    size_t ld;
+    bool transposed;
+
+    size_t StoredRows() const { return transposed ? cols : rows; }
+    size_t StoredCols() const { return transposed ? rows : cols; }
+    size_t Span() const { return StoredCols() == 0 ? 0 : ld * (StoredCols() - 1) + StoredRows(); }
+    bool IsDense() const { return !transposed && ld == rows; }
+
+    Map Stored() const {
+        return Map(data, StoredRows(), StoredCols(), Eigen::OuterStride<>(ld));
+    }
+
+    StridedView Transposed() const {
+        return StridedView{data, cols, rows, ld, !transposed};
+    }
+};
+
+// reads the optional ld and transposed arguments at info[index] and info[index + 1], throws when the view
+// reaches past the end of its buffer
+template <typename T>
+static bool ReadView(const Nan::FunctionCallbackInfo<v8::Value>& info, int index, const T *data, size_t length,
+                     size_t rows, size_t cols, StridedView<T> &view){
+    view = StridedView<T>{data, rows, cols, rows, false};
+    if (info.Length() > index && info[index]->IsUint32()) {
+        view.ld = info[index]->Uint32Value();
+        view.transposed = info.Length() > index + 1 && info[index + 1]->BooleanValue();
+    }
+
+    if (view.ld < view.StoredRows() || view.Span() > length) {
+        Nan::ThrowTypeError("Wrong arguments - the matrix view does not fit in its buffer");
+        return false;
+    }
+    return true;
+}
+
+template <typename T, typename Left, typename Right>
+static void AssignProduct(Eigen::Map <MatrixX<T> > &res, const Left &left, const Right &right){
+    res.noalias() = left * right;
+}
+
+// res = left * right for views, the transposed ones are read in place by GEMM
+template <typename T>
+static void ViewProductKernel(const StridedView<T> &left, const StridedView<T> &right, T *resRawData){
+    Eigen::Map <MatrixX<T> > res(resRawData, left.rows, right.cols);
+
+    if (Overlaps<T>(resRawData, left.rows * right.cols, left.data, left.Span()) ||
+        Overlaps<T>(resRawData, left.rows * right.cols, right.data, right.Span())) {
+        MatrixX<T> temp(left.rows, right.cols);
+        ViewProductKernel(left, right, temp.data());
+        res = temp;
+        return;
+    }
+
+    if (left.transposed && right.transposed) {
+        AssignProduct(res, left.Stored().transpose(), right.Stored().transpose());
+    }
+    else if (left.transposed) {
+        AssignProduct(res, left.Stored().transpose(), right.Stored());
+    }
+    else if (right.transposed) {
+        AssignProduct(res, left.Stored(), right.Stored().transpose());
+    }
+    else {
+        AssignProduct(res, left.Stored(), right.Stored());
+    }
+}
+
+/**
+  *  Aligned storage:
+  *  Matrix data allocated by the addon (see Alloc) starts on a 64 byte boundary, one cache line and the
+  *  widest AVX-512 load. The coefficient-wise kernels below map such buffers with Eigen::Aligned64 so Eigen
+  *  skips its unaligned peeling; buffers allocated by plain typed array constructors keep the default maps.
+*/
+static const size_t kAlignment = 64;
+
+template <typename T>
+static bool IsAligned(const T *data){
+    return reinterpret_cast<uintptr_t>(data) % kAlignment == 0;
+}
+
+// the pointer malloc returned is kept just before the aligned block
+static char *AlignedAlloc(size_t bytes){
+    char *original = static_cast<char *>(std::malloc(bytes + kAlignment));
+    if (original == nullptr) {
+        return nullptr;
+    }
+
+    char *aligned = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(original) + kAlignment) & ~(uintptr_t)(kAlignment - 1));
+    reinterpret_cast<char **>(aligned)[-1] = original;
+    return aligned;
+}
+
+// free callback of the external buffers, V8 counts their bytes as external memory itself
+static void AlignedFree(char *data, void *hint){
+    std::free(reinterpret_cast<char **>(data)[-1]);
+}
+
+template <typename T>
+static void FillKernel(T *data, size_t length, T value){
+    if (IsAligned(data)) {
+        Eigen::Map <VectorX<T>, Eigen::Aligned64> (data, length).setConstant(value);
+    }
+    else {
+        Eigen::Map <VectorX<T> > (data, length).setConstant(value);
+    }
+}
+
+template <typename T>
+static void ScaleKernel(const T *data, size_t length, T scalar, T *resRawData){
+    if (IsAligned(data) && IsAligned(resRawData)) {
+        Eigen::Map <VectorX<T>, Eigen::Aligned64> res(resRawData, length);
+        res = scalar * Eigen::Map <const VectorX<T>, Eigen::Aligned64> (data, length);
+    }
+    else {
+        Eigen::Map <VectorX<T> > res(resRawData, length);
+        res = scalar * Eigen::Map <const VectorX<T> > (data, length);
+    }
+}
+
+template <typename T>
+static bool MatMulKernel(const T *data1, size_t rows1, size_t cols1,
+                         const T *data2, size_t rows2, size_t cols2, T *resRawData);
+
 /**
   *  Dot:
   *  Dot product of two arrays.
@@ -14,16 +244,19 @@ using namespace v8;
   *  arguments:
   *  info[0]: Number represent the number of rows of the left matrix.
   *  info[1]: Number represent the number of columns of the left matrix.
-  *  info[2]: Buffer(object created by Float64Array) represent the left numjs.Matrix object .
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) represent the left numjs.Matrix object .
   *  info[3]: Number represent the number of rows of the right matrix.
   *  info[4]: Number represent the number of columns of the right matrix.
-  *  info[5]: Buffer(object created by Float64Array) represent the right numjs.Matrix object .
-  *  info[6]: Buffer(object created by Float64Array) for return value, which is the dot product of
+  *  info[5]: Buffer(object created by Float64Array or Float32Array) represent the right numjs.Matrix object .
+  *  info[6]: Buffer(object created by Float64Array or Float32Array) for return value, which is the dot product of
   *           left matrix and right matrix.
+  *  info[7], info[8]: Optional - leading dimension and transposed flag of the left matrix (see StridedView).
+  *  info[9], info[10]: Optional - leading dimension and transposed flag of the right matrix.
 */
-void Dot(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void DotImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
 	if (info.Length() < 7) {
 		Nan::ThrowTypeError("Wrong number of arguments");
@@ -36,19 +269,17 @@ void Dot(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 
 	if (info[2]->IsNumber()) {
-	    double leftParam(info[2]->NumberValue());
+	    T leftParam(info[2]->NumberValue());
 
 	    if(!info[5]->IsNumber()){          
-			if (info[5]->IsFloat64Array()) {
-				double *refRightData = *(Nan::TypedArrayContents<double>(info[5]));
+			if (ScalarArray<T>::Is(info[5])) {
+				T *refRightData = *(Nan::TypedArrayContents<T>(info[5]));
                 size_t rowsRight(info[3]->Uint32Value());
                 size_t colsRight(info[4]->Uint32Value());
-                CMd rightMat(refRightData, rowsRight, colsRight);
 
-				if (info[6]->IsFloat64Array()) {
-					double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
-                    Md res(refResData, rowsRight, colsRight);
-                    res = leftParam * rightMat;
+				if (ScalarArray<T>::Is(info[6])) {
+					T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
+                    ScaleKernel(refRightData, rowsRight * colsRight, leftParam, refResData);
 
                     Local<Boolean> b = Nan::New(true);
                     info.GetReturnValue().Set(b);
@@ -58,34 +289,40 @@ void Dot(const Nan::FunctionCallbackInfo<v8::Value>& info){
 
     }
 	else{
-		if (info[2]->IsFloat64Array()) {
-			double *refLeftData = *(Nan::TypedArrayContents<double>(info[2])); 
+		if (ScalarArray<T>::Is(info[2])) {
+			T *refLeftData = *(Nan::TypedArrayContents<T>(info[2])); 
 	        size_t rowsLeft(info[0]->Uint32Value());
             size_t colsLeft(info[1]->Uint32Value());
-            CMd leftMat(refLeftData, rowsLeft, colsLeft);
 
             if(info[5]->IsNumber()){
-                double rightParam(info[5]->NumberValue());
+                T rightParam(info[5]->NumberValue());
                 
-				if (info[6]->IsFloat64Array()) {
-					double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
-                    Md res(refResData, rowsLeft, colsLeft);
-                    res = leftMat * rightParam;
+				if (ScalarArray<T>::Is(info[6])) {
+					T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
+                    ScaleKernel(refLeftData, rowsLeft * colsLeft, rightParam, refResData);
                     Local<Boolean> b = Nan::New(true);
                     info.GetReturnValue().Set(b);
                 }
             }
             else{
-				if (info[5]->IsFloat64Array()) {
-					double *refRightData = *(Nan::TypedArrayContents<double>(info[5]));
+				if (ScalarArray<T>::Is(info[5])) {
+					T *refRightData = *(Nan::TypedArrayContents<T>(info[5]));
                 	size_t rowsRight(info[3]->Uint32Value());
                     size_t colsRight(info[4]->Uint32Value());
-                    CMd rightMat(refRightData, rowsRight, colsRight);
+                    StridedView<T> left, right;
+                    if (!ReadView(info, 7, refLeftData, Nan::TypedArrayContents<T>(info[2]).length(), rowsLeft, colsLeft, left) ||
+                        !ReadView(info, 9, refRightData, Nan::TypedArrayContents<T>(info[5]).length(), rowsRight, colsRight, right)) {
+                        return;
+                    }
 
-					if (info[6]->IsFloat64Array()) {
-						double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
-                        Md res(refResData, rowsLeft, colsRight);
-                         res = leftMat * rightMat;
+					if (ScalarArray<T>::Is(info[6])) {
+						T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
+                        if (left.IsDense() && right.IsDense()) {
+                            MatMulKernel(refLeftData, rowsLeft, colsLeft, refRightData, rowsRight, colsRight, refResData);
+                        }
+                        else {
+                            ViewProductKernel(left, right, refResData);
+                        }
                         Local<Boolean> b = Nan::New(true);
                         info.GetReturnValue().Set(b);
                     }
@@ -102,6 +339,15 @@ void Dot(const Nan::FunctionCallbackInfo<v8::Value>& info){
 	}
 }
 
+void Dot(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[6]->IsFloat32Array()) {
+        DotImpl<float>(info);
+    }
+    else {
+        DotImpl<double>(info);
+    }
+}
+
 /**
   *  Inner:
   *  Inner product of two arrays.
@@ -112,15 +358,18 @@ void Dot(const Nan::FunctionCallbackInfo<v8::Value>& info){
   *  arguments:
   *  info[0]: Number represent the number of rows of the left matrix.
   *  info[1]: Number represent the number of columns of the left matrix.
-  *  info[2]: Buffer(object created by Float64Array) represent the left numjs.Matrix object .
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) represent the left numjs.Matrix object .
   *  info[3]: Number represent the number of rows of the right matrix.
   *  info[4]: Number represent the number of columns of the right matrix.
-  *  info[5]: Buffer(object created by Float64Array) represent the right numjs.Matrix object .
-  *  info[6]: Buffer(object created by Float64Array) for return value.
+  *  info[5]: Buffer(object created by Float64Array or Float32Array) represent the right numjs.Matrix object .
+  *  info[6]: Buffer(object created by Float64Array or Float32Array) for return value.
+  *  info[7], info[8]: Optional - leading dimension and transposed flag of the left matrix (see StridedView).
+  *  info[9], info[10]: Optional - leading dimension and transposed flag of the right matrix.
 */
-void Inner(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void InnerImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
 	if (info.Length() < 7) {
 		Nan::ThrowTypeError("Wrong number of arguments");
@@ -133,19 +382,17 @@ void Inner(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 
 	if (info[2]->IsNumber()) {
-	    double leftParam(info[2]->NumberValue());
+	    T leftParam(info[2]->NumberValue());
 
 	    if(!info[5]->IsNumber()){
-			if (info[5]->IsFloat64Array()) {
-				double *refRightData = *(Nan::TypedArrayContents<double>(info[5]));
+			if (ScalarArray<T>::Is(info[5])) {
+				T *refRightData = *(Nan::TypedArrayContents<T>(info[5]));
                 size_t rowsRight(info[3]->Uint32Value());
                 size_t colsRight(info[4]->Uint32Value());
-                CMd rightMat(refRightData, rowsRight, colsRight);
 
-				if (info[6]->IsFloat64Array()) {
-					double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
-                    Md res(refResData, rowsRight, colsRight);
-                    res = leftParam * rightMat;
+				if (ScalarArray<T>::Is(info[6])) {
+					T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
+                    ScaleKernel(refRightData, rowsRight * colsRight, leftParam, refResData);
 
                     Local<Boolean> b = Nan::New(true);
                     info.GetReturnValue().Set(b);
@@ -155,35 +402,45 @@ void Inner(const Nan::FunctionCallbackInfo<v8::Value>& info){
 
     }
 	else{
-		if (info[2]->IsFloat64Array()) {
-			double *refLeftData = *(Nan::TypedArrayContents<double>(info[2]));
+		if (ScalarArray<T>::Is(info[2])) {
+			T *refLeftData = *(Nan::TypedArrayContents<T>(info[2]));
 	        size_t rowsLeft(info[0]->Uint32Value());
             size_t colsLeft(info[1]->Uint32Value());
             CMd leftMat(refLeftData, rowsLeft, colsLeft);
 
             if(info[5]->IsNumber()){
-                double rightParam(info[5]->NumberValue());
+                T rightParam(info[5]->NumberValue());
 
-				if (info[6]->IsFloat64Array()) {
-					double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
-                    Md res(refResData, rowsLeft, colsLeft);
-                    res = leftMat * rightParam;
+				if (ScalarArray<T>::Is(info[6])) {
+					T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
+                    ScaleKernel(refLeftData, rowsLeft * colsLeft, rightParam, refResData);
                     Local<Boolean> b = Nan::New(true);
                     info.GetReturnValue().Set(b);
                 }
             }
             else{
-				if (info[5]->IsFloat64Array()) {
-					double *refRightData = *(Nan::TypedArrayContents<double>(info[5]));
+				if (ScalarArray<T>::Is(info[5])) {
+					T *refRightData = *(Nan::TypedArrayContents<T>(info[5]));
                 	size_t rowsRight(info[3]->Uint32Value());
                     size_t colsRight(info[4]->Uint32Value());
                     CMd rightMat(refRightData, rowsRight, colsRight);
 
-					if (info[6]->IsFloat64Array()) {
-						double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
+                    StridedView<T> left, right;
+                    if (!ReadView(info, 7, refLeftData, Nan::TypedArrayContents<T>(info[2]).length(), rowsLeft, colsLeft, left) ||
+                        !ReadView(info, 9, refRightData, Nan::TypedArrayContents<T>(info[5]).length(), rowsRight, colsRight, right)) {
+                        return;
+                    }
+
+					if (ScalarArray<T>::Is(info[6])) {
+						T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
                         Md res(refResData, rowsLeft, rowsRight);
 
-                        res = (rightMat * leftMat.transpose()).transpose();
+                        if (left.IsDense() && right.IsDense()) {
+                            res = (rightMat * leftMat.transpose()).transpose();
+                        }
+                        else {
+                            ViewProductKernel(left, right.Transposed(), refResData);
+                        }
 
                         Local<Boolean> b = Nan::New(true);
                         info.GetReturnValue().Set(b);
@@ -201,6 +458,15 @@ void Inner(const Nan::FunctionCallbackInfo<v8::Value>& info){
 	}
 }
 
+void Inner(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[6]->IsFloat32Array()) {
+        InnerImpl<float>(info);
+    }
+    else {
+        InnerImpl<double>(info);
+    }
+}
+
 /**
   *  Outer:
   *  Outer product of two arrays.
@@ -209,15 +475,16 @@ void Inner(const Nan::FunctionCallbackInfo<v8::Value>& info){
   *  arguments:
   *  info[0]: Number represent the number of rows of the left matrix.
   *  info[1]: Number represent the number of columns of the left matrix.
-  *  info[2]: Buffer(object created by Float64Array) represent the left numjs.Matrix object .
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) represent the left numjs.Matrix object .
   *  info[3]: Number represent the number of rows of the right matrix.
   *  info[4]: Number represent the number of columns of the right matrix.
-  *  info[5]: Buffer(object created by Float64Array) represent the right numjs.Matrix object .
-  *  info[6]: Buffer(object created by Float64Array) for return value.
+  *  info[5]: Buffer(object created by Float64Array or Float32Array) represent the right numjs.Matrix object .
+  *  info[6]: Buffer(object created by Float64Array or Float32Array) for return value.
 */
-void Outer(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void OuterImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
 	if (info.Length() < 7) {
 		Nan::ThrowTypeError("Wrong number of arguments");
@@ -230,19 +497,17 @@ void Outer(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 
 	if (info[2]->IsNumber()) {
-	    double leftParam(info[2]->NumberValue());
+	    T leftParam(info[2]->NumberValue());
 
 	    if(!info[5]->IsNumber()){
-			if (info[5]->IsFloat64Array()) {
-				double *refRightData = *(Nan::TypedArrayContents<double>(info[5]));
+			if (ScalarArray<T>::Is(info[5])) {
+				T *refRightData = *(Nan::TypedArrayContents<T>(info[5]));
                 size_t rowsRight(info[3]->Uint32Value());
                 size_t colsRight(info[4]->Uint32Value());
-                CMd rightMat(refRightData, rowsRight, colsRight);
 
-				if (info[6]->IsFloat64Array()) {
-					double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
-                    Md res(refResData, rowsRight, colsRight);
-                    res = leftParam * rightMat;
+				if (ScalarArray<T>::Is(info[6])) {
+					T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
+                    ScaleKernel(refRightData, rowsRight * colsRight, leftParam, refResData);
 
                     Local<Boolean> b = Nan::New(true);
                     info.GetReturnValue().Set(b);
@@ -252,32 +517,31 @@ void Outer(const Nan::FunctionCallbackInfo<v8::Value>& info){
 
     }
 	else{
-		if (info[2]->IsFloat64Array()) {
-			double *refLeftData = *(Nan::TypedArrayContents<double>(info[2]));
+		if (ScalarArray<T>::Is(info[2])) {
+			T *refLeftData = *(Nan::TypedArrayContents<T>(info[2]));
 	        size_t rowsLeft(info[0]->Uint32Value());
             size_t colsLeft(info[1]->Uint32Value());
             CMd leftMat(refLeftData, rowsLeft, colsLeft);
 
             if(info[5]->IsNumber()){
-                double rightParam(info[5]->NumberValue());
+                T rightParam(info[5]->NumberValue());
 
-				if (info[6]->IsFloat64Array()) {
-					double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
-                    Md res(refResData, rowsLeft, colsLeft);
-                    res = leftMat * rightParam;
+				if (ScalarArray<T>::Is(info[6])) {
+					T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
+                    ScaleKernel(refLeftData, rowsLeft * colsLeft, rightParam, refResData);
                     Local<Boolean> b = Nan::New(true);
                     info.GetReturnValue().Set(b);
                 }
             }
             else{
-				if (info[5]->IsFloat64Array()) {
-					double *refRightData = *(Nan::TypedArrayContents<double>(info[5]));
+				if (ScalarArray<T>::Is(info[5])) {
+					T *refRightData = *(Nan::TypedArrayContents<T>(info[5]));
                 	size_t rowsRight(info[3]->Uint32Value());
                     size_t colsRight(info[4]->Uint32Value());
                     CMd rightMat(refRightData, rowsRight, colsRight);
 
-					if (info[6]->IsFloat64Array()) {
-						double *refResData = *(Nan::TypedArrayContents<double>(info[6]));
+					if (ScalarArray<T>::Is(info[6])) {
+						T *refResData = *(Nan::TypedArrayContents<T>(info[6]));
                         Md res(refResData, rowsLeft, colsRight);
 
                         res = leftMat * rightMat;
@@ -298,6 +562,15 @@ void Outer(const Nan::FunctionCallbackInfo<v8::Value>& info){
 	}
 }
 
+void Outer(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[6]->IsFloat32Array()) {
+        OuterImpl<float>(info);
+    }
+    else {
+        OuterImpl<double>(info);
+    }
+}
+
 /**
   *  Cholesky:
   *  Return the Cholesky decomposition, L * L.H, of the square matrix a,
@@ -306,15 +579,45 @@ void Outer(const Nan::FunctionCallbackInfo<v8::Value>& info){
   *  (symmetric if real-valued) and positive-definite. Only L is actually returned.
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be inverted.
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be inverted.
   *           Must be square, i.e. M.rows == M.cols.
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
-  *  info[3]: Buffer(object created by Float64Array) for return value, inverse of the given matrix.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for return value, inverse of the given matrix.
+  *           Can be the info[0] buffer to compute the result in place.
 */
-void Cholesky(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <int N>
+struct CholeskyKernelN {
+    template <typename T>
+    static bool run(size_t n, const T *refMatrixData, T *refResData){
+        using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+        using Md = Eigen::Map <Eigen::Matrix<T, N, N> >;
+
+        Md res(refResData, n, n);
+
+        if (refMatrixData == refResData) {
+            // in place, the factor overwrites the lower triangle without copying the matrix
+            Eigen::LLT<Eigen::Ref<Eigen::Matrix<T, N, N> > > llt(res);
+            res.template triangularView<Eigen::StrictlyUpper>().setZero();
+            return llt.info() == Eigen::Success;
+        }
+
+        CMd inputMat(refMatrixData, n, n);
+        Eigen::LLT<Eigen::Matrix<T, N, N> > llt(inputMat);
+        res = llt.matrixL();
+        return llt.info() == Eigen::Success;
+    }
+};
+
+template <typename T>
+static bool CholeskyKernel(const T *refMatrixData, size_t rowsMatrix, size_t colsMatrix, T *refResData){
+    return DispatchFixedSize<CholeskyKernelN>(rowsMatrix, refMatrixData, refResData);
+}
+
+template <typename T>
+static void CholeskyImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 4) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -326,18 +629,14 @@ void Cholesky(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
+	if (ScalarArray<T>::Is(info[0])) {
+		T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
         size_t rowsMatrix(info[1]->Uint32Value());
         size_t colsMatrix(info[2]->Uint32Value());
 
-        Md inputMat(refMatrixData, rowsMatrix, colsMatrix);
-
-		if (info[3]->IsFloat64Array()) {
-			double *refResData = *(Nan::TypedArrayContents<double>(info[3]));
-            Md res(refResData, rowsMatrix, colsMatrix);
-            res = inputMat.llt().matrixL();
-            Local<Boolean> b = Nan::New(true);
+		if (ScalarArray<T>::Is(info[3])) {
+			T *refResData = *(Nan::TypedArrayContents<T>(info[3]));
+            Local<Boolean> b = Nan::New(CholeskyKernel(refMatrixData, rowsMatrix, colsMatrix, refResData));
             info.GetReturnValue().Set(b);
         }
         else{
@@ -353,6 +652,15 @@ void Cholesky(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
+void Cholesky(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[3]->IsFloat32Array()) {
+        CholeskyImpl<float>(info);
+    }
+    else {
+        CholeskyImpl<double>(info);
+    }
+}
+
 /**
   *  Identity:
   *  Creates a new identity matrix - a square nXn matrix with ones on the diagonal
@@ -360,11 +668,12 @@ void Cholesky(const Nan::FunctionCallbackInfo<v8::Value>& info){
   *
   *  arguments:
   *  info[0]: Number n which represents the matrix dimensions
-  *  info[2]: Buffer(object created by Float64Array) for return value(identity matrix nXn).
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) for return value(identity matrix nXn).
 */
-void Identity(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void IdentityImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 2) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -376,13 +685,13 @@ void Identity(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-    if (info[1]->IsFloat64Array()) {
+    if (ScalarArray<T>::Is(info[1])) {
         size_t rowsMatrix(info[0]->Uint32Value());
         size_t colsMatrix(info[0]->Uint32Value());
 
-        double *refResData = *(Nan::TypedArrayContents<double>(info[1]));
+        T *refResData = *(Nan::TypedArrayContents<T>(info[1]));
         Md res(refResData, rowsMatrix, colsMatrix);
-        res = Md::Identity(rowsMatrix, colsMatrix);
+        res.setIdentity();
 
         Local<Boolean> b = Nan::New(true);
         info.GetReturnValue().Set(b);
@@ -395,6 +704,15 @@ void Identity(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
+void Identity(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[1]->IsFloat32Array()) {
+        IdentityImpl<float>(info);
+    }
+    else {
+        IdentityImpl<double>(info);
+    }
+}
+
 /**
   *  Tri:
   *  Creates a new nXm matrix with ones at and below the matrix diagonal
@@ -403,11 +721,12 @@ void Identity(const Nan::FunctionCallbackInfo<v8::Value>& info){
   *  arguments:
   *  info[0]: Number n which represents the number of rows in the newly built matrix
   *  info[1]: Number m which represents the number of cols in the newly built matrix
-  *  info[2]: Buffer(object created by Float64Array) for return value(eye matrix nXm).
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) for return value(eye matrix nXm).
 */
-void Tri(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void TriImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 3) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -419,13 +738,13 @@ void Tri(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-    if (info[2]->IsFloat64Array()) {
+    if (ScalarArray<T>::Is(info[2])) {
         size_t rowsMatrix(info[0]->Uint32Value());
         size_t colsMatrix(info[1]->Uint32Value());
 
-        double *refResData = *(Nan::TypedArrayContents<double>(info[2]));
+        T *refResData = *(Nan::TypedArrayContents<T>(info[2]));
         Md res(refResData, rowsMatrix, colsMatrix);
-        res = Md::Ones(rowsMatrix, colsMatrix);
+        res.setOnes();
         for (int i = 0; i < rowsMatrix; i++) {
             for (int j = i + 1; j < colsMatrix; j++) {
                 res(i, j) = 0;
@@ -443,6 +762,15 @@ void Tri(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
+void Tri(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[2]->IsFloat32Array()) {
+        TriImpl<float>(info);
+    }
+    else {
+        TriImpl<double>(info);
+    }
+}
+
 /**
   *  Eye:
   *  Creates a new nXm matrix with ones on the diagonal
@@ -451,11 +779,12 @@ void Tri(const Nan::FunctionCallbackInfo<v8::Value>& info){
   *  arguments:
   *  info[0]: Number n which represents the number of rows in the newly built matrix
   *  info[1]: Number m which represents the number of cols in the newly built matrix
-  *  info[2]: Buffer(object created by Float64Array) for return value(eye matrix nXm).
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) for return value(eye matrix nXm).
 */
-void Eye(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void EyeImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 3) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -467,13 +796,13 @@ void Eye(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-    if (info[2]->IsFloat64Array()) {
+    if (ScalarArray<T>::Is(info[2])) {
         size_t rowsMatrix(info[0]->Uint32Value());
         size_t colsMatrix(info[1]->Uint32Value());
 
-        double *refResData = *(Nan::TypedArrayContents<double>(info[2]));
+        T *refResData = *(Nan::TypedArrayContents<T>(info[2]));
         Md res(refResData, rowsMatrix, colsMatrix);
-        res = Md::Identity(rowsMatrix, colsMatrix);
+        res.setIdentity();
 
         Local<Boolean> b = Nan::New(true);
         info.GetReturnValue().Set(b);
@@ -486,19 +815,30 @@ void Eye(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
+void Eye(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[2]->IsFloat32Array()) {
+        EyeImpl<float>(info);
+    }
+    else {
+        EyeImpl<double>(info);
+    }
+}
+
 /**
   *  Tril:
   *  Creates a copy of a given matrix with all elements above the diagonal zeroed
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be converted to lower diagonal matrix
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be converted to lower diagonal matrix
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
-  *  info[3]: Buffer(object created by Float64Array) for return value(M**m).
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for return value(M**m),
+  *           can be the info[0] buffer to zero the matrix in place.
 */
-void Tril(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void TrilImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 4) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -510,14 +850,14 @@ void Tril(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
+	if (ScalarArray<T>::Is(info[0])) {
+		T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
         size_t rowsMatrix(info[1]->Uint32Value());
         size_t colsMatrix(info[2]->Uint32Value());
         Md inputMat(refMatrixData, rowsMatrix, colsMatrix);
 
-		if (info[3]->IsFloat64Array()) {
-			double *refResData = *(Nan::TypedArrayContents<double>(info[3]));
+		if (ScalarArray<T>::Is(info[3])) {
+			T *refResData = *(Nan::TypedArrayContents<T>(info[3]));
             Md res(refResData, rowsMatrix, colsMatrix);
             for (int i = 0; i < rowsMatrix; i++) {
                 for (int j = 0; j < colsMatrix; j++) {
@@ -534,31 +874,42 @@ void Tril(const Nan::FunctionCallbackInfo<v8::Value>& info){
         }
 
         else{
-            Nan::ThrowTypeError("Wrong argument - output matrix data should be float64array");
+            Nan::ThrowTypeError("Wrong argument - output matrix data should be float64array or float32array");
             Local<Boolean> b = Nan::New(false);
             info.GetReturnValue().Set(b);
         }
     }
     else{
-        Nan::ThrowTypeError("Wrong argument - input matrix data should be float64array");
+        Nan::ThrowTypeError("Wrong argument - input matrix data should be float64array or float32array");
         Local<Boolean> b = Nan::New(false);
         info.GetReturnValue().Set(b);
     }
 }
 
+void Tril(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[3]->IsFloat32Array()) {
+        TrilImpl<float>(info);
+    }
+    else {
+        TrilImpl<double>(info);
+    }
+}
+
 /**
   *  Triu:
   *  Creates a copy of a given matrix with all elements below the diagonal zeroed
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be converted to lower diagonal matrix
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be converted to lower diagonal matrix
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
-  *  info[3]: Buffer(object created by Float64Array) for return value(M**m).
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for return value(M**m),
+  *           can be the info[0] buffer to zero the matrix in place.
 */
-void Triu(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void TriuImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 4) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -570,14 +921,14 @@ void Triu(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
+	if (ScalarArray<T>::Is(info[0])) {
+		T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
         size_t rowsMatrix(info[1]->Uint32Value());
         size_t colsMatrix(info[2]->Uint32Value());
         Md inputMat(refMatrixData, rowsMatrix, colsMatrix);
 
-		if (info[3]->IsFloat64Array()) {
-			double *refResData = *(Nan::TypedArrayContents<double>(info[3]));
+		if (ScalarArray<T>::Is(info[3])) {
+			T *refResData = *(Nan::TypedArrayContents<T>(info[3]));
             Md res(refResData, rowsMatrix, colsMatrix);
             for (int i = 0; i < rowsMatrix; i++) {
                 for (int j = 0; j < colsMatrix; j++) {
@@ -594,87 +945,221 @@ void Triu(const Nan::FunctionCallbackInfo<v8::Value>& info){
         }
 
         else{
-            Nan::ThrowTypeError("Wrong argument - output matrix data should be float64array");
+            Nan::ThrowTypeError("Wrong argument - output matrix data should be float64array or float32array");
             Local<Boolean> b = Nan::New(false);
             info.GetReturnValue().Set(b);
         }
     }
     else{
-        Nan::ThrowTypeError("Wrong argument - input matrix data should be float64array");
+        Nan::ThrowTypeError("Wrong argument - input matrix data should be float64array or float32array");
         Local<Boolean> b = Nan::New(false);
         info.GetReturnValue().Set(b);
     }
 }
 
+void Triu(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[3]->IsFloat32Array()) {
+        TriuImpl<float>(info);
+    }
+    else {
+        TriuImpl<double>(info);
+    }
+}
+
 /**
   *  MatrixPower:
-  *  Raise a square matrix to the (integer) power n.
+  *  Raise a square matrix to the integer power n by binary exponentiation, i.e. O(log |n|) matrix products.
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be "powered".
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be "powered".
   *           Must be square, i.e. M.rows == M.cols.
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
-  *  info[3]: Number m represent the exponent. Can be any integer or long integer, positive, negative, or zero.
-  *  info[4]: Buffer(object created by Float64Array) for return value(M**m).
-              If the exponent is positive or zero then the type of the elements is the same as those of M.
-              If the exponent is negative the elements are floating-point.
+  *  info[3]: Number m represent the exponent. Must be an integer, positive, negative (M is inverted first) or zero.
+  *  info[4]: Buffer(object created by Float64Array or Float32Array) for return value(M**m), may be info[0] itself.
 */
-void MatrixPower(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void MatrixPowerKernel(const T *refMatrixData, size_t n, long long exponent, T *refResData){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    Md res(refResData, n, n);
+    if (exponent == 0) {
+        res.setIdentity();
+        return;
+    }
+
+    // base is squared in place, so it is always a copy, which also makes res safe to overlap the input
+    MatrixX<T> base = CMd(refMatrixData, n, n);
+    if (exponent < 0) {
+        base = base.inverse().eval();
+    }
+
+    unsigned long long bits = exponent < 0 ? -exponent : exponent;
+    MatrixX<T> acc, scratch(n, n);
+    bool hasAcc = false;
+    while (true) {
+        if (bits & 1) {
+            if (hasAcc) {
+                scratch.noalias() = acc * base;
+                acc.swap(scratch);
+            }
+            else {
+                acc = base;
+                hasAcc = true;
+            }
+        }
+        bits >>= 1;
+        if (bits == 0) {
+            break;
+        }
+        scratch.noalias() = base * base;
+        base.swap(scratch);
+    }
+    res = acc;
+}
 
+template <typename T>
+static void MatrixPowerImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
     if (info.Length() < 5) {
         Nan::ThrowTypeError("Wrong number of arguments");
         return;
     }
 
-    if (!info[1]->IsNumber() || !info[2]->IsNumber() || !info[3]->IsNumber()) {
+    if (!info[1]->IsUint32() || !info[2]->IsUint32() || !info[3]->IsNumber() ||
+        !ScalarArray<T>::Is(info[0]) || !ScalarArray<T>::Is(info[4])) {
         Nan::ThrowTypeError("Wrong arguments");
         return;
     }
 
-    
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
-        size_t rowsMatrix(info[1]->Uint32Value());
-        size_t colsMatrix(info[2]->Uint32Value());
-        double expParam(info[3]->NumberValue());
-        Md inputMat(refMatrixData, rowsMatrix, colsMatrix);
+    size_t rowsMatrix(info[1]->Uint32Value());
+    size_t colsMatrix(info[2]->Uint32Value());
+    double expParam(info[3]->NumberValue());
 
-		if (info[4]->IsFloat64Array()) {
-			double *refResData = *(Nan::TypedArrayContents<double>(info[4]));
-            Md res(refResData, rowsMatrix, colsMatrix);
+    if (rowsMatrix != colsMatrix) {
+        Nan::ThrowTypeError("Wrong arguments - matrix must be square");
+        return;
+    }
 
-            if(expParam == 0){
-                res = inputMat.Identity(rowsMatrix, colsMatrix);
-            }
-            else{
-                res = inputMat;
-                if(expParam < 0){
-                    res = res.inverse();
-                }
+    // non integer exponents used to be truncated silently, expm(p * logm(M)) is the real power of M
+    if (expParam != std::floor(expParam) || std::fabs(expParam) > 9007199254740992.0) {
+        Nan::ThrowRangeError("The exponent must be an integer");
+        return;
+    }
 
-                for (int i=1; i< abs(expParam); i++)
-                {
-                    res *= inputMat;
-                }
-            }
+    MatrixPowerKernel(*(Nan::TypedArrayContents<T>(info[0])), rowsMatrix, (long long)expParam,
+                      *(Nan::TypedArrayContents<T>(info[4])));
+    Local<Boolean> b = Nan::New(true);
+    info.GetReturnValue().Set(b);
+}
 
-            Local<Boolean> b = Nan::New(true);
-            info.GetReturnValue().Set(b);
+void MatrixPower(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[4]->IsFloat32Array()) {
+        MatrixPowerImpl<float>(info);
+    }
+    else {
+        MatrixPowerImpl<double>(info);
+    }
+}
+
+/**
+  *  Expm, Logm, Sqrtm:
+  *  The matrix exponential, principal logarithm and principal square root of a square matrix, computed by
+  *  the Eigen MatrixFunctions module (scaling and squaring with Pade approximants for the exponential,
+  *  Schur based methods for the others).
+  *  Real logm and sqrtm only exist when M has no eigenvalues on the negative real axis (nor zero for logm),
+  *  such matrices are rejected up front as Eigen asserts on them.
+  *
+  *  arguments:
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the square matrix M.
+  *  info[1]: Number represent the number of rows of the matrix.
+  *  info[2]: Number represent the number of columns of the matrix.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for return value, may be info[0] itself.
+*/
+enum MatrixFunctionKind { kMatrixExp, kMatrixLog, kMatrixSqrt };
+
+template <typename T>
+static bool HasRealEigenValueBelow(const MatrixX<T> &matrix, T bound, bool inclusive){
+    Eigen::EigenSolver<MatrixX<T> > eigenSolver(matrix, false);
+    for (Eigen::Index i = 0; i < eigenSolver.eigenvalues().size(); i++) {
+        std::complex<T> value = eigenSolver.eigenvalues()[i];
+        if (value.imag() == 0 && (value.real() < bound || (inclusive && value.real() == bound))) {
+            return true;
         }
-        else{
-            Nan::ThrowTypeError("Wrong arguments2");
-            Local<Boolean> b = Nan::New(false);
-            info.GetReturnValue().Set(b);
+    }
+    return false;
+}
+
+template <typename T>
+static void MatrixFunctionImpl(const Nan::FunctionCallbackInfo<v8::Value>& info, MatrixFunctionKind kind){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    if (info.Length() < 4 || !info[1]->IsUint32() || !info[2]->IsUint32() ||
+        !ScalarArray<T>::Is(info[0]) || !ScalarArray<T>::Is(info[3])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    size_t rowsMatrix(info[1]->Uint32Value());
+    size_t colsMatrix(info[2]->Uint32Value());
+    if (rowsMatrix != colsMatrix) {
+        Nan::ThrowTypeError("Wrong arguments - matrix must be square");
+        return;
+    }
+
+    // the matrix functions read the input after writing the result, so work on a copy
+    MatrixX<T> input = CMd(*(Nan::TypedArrayContents<T>(info[0])), rowsMatrix, colsMatrix);
+    MatrixX<T> result;
+    switch (kind) {
+    case kMatrixExp:
+        result = input.exp();
+        break;
+    case kMatrixLog:
+        if (HasRealEigenValueBelow<T>(input, 0, true)) {
+            Nan::ThrowError("Matrix has no real logarithm, it has an eigenvalue on the non positive real axis");
+            return;
+        }
+        result = input.log();
+        break;
+    case kMatrixSqrt:
+        if (HasRealEigenValueBelow<T>(input, 0, false)) {
+            Nan::ThrowError("Matrix has no real square root, it has an eigenvalue on the negative real axis");
+            return;
         }
+        result = input.sqrt();
+        break;
     }
-    else{
-        Nan::ThrowTypeError("Wrong arguments3");
-        Local<Boolean> b = Nan::New(false);
-        info.GetReturnValue().Set(b);
+
+    if (!result.allFinite()) {
+        Nan::ThrowError("The matrix function did not produce a finite result");
+        return;
+    }
+
+    Md(*(Nan::TypedArrayContents<T>(info[3])), rowsMatrix, colsMatrix) = result;
+    Local<Boolean> b = Nan::New(true);
+    info.GetReturnValue().Set(b);
+}
+
+static void MatrixFunction(const Nan::FunctionCallbackInfo<v8::Value>& info, MatrixFunctionKind kind){
+    if (info[3]->IsFloat32Array()) {
+        MatrixFunctionImpl<float>(info, kind);
     }
+    else {
+        MatrixFunctionImpl<double>(info, kind);
+    }
+}
+
+NAN_METHOD(Expm){
+    MatrixFunction(info, kMatrixExp);
+}
+
+NAN_METHOD(Logm){
+    MatrixFunction(info, kMatrixLog);
+}
+
+NAN_METHOD(Sqrtm){
+    MatrixFunction(info, kMatrixSqrt);
 }
 
 /**
@@ -683,15 +1168,43 @@ void MatrixPower(const Nan::FunctionCallbackInfo<v8::Value>& info){
   *  Given a square matrix a, return the matrix ainv satisfying dot(a, ainv) = dot(ainv, a)
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be inverted.
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be inverted.
   *           Must be square, i.e. M.rows == M.cols.
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
-  *  info[3]: Buffer(object created by Float64Array) for return value, inverse of the given matrix.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for return value, inverse of the given matrix.
+  *           Can be the info[0] buffer to compute the result in place.
 */
-void Inverse(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <int N>
+struct InverseKernelN {
+    template <typename T>
+    static bool run(size_t n, const T *refMatrixData, T *refResData){
+        using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+        using Md = Eigen::Map <Eigen::Matrix<T, N, N> >;
+
+        CMd inputMat(refMatrixData, n, n);
+        Md res(refResData, n, n);
+
+        if (Overlaps(refResData, n * n, refMatrixData, n * n)) {
+            Eigen::Matrix<T, N, N> inverse = inputMat.inverse();
+            res = inverse;
+        }
+        else {
+            res = inputMat.inverse();
+        }
+        return true;
+    }
+};
+
+template <typename T>
+static bool InverseKernel(const T *refMatrixData, size_t rowsMatrix, size_t colsMatrix, T *refResData){
+    return DispatchFixedSize<InverseKernelN>(rowsMatrix, refMatrixData, refResData);
+}
+
+template <typename T>
+static void InverseImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 4) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -703,17 +1216,14 @@ void Inverse(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
+	if (ScalarArray<T>::Is(info[0])) {
+		T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
         size_t rowsMatrix(info[1]->Uint32Value());
         size_t colsMatrix(info[2]->Uint32Value());
 
-        Md inputMat(refMatrixData, rowsMatrix, colsMatrix);
-
-		if (info[3]->IsFloat64Array()) {
-			double *refResData = *(Nan::TypedArrayContents<double>(info[3]));
-            Md res(refResData, rowsMatrix, colsMatrix);
-            res = inputMat.inverse();
+		if (ScalarArray<T>::Is(info[3])) {
+			T *refResData = *(Nan::TypedArrayContents<T>(info[3]));
+            InverseKernel(refMatrixData, rowsMatrix, colsMatrix, refResData);
             Local<Boolean> b = Nan::New(true);
             info.GetReturnValue().Set(b);
         }
@@ -730,21 +1240,31 @@ void Inverse(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
+void Inverse(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[3]->IsFloat32Array()) {
+        InverseImpl<float>(info);
+    }
+    else {
+        InverseImpl<double>(info);
+    }
+}
+
 
 /**
   *  Trace:
   *  Computes The sum along the diagonals of an array
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be inverted.
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be inverted.
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
   *
   *  Return value: a Number represent the trace (diagonal sum) of the given matrix.
 */
-void Trace(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <typename T>
+static void TraceImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 3) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -756,8 +1276,8 @@ void Trace(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
+	if (ScalarArray<T>::Is(info[0])) {
+		T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
         size_t rowsMatrix(info[1]->Uint32Value());
         size_t colsMatrix(info[2]->Uint32Value());
 
@@ -772,22 +1292,43 @@ void Trace(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
+void Trace(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[0]->IsFloat32Array()) {
+        TraceImpl<float>(info);
+    }
+    else {
+        TraceImpl<double>(info);
+    }
+}
+
 
 /**
   *  Det:
   *  Compute the determinant of an array.
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be inverted.
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be inverted.
   *           Must be square, i.e. M.rows == M.cols.
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
   *
   *  Return value: a Number represent the determinant of the given matrix.
 */
-void Det(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+template <int N>
+struct DetKernelN {
+    template <typename T>
+    static T run(size_t n, const T *refMatrixData){
+        using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+
+        CMd inputMat(refMatrixData, n, n);
+        return inputMat.determinant();
+    }
+};
+
+template <typename T>
+static void DetImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 3) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -799,13 +1340,12 @@ void Det(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
+	if (ScalarArray<T>::Is(info[0])) {
+		T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
         size_t rowsMatrix(info[1]->Uint32Value());
         size_t colsMatrix(info[2]->Uint32Value());
 
-        Md inputMat(refMatrixData, rowsMatrix, colsMatrix);
-        v8::Local<v8::Number> num = Nan::New(inputMat.determinant());
+        v8::Local<v8::Number> num = Nan::New(DispatchFixedSize<DetKernelN>(rowsMatrix, refMatrixData));
         info.GetReturnValue().Set(num);
     }
     else{
@@ -815,13 +1355,22 @@ void Det(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
+void Det(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[0]->IsFloat32Array()) {
+        DetImpl<float>(info);
+    }
+    else {
+        DetImpl<double>(info);
+    }
+}
+
 /**
   *  SVD:
   *  Singular Value Decomposition.
   *  Factors the matrix a as u * np.diag(s) * v, where u and v are unitary and s is a 1-d array of as singular values.
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be inverted.
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be inverted.
   *           Must be square, i.e. M.rows == M.cols.
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
@@ -833,74 +1382,109 @@ void Det(const Nan::FunctionCallbackInfo<v8::Value>& info){
   *  info[6]: outS - The singular values for every matrix, sorted in descending order.
   *  info[7]: outV - Unitary matrices. The actual shape depends on the value of full_matrices.
   *                  Only returned when compute_uv is True.
+  *  info[8]: algorithm (Number, optional): 0 (default) picks Eigen::BDCSVD (divide and conquer) for matrices with
+  *           more than kBDCSVDThreshold rows and columns and Eigen::JacobiSVD (slower but more accurate for
+  *           small singular values) otherwise, 1 forces JacobiSVD and 2 forces BDCSVD.
 */
-void SVD(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+enum SVDAlgorithm { kSVDAuto = 0, kSVDJacobi = 1, kSVDBDC = 2 };
 
-    if (info.Length() < 8) {
-        Nan::ThrowTypeError("Wrong number of arguments");
-        return;
-    }
-
-    if (!info[1]->IsNumber() || !info[2]->IsNumber()) {
-        Nan::ThrowTypeError("Wrong arguments");
-        return;
-    }
+// JacobiSVD is O(n^3) with a large constant, divide and conquer overtakes it well before a hundred columns
+static const int kBDCSVDThreshold = 64;
 
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
-        int rowsMatrix(info[1]->Uint32Value());
-        int colsMatrix(info[2]->Uint32Value());
+static bool UseBDCSVD(int rowsMatrix, int colsMatrix, int algorithm){
+    return algorithm == kSVDBDC || (algorithm == kSVDAuto && std::min(rowsMatrix, colsMatrix) > kBDCSVDThreshold);
+}
 
-        Md inputMat(refMatrixData, rowsMatrix, colsMatrix);
+template <typename SVDType, typename T>
+static void SVDKernelWith(const T *refMatrixData, int rowsMatrix, int colsMatrix, bool isFullMatrices, bool isComputeUV,
+                          T *refResU, T *refResS, T *refResV){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
-        bool isFullMatrices = info[3]->BooleanValue();
-        bool isComputeUV = info[4]->BooleanValue();
-        int k = min(rowsMatrix,colsMatrix);
+    CMd inputMat(refMatrixData, rowsMatrix, colsMatrix);
+    int k = std::min(rowsMatrix, colsMatrix);
 
-        if(isComputeUV){
-            if (info[5]->IsFloat64Array() && info[6]->IsFloat64Array() && info[7]->IsFloat64Array()) {
+    if(isComputeUV){
+        if(isFullMatrices){
+            SVDType svd(inputMat, Eigen::ComputeFullU | Eigen::ComputeFullV);
 
-                double *refResU = *(Nan::TypedArrayContents<double>(info[5]));
-                double *refResS = *(Nan::TypedArrayContents<double>(info[6]));
-                double *refResV = *(Nan::TypedArrayContents<double>(info[7]));
+            Md resU(refResU, rowsMatrix, rowsMatrix);
+            Md resV(refResV, colsMatrix, colsMatrix);
 
-                if(isFullMatrices){
-                    Eigen::JacobiSVD<Eigen::MatrixXd> svd(inputMat, Eigen::ComputeFullU | Eigen::ComputeFullV);
+            resU = svd.matrixU();
+            resV = svd.matrixV();
 
-                    Md resU(refResU, rowsMatrix, rowsMatrix);
-                    Md resV(refResV, colsMatrix, colsMatrix);
+            std::memcpy(refResS, svd.singularValues().data(), k * sizeof(T));
+        }
+        else{
+            SVDType svd(inputMat, Eigen::ComputeThinU | Eigen::ComputeThinV);
 
-                    resU = svd.matrixU();
-                    resV = svd.matrixV();
+            Md resU(refResU, rowsMatrix, k);
+            Md resV(refResV, k, colsMatrix);
 
-                    std::memcpy(refResS, svd.singularValues().data(), k * sizeof(double));
+            resU = svd.matrixU();
+            resV = svd.matrixV();
 
-                    Local<Boolean> b = Nan::New(true);
-                    info.GetReturnValue().Set(b);
-                }
-                else{
-                    Eigen::JacobiSVD<Eigen::MatrixXd> svd(inputMat, Eigen::ComputeThinU | Eigen::ComputeThinV);
+            std::memcpy(refResS, svd.singularValues().data(), k * sizeof(T));
+        }
+    }
+    else{
+        SVDType svd(inputMat);
+        std::memcpy(refResS, svd.singularValues().data(), k * sizeof(T));
+    }
+}
+
+template <typename T>
+static bool SVDKernel(const T *refMatrixData, int rowsMatrix, int colsMatrix, bool isFullMatrices, bool isComputeUV,
+                      T *refResU, T *refResS, T *refResV, int algorithm = kSVDAuto){
+    if (UseBDCSVD(rowsMatrix, colsMatrix, algorithm)) {
+        SVDKernelWith<Eigen::BDCSVD<MatrixX<T> > >(refMatrixData, rowsMatrix, colsMatrix, isFullMatrices, isComputeUV,
+                                                   refResU, refResS, refResV);
+    }
+    else {
+        SVDKernelWith<Eigen::JacobiSVD<MatrixX<T> > >(refMatrixData, rowsMatrix, colsMatrix, isFullMatrices, isComputeUV,
+                                                      refResU, refResS, refResV);
+    }
+    return true;
+}
+
+template <typename T>
+static void SVDImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info.Length() < 8) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[1]->IsNumber() || !info[2]->IsNumber()) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
 
-                    Md resU(refResU, rowsMatrix, k);
-                    Md resV(refResV, k, colsMatrix);
+	if (ScalarArray<T>::Is(info[0])) {
+		T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
+        int rowsMatrix(info[1]->Uint32Value());
+        int colsMatrix(info[2]->Uint32Value());
 
-                    resU = svd.matrixU();
-                    resV = svd.matrixV();
+        bool isFullMatrices = info[3]->BooleanValue();
+        bool isComputeUV = info[4]->BooleanValue();
+        int algorithm = info.Length() > 8 && info[8]->IsUint32() ? info[8]->Uint32Value() : kSVDAuto;
 
-                    std::memcpy(refResS, svd.singularValues().data(), k * sizeof(double));
+        if(isComputeUV){
+            if (ScalarArray<T>::Is(info[5]) && ScalarArray<T>::Is(info[6]) && ScalarArray<T>::Is(info[7])) {
 
-                    Local<Boolean> b = Nan::New(true);
-                    info.GetReturnValue().Set(b);
-                }
+                T *refResU = *(Nan::TypedArrayContents<T>(info[5]));
+                T *refResS = *(Nan::TypedArrayContents<T>(info[6]));
+                T *refResV = *(Nan::TypedArrayContents<T>(info[7]));
+
+                SVDKernel<T>(refMatrixData, rowsMatrix, colsMatrix, isFullMatrices, true, refResU, refResS, refResV, algorithm);
+                Local<Boolean> b = Nan::New(true);
+                info.GetReturnValue().Set(b);
             }
         }
         else{
-            if(info[6]->IsFloat64Array()){
-                double *refResS = *(Nan::TypedArrayContents<double>(info[6]));
-                Eigen::JacobiSVD<Eigen::MatrixXd> svd(inputMat);
-                std::memcpy(refResS, svd.singularValues().data(), k * sizeof(double));
+            if(ScalarArray<T>::Is(info[6])){
+                T *refResS = *(Nan::TypedArrayContents<T>(info[6]));
+                SVDKernel<T>(refMatrixData, rowsMatrix, colsMatrix, isFullMatrices, false, nullptr, refResS, nullptr, algorithm);
 
                 Local<Boolean> b = Nan::New(true);
                 info.GetReturnValue().Set(b);
@@ -914,25 +1498,69 @@ void SVD(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
+void SVD(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[6]->IsFloat32Array()) {
+        SVDImpl<float>(info);
+    }
+    else {
+        SVDImpl<double>(info);
+    }
+}
+
 /**
   *  Rank:
-  *  Return matrix rank of array using SVD method
+  *  Return matrix rank of array using SVD method, or a rank revealing decomposition (info[4])
   *  Rank of the array is the number of SVD singular values of the array that are greater than threshold(info[3]).
   *
   *  arguments:
-  *  info[0]: Buffer(object created by Float64Array) represent the numjs.Matrix object to be inverted.
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to be inverted.
   *           Must be square, i.e. M.rows == M.cols.
   *  info[1]: Number represent the number of rows of the matrix.
   *  info[2]: Number represent the number of columns of the matrix.
   *  info[3]: Optional - Number represent the threshold which SVD values are considered zero.
   *                     If this arg is not given, and S is an array with singular values for M,
   *                     and eps is the epsilon value for datatype of S, then tol is set to S.max() * max(M.shape) * eps
+  *  info[4]: Optional - Number represent the method: 0 (default) SVD, 1 ColPivHouseholderQR, 2 FullPivLU.
+  *           The decompositions count the pivots above the threshold instead of the singular values, both
+  *           are several times faster than an SVD and reliable for all but nearly rank deficient matrices.
+  *           The threshold is relative to the largest singular value (pivot) for all three, and only the values
+  *           strictly above it count.
   *
   *  Return value: a Number represent the matrix rank of the given matrix .
 */
-void Rank(const Nan::FunctionCallbackInfo<v8::Value>& info){
-    using CMd = Eigen::Map <const Eigen::MatrixXd >;
-    using Md = Eigen::Map <Eigen::MatrixXd >;
+enum RankMethod { kRankSVD = 0, kRankQR = 1, kRankLU = 2 };
+
+// the rank by the default threshold of the decomposition, or by the given one when it is positive,
+// the threshold has to be set before FullPivLU and ColPivHouseholderQR are computed
+template <typename Decomposition, typename Input>
+static int DecompositionRank(const Input &matrix, typename Decomposition::RealScalar threshold){
+    Decomposition decomposition(matrix.rows(), matrix.cols());
+    if (threshold > 0) {
+        decomposition.setThreshold(threshold);
+    }
+    decomposition.compute(matrix);
+    return (int)decomposition.rank();
+}
+
+// the SVDs keep the singular values equal to the threshold, count the ones strictly above it like the pivots
+template <typename SVDType, typename Input>
+static int SVDRank(const Input &matrix, typename SVDType::RealScalar threshold){
+    SVDType svd(matrix);
+    if (threshold <= 0) {
+        return (int)svd.rank();
+    }
+
+    int rank = 0;
+    for (Eigen::Index i = 0; i < svd.singularValues().size(); i++) {
+        rank += svd.singularValues()[i] > threshold * svd.singularValues()[0];
+    }
+    return rank;
+}
+
+template <typename T>
+static void RankImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
 
     if (info.Length() < 3) {
         Nan::ThrowTypeError("Wrong number of arguments");
@@ -944,18 +1572,30 @@ void Rank(const Nan::FunctionCallbackInfo<v8::Value>& info){
         return;
     }
 
-	if (info[0]->IsFloat64Array()) {
-		double *refMatrixData = *(Nan::TypedArrayContents<double>(info[0]));
+	if (ScalarArray<T>::Is(info[0])) {
+		T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
         size_t rowsMatrix(info[1]->Uint32Value());
         size_t colsMatrix(info[2]->Uint32Value());
 
+        // the SVD computes the singular values only, by the same engine selection as SVD
         Md inputMat(refMatrixData, rowsMatrix, colsMatrix);
-        Eigen::JacobiSVD<Eigen::MatrixXd> svd(inputMat);
-        if (info.Length() == 4 && info[3]->IsNumber()){
-            svd.setThreshold((float)info[3]->NumberValue());
+        T threshold = info.Length() > 3 && info[3]->IsNumber() ? (T)info[3]->NumberValue() : T(0);
+        int method = info.Length() > 4 && info[4]->IsUint32() ? info[4]->Uint32Value() : kRankSVD;
+        int rank;
+        if (method == kRankQR) {
+            rank = DecompositionRank<Eigen::ColPivHouseholderQR<MatrixX<T> > >(inputMat, threshold);
+        }
+        else if (method == kRankLU) {
+            rank = DecompositionRank<Eigen::FullPivLU<MatrixX<T> > >(inputMat, threshold);
+        }
+        else if (UseBDCSVD(rowsMatrix, colsMatrix, kSVDAuto)) {
+            rank = SVDRank<Eigen::BDCSVD<MatrixX<T> > >(inputMat, threshold);
+        }
+        else {
+            rank = SVDRank<Eigen::JacobiSVD<MatrixX<T> > >(inputMat, threshold);
         }
 
-        v8::Local<v8::Number> num = Nan::New((int)svd.rank());
+        v8::Local<v8::Number> num = Nan::New(rank);
         info.GetReturnValue().Set(num);
     }
     else{
@@ -965,10 +1605,263 @@ void Rank(const Nan::FunctionCallbackInfo<v8::Value>& info){
     }
 }
 
-NAN_METHOD(GetEigenValues){
-	using CMd = Eigen::Map <const Eigen::MatrixXd >;
-	using EMd = Eigen::Map <Eigen::EigenSolver<const Eigen::MatrixXd>::EigenvalueType>;
+void Rank(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info[0]->IsFloat32Array()) {
+        RankImpl<float>(info);
+    }
+    else {
+        RankImpl<double>(info);
+    }
+}
+
+/**
+  *  Lstsq, Pinv:
+  *  Minimum norm least squares solutions and the Moore-Penrose pseudo inverse by
+  *  Eigen::CompleteOrthogonalDecomposition, a column pivoting QR followed by an RZ step which handles non
+  *  square and rank deficient matrices at a fraction of the cost of an SVD.
+  *
+  *  arguments (Lstsq):
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the M x N matrix A.
+  *  info[1]: Number represent M.
+  *  info[2]: Number represent N.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) represent the M x K right hand sides B.
+  *  info[4]: Number represent K.
+  *  info[5]: Buffer(object created by Float64Array or Float32Array) for the N x K return value X minimizing
+  *           |A * X - B|, of least norm when A is rank deficient. May be B itself when M == N.
+  *  info[6]: Optional - Number represent the threshold below which pivots (relative to the largest) are zero.
+  *
+  *  Return value (Lstsq): a Number represent the rank of A.
+  *
+  *  arguments (Pinv):
+  *  info[0] - info[2]: A, M and N as for Lstsq.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for the N x M return value, may be info[0]
+  *           itself when M == N.
+  *  info[4]: Optional - Number represent the threshold, as for Lstsq.
+*/
+template <typename T>
+static void ComputeCompleteOrthogonal(Eigen::CompleteOrthogonalDecomposition<MatrixX<T> > &cod,
+                                      const T *refMatrixData, size_t rows, size_t cols,
+                                      const Nan::FunctionCallbackInfo<v8::Value>& info, int thresholdIndex){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+
+    if (info.Length() > thresholdIndex && info[thresholdIndex]->IsNumber() && info[thresholdIndex]->NumberValue() > 0) {
+        cod.setThreshold((T)info[thresholdIndex]->NumberValue());
+    }
+    cod.compute(CMd(refMatrixData, rows, cols));
+}
+
+template <typename T>
+static void LstsqImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    if (info.Length() < 6 || !ScalarArray<T>::Is(info[0]) || !info[1]->IsUint32() || !info[2]->IsUint32() ||
+        !ScalarArray<T>::Is(info[3]) || !info[4]->IsUint32() || !ScalarArray<T>::Is(info[5])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    size_t rows(info[1]->Uint32Value());
+    size_t cols(info[2]->Uint32Value());
+    size_t nrhs(info[4]->Uint32Value());
+    Nan::TypedArrayContents<T> dataA(info[0]);
+    Nan::TypedArrayContents<T> dataB(info[3]);
+    Nan::TypedArrayContents<T> resX(info[5]);
+    if (dataA.length() < rows * cols || dataB.length() < rows * nrhs || resX.length() < cols * nrhs) {
+        Nan::ThrowTypeError("Wrong arguments - the buffers must hold A (M x N), B (M x K) and X (N x K)");
+        return;
+    }
+
+    Eigen::CompleteOrthogonalDecomposition<MatrixX<T> > cod(rows, cols);
+    ComputeCompleteOrthogonal(cod, *dataA, rows, cols, info, 6);
+
+    // the solve reads B after it started writing X, solving in place needs a temporary
+    CMd b(*dataB, rows, nrhs);
+    Md x(*resX, cols, nrhs);
+    if (Overlaps((const T *)*resX, cols * nrhs, (const T *)*dataB, rows * nrhs)) {
+        x = MatrixX<T>(cod.solve(b));
+    }
+    else {
+        x = cod.solve(b);
+    }
+
+    v8::Local<v8::Number> num = Nan::New((int)cod.rank());
+    info.GetReturnValue().Set(num);
+}
+
+NAN_METHOD(Lstsq){
+    if (info[0]->IsFloat32Array()) {
+        LstsqImpl<float>(info);
+    }
+    else {
+        LstsqImpl<double>(info);
+    }
+}
+
+template <typename T>
+static void PinvImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    if (info.Length() < 4 || !ScalarArray<T>::Is(info[0]) || !info[1]->IsUint32() || !info[2]->IsUint32() ||
+        !ScalarArray<T>::Is(info[3])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    size_t rows(info[1]->Uint32Value());
+    size_t cols(info[2]->Uint32Value());
+    Nan::TypedArrayContents<T> dataA(info[0]);
+    Nan::TypedArrayContents<T> res(info[3]);
+    if (dataA.length() < rows * cols || res.length() < rows * cols) {
+        Nan::ThrowTypeError("Wrong arguments - the buffers must hold M x N elements");
+        return;
+    }
+
+    // the decomposition keeps its own copy of A, so the result may overwrite it
+    Eigen::CompleteOrthogonalDecomposition<MatrixX<T> > cod(rows, cols);
+    ComputeCompleteOrthogonal(cod, *dataA, rows, cols, info, 4);
+    Md(*res, cols, rows) = cod.pseudoInverse();
+
+    Local<Boolean> b = Nan::New(true);
+    info.GetReturnValue().Set(b);
+}
+
+NAN_METHOD(Pinv){
+    if (info[0]->IsFloat32Array()) {
+        PinvImpl<float>(info);
+    }
+    else {
+        PinvImpl<double>(info);
+    }
+}
+
+/**
+  *  SVDK:
+  *  Randomized truncated SVD (Halko, Martinsson and Tropp): the k leading singular triplets of M from the
+  *  SVD of the small (k + oversample) x N projection of M onto an orthonormal basis of its range, sampled
+  *  as M * Omega for a Gaussian Omega and sharpened by power iterations. For a tall-skinny M it costs a few
+  *  passes of M * (N x (k + oversample)) products instead of a full SVD.
+  *
+  *  arguments:
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the M x N matrix.
+  *  info[1]: Number represent the number of rows of the matrix.
+  *  info[2]: Number represent the number of columns of the matrix.
+  *  info[3]: Number represent k, 0 < k <= min(M, N).
+  *  info[4]: Number represent the oversampling, the range is sampled with min(k + oversample, M, N) vectors.
+  *  info[5]: Number represent the number of power iterations, each one reorthogonalized, 1 or 2 are enough
+  *           unless the singular values decay slowly.
+  *  info[6]: outU - Buffer for the M x k matrix of the left singular vectors.
+  *  info[7]: outS - Buffer for the k singular values, in descending order.
+  *  info[8]: outV - Buffer for the N x k matrix of the right singular vectors, M ~ U * diag(S) * V'.
+*/
+// an orthonormal basis of the range of the columns of matrix, in place
+template <typename T>
+static void Orthonormalize(MatrixX<T> &matrix){
+    Eigen::HouseholderQR<MatrixX<T> > qr(matrix);
+    matrix = qr.householderQ() * MatrixX<T>::Identity(matrix.rows(), matrix.cols());
+}
+
+template <typename T>
+static bool SVDKKernel(const T *refMatrixData, size_t rowsMatrix, size_t colsMatrix, size_t k, size_t oversample,
+                       size_t powerIters, T *refResU, T *refResS, T *refResV){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+    using MVd = Eigen::Map <VectorX<T> >;
+
+    CMd inputMat(refMatrixData, rowsMatrix, colsMatrix);
+    // k <= min(M, N), so clamping the oversampling first keeps k + oversample from overflowing
+    size_t samples = k + std::min(oversample, std::min(rowsMatrix, colsMatrix) - k);
+
+    // a fixed seed keeps the results reproducible from run to run
+    std::mt19937 random(42);
+    std::normal_distribution<double> gaussian;
+    MatrixX<T> omega(colsMatrix, samples);
+    for (Eigen::Index i = 0; i < omega.size(); i++) {
+        omega.data()[i] = (T)gaussian(random);
+    }
+
+    MatrixX<T> range(rowsMatrix, samples);
+    range.noalias() = inputMat * omega;
+    Orthonormalize(range);
+
+    MatrixX<T> coRange(colsMatrix, samples);
+    for (size_t i = 0; i < powerIters; i++) {
+        coRange.noalias() = inputMat.transpose() * range;
+        Orthonormalize(coRange);
+        range.noalias() = inputMat * coRange;
+        Orthonormalize(range);
+    }
+
+    MatrixX<T> projected(samples, colsMatrix);
+    projected.noalias() = range.transpose() * inputMat;
+    Eigen::JacobiSVD<MatrixX<T> > svd(projected, Eigen::ComputeThinU | Eigen::ComputeThinV);
+
+    Md(refResU, rowsMatrix, k).noalias() = range * svd.matrixU().leftCols(k);
+    MVd(refResS, k) = svd.singularValues().head(k);
+    Md(refResV, colsMatrix, k) = svd.matrixV().leftCols(k);
+    return true;
+}
+
+template <typename T>
+static void SVDKImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info.Length() < 9 || !ScalarArray<T>::Is(info[0]) || !info[1]->IsUint32() || !info[2]->IsUint32() ||
+        !info[3]->IsUint32() || !info[4]->IsUint32() || !info[5]->IsUint32() ||
+        !ScalarArray<T>::Is(info[6]) || !ScalarArray<T>::Is(info[7]) || !ScalarArray<T>::Is(info[8])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    size_t rowsMatrix(info[1]->Uint32Value());
+    size_t colsMatrix(info[2]->Uint32Value());
+    size_t k(info[3]->Uint32Value());
+    if (k == 0 || k > std::min(rowsMatrix, colsMatrix)) {
+        Nan::ThrowRangeError("k must satisfy 0 < k <= min(M.rows, M.cols)");
+        return;
+    }
+
+    if (Nan::TypedArrayContents<T>(info[0]).length() / colsMatrix < rowsMatrix) {
+        Nan::ThrowTypeError("Wrong arguments - the matrix buffer is smaller than M.rows * M.cols");
+        return;
+    }
+
+    Nan::TypedArrayContents<T> resU(info[6]);
+    Nan::TypedArrayContents<T> resS(info[7]);
+    Nan::TypedArrayContents<T> resV(info[8]);
+    if (resU.length() != rowsMatrix * k || resS.length() != k || resV.length() != colsMatrix * k) {
+        Nan::ThrowTypeError("Wrong arguments - the result buffers must hold M x k, k and N x k elements");
+        return;
+    }
+
+    SVDKKernel(*(Nan::TypedArrayContents<T>(info[0])), rowsMatrix, colsMatrix, k, info[4]->Uint32Value(),
+               info[5]->Uint32Value(), *resU, *resS, *resV);
+    Local<Boolean> b = Nan::New(true);
+    info.GetReturnValue().Set(b);
+}
+
+NAN_METHOD(SVDK){
+    if (info[0]->IsFloat32Array()) {
+        SVDKImpl<float>(info);
+    }
+    else {
+        SVDKImpl<double>(info);
+    }
+}
+
+template <typename T>
+static bool GetEigenValuesKernel(const T *data1, size_t rows1, size_t cols1, T *resRawData){
+	using CMd = Eigen::Map <const MatrixX<T> >;
+	using EMd = Eigen::Map <typename Eigen::EigenSolver<MatrixX<T> >::EigenvalueType>;
+
+	CMd first(data1, rows1, cols1);
+	EMd eigenResults(reinterpret_cast<std::complex<T>*>(resRawData)/*very ugly but well defined afaik */, rows1, 1);
+	Eigen::EigenSolver<MatrixX<T>> eigenSolver(first, false);
 
+	eigenResults = eigenSolver.eigenvalues();
+	return eigenSolver.info() == Eigen::Success;
+}
+
+template <typename T>
+static NAN_METHOD(GetEigenValuesImpl){
 	if (info.Length() != 4) {
 		Nan::ThrowTypeError("Wrong number of arguments");
 		return;
@@ -981,34 +1874,227 @@ NAN_METHOD(GetEigenValues){
 	size_t rows1(info[0]->Uint32Value());
 	size_t cols1(info[1]->Uint32Value());
 
-	double *data1 = nullptr;
-	double *resRawData = nullptr;
+	T *data1 = nullptr;
+	T *resRawData = nullptr;
 
-	if (info[2]->IsFloat64Array() && info[3]->IsFloat64Array()) {
-		data1 = *(Nan::TypedArrayContents<double>(info[2]));
-		resRawData = *(Nan::TypedArrayContents<double>(info[3]));
+	if (ScalarArray<T>::Is(info[2]) && ScalarArray<T>::Is(info[3])) {
+		data1 = *(Nan::TypedArrayContents<T>(info[2]));
+		resRawData = *(Nan::TypedArrayContents<T>(info[3]));
 	}
 	else{
 		Nan::ThrowTypeError("Wrong arguments");
 		return;
 	}
 
-	CMd first(data1, rows1, cols1);
-	EMd eigenResults(reinterpret_cast<std::complex<double>*>(resRawData)/*very ugly but well defined afaik */, rows1, 1);
-	Eigen::EigenSolver<Eigen::MatrixXd> eigenSolver(first, false);
-
-	eigenResults = eigenSolver.eigenvalues();
+	GetEigenValuesKernel(data1, rows1, cols1, resRawData);
 	Local<Boolean> b = Nan::New(true);
 	info.GetReturnValue().Set(b);
 }
 
+NAN_METHOD(GetEigenValues){
+	if (info[3]->IsFloat32Array()) {
+		GetEigenValuesImpl<float>(info);
+	}
+	else {
+		GetEigenValuesImpl<double>(info);
+	}
+}
+
+/**
+  *  Eigh:
+  *  Eigenvalues and optionally eigenvectors of a symmetric matrix by Eigen::SelfAdjointEigenSolver, which is
+  *  real valued and much faster than the general solver. Only the lower triangle of the matrix is read.
+  *
+  *  arguments:
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the symmetric n x n matrix.
+  *  info[1]: Number represent n.
+  *  info[2]: Boolean - whether to compute the eigenvectors.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for the n eigenvalues, in increasing order.
+  *  info[4]: Buffer(object created by Float64Array or Float32Array) for the n x n matrix whose column i is the
+  *           unit eigenvector of eigenvalue i, only read when info[2] is true.
+*/
+template <typename T>
+static bool EighKernel(const T *refMatrixData, size_t n, bool isComputeVectors, T *refResValues, T *refResVectors){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+    using MVd = Eigen::Map <VectorX<T> >;
+
+    Eigen::SelfAdjointEigenSolver<MatrixX<T> > eigenSolver(CMd(refMatrixData, n, n),
+        isComputeVectors ? Eigen::ComputeEigenvectors : Eigen::EigenvaluesOnly);
+    if (eigenSolver.info() != Eigen::Success) {
+        return false;
+    }
+
+    MVd(refResValues, n) = eigenSolver.eigenvalues();
+    if (isComputeVectors) {
+        Md(refResVectors, n, n) = eigenSolver.eigenvectors();
+    }
+    return true;
+}
 
-NAN_METHOD(SolveLinearSystemHouseholderQr){
-	using CMd = Eigen::Map <const Eigen::MatrixXd >;
-	using Md = Eigen::Map <Eigen::MatrixXd >;
-	using MVd = Eigen::Map < Eigen::VectorXd >;
+template <typename T>
+static void EighImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info.Length() < 4 || !ScalarArray<T>::Is(info[0]) || !info[1]->IsUint32() || !ScalarArray<T>::Is(info[3])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
 
-	if (info.Length() != 5) {
+    size_t n(info[1]->Uint32Value());
+    bool isComputeVectors = info[2]->BooleanValue();
+    if (isComputeVectors && (info.Length() < 5 || !ScalarArray<T>::Is(info[4]))) {
+        Nan::ThrowTypeError("Wrong arguments - expected a buffer for the eigenvectors");
+        return;
+    }
+
+    bool success = EighKernel(*(Nan::TypedArrayContents<T>(info[0])), n, isComputeVectors,
+                              *(Nan::TypedArrayContents<T>(info[3])),
+                              isComputeVectors ? *(Nan::TypedArrayContents<T>(info[4])) : nullptr);
+    if (!success) {
+        Nan::ThrowError("The eigenvalue decomposition did not converge");
+        return;
+    }
+
+    Local<Boolean> b = Nan::New(true);
+    info.GetReturnValue().Set(b);
+}
+
+NAN_METHOD(Eigh){
+    if (info[0]->IsFloat32Array()) {
+        EighImpl<float>(info);
+    }
+    else {
+        EighImpl<double>(info);
+    }
+}
+
+/**
+  *  Eig:
+  *  Eigenvalues and eigenvectors of a general square matrix by Eigen::EigenSolver (GetEigenValues without
+  *  the eigenvectors). Both are complex, stored as (real, imaginary) pairs.
+  *
+  *  arguments:
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the n x n matrix.
+  *  info[1]: Number represent n.
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) for the 2 * n eigenvalue pairs.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for the 2 * n * n eigenvector pairs, column i
+  *           (n pairs, column-major) is the unit eigenvector of eigenvalue i.
+*/
+template <typename T>
+static bool EigKernel(const T *refMatrixData, size_t n, T *refResValues, T *refResVectors){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using EigenSolver = Eigen::EigenSolver<MatrixX<T> >;
+
+    EigenSolver eigenSolver(CMd(refMatrixData, n, n), true);
+    if (eigenSolver.info() != Eigen::Success) {
+        return false;
+    }
+
+    Eigen::Map <typename EigenSolver::EigenvalueType>(reinterpret_cast<std::complex<T>*>(refResValues), n) =
+        eigenSolver.eigenvalues();
+    Eigen::Map <typename EigenSolver::EigenvectorsType>(reinterpret_cast<std::complex<T>*>(refResVectors), n, n) =
+        eigenSolver.eigenvectors();
+    return true;
+}
+
+template <typename T>
+static void EigImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info.Length() < 4 || !ScalarArray<T>::Is(info[0]) || !info[1]->IsUint32() ||
+        !ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[3])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    size_t n(info[1]->Uint32Value());
+    if (!EigKernel(*(Nan::TypedArrayContents<T>(info[0])), n, *(Nan::TypedArrayContents<T>(info[2])),
+                   *(Nan::TypedArrayContents<T>(info[3])))) {
+        Nan::ThrowError("The eigenvalue decomposition did not converge");
+        return;
+    }
+
+    Local<Boolean> b = Nan::New(true);
+    info.GetReturnValue().Set(b);
+}
+
+NAN_METHOD(Eig){
+    if (info[0]->IsFloat32Array()) {
+        EigImpl<float>(info);
+    }
+    else {
+        EigImpl<double>(info);
+    }
+}
+
+
+/**
+  *  SolveLinearSystemHouseholderQr:
+  *  Solves A * X = B by one Householder QR of A for all the columns of B, so the triangular solves run as
+  *  blocked matrix kernels instead of one factorization and one vector solve per column. A can be non square,
+  *  X is then the least squares solution.
+  *
+  *  arguments:
+  *  info[0]: Number represent the number of rows of A.
+  *  info[1]: Number represent the number of columns of A.
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) represent A.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) represent B, one or more columns of A.rows
+  *           elements stored one after the other (column-major).
+  *  info[4]: Buffer(object created by Float64Array or Float32Array) for return value X, A.cols elements per
+  *           column of B, may be info[3] itself.
+  *  info[5], info[6]: optional - the ld and transposed of a view A (see ReadView).
+*/
+template <int N>
+struct SolveLinearSystemHouseholderQrKernelN {
+	template <typename T>
+	static bool run(size_t n, size_t nrhs, const T *data1, const T *parameterData, T *resultData){
+		using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+		using CMBd = Eigen::Map <const Eigen::Matrix<T, N, Eigen::Dynamic> >;
+		using MBd = Eigen::Map < Eigen::Matrix<T, N, Eigen::Dynamic> >;
+
+		CMd matrixA(data1, n, n);
+		CMBd parameters(parameterData, n, nrhs);
+		MBd result(resultData, n, nrhs);
+		result = Eigen::HouseholderQR<Eigen::Matrix<T, N, N> >(matrixA).solve(parameters);
+		return true;
+	}
+};
+
+template <typename T>
+static bool SolveLinearSystemHouseholderQrKernel(const T *data1, size_t rows1, size_t cols1, size_t nrhs,
+                                                 const T *parameterData, T *resultData){
+	using CMd = Eigen::Map <const MatrixX<T> >;
+	using Md = Eigen::Map <MatrixX<T> >;
+
+	if (rows1 == cols1) {
+		return DispatchFixedSize<SolveLinearSystemHouseholderQrKernelN>(rows1, nrhs, data1, parameterData, resultData);
+	}
+
+	// the solve copies B before it writes X, so X may be B itself
+	CMd matrixA(data1, rows1, cols1);
+	CMd parameters(parameterData, rows1, nrhs);
+	Md result(resultData, cols1, nrhs);
+	result = matrixA.householderQr().solve(parameters);
+
+	//TODO: maybe support tolerance and get the required precision: double relative_error = (matrixA*result - parameters).norm() / parameters.norm();
+	return true;
+}
+
+// the number of columns of B (info[3]) for the solve, 0 after throwing when B or X (info[4]) do not fit A
+template <typename T>
+static size_t CountSolveColumns(const Nan::FunctionCallbackInfo<v8::Value>& info, size_t rows1, size_t cols1){
+	size_t lengthB = Nan::TypedArrayContents<T>(info[3]).length();
+	size_t lengthX = Nan::TypedArrayContents<T>(info[4]).length();
+	if (rows1 == 0 || lengthB == 0 || lengthB % rows1 != 0 || lengthX < cols1 * (lengthB / rows1)) {
+		Nan::ThrowTypeError("Wrong arguments - B must hold columns of A.rows elements and X A.cols elements per column");
+		return 0;
+	}
+	return lengthB / rows1;
+}
+
+template <typename T>
+static NAN_METHOD(SolveLinearSystemHouseholderQrImpl){
+	using Md = Eigen::Map < MatrixX<T> >;
+	using CMd = Eigen::Map <const MatrixX<T> >;
+
+	if (info.Length() < 5) {
 		Nan::ThrowTypeError("Wrong number of arguments");
 		return;
 	}
@@ -1020,27 +2106,56 @@ NAN_METHOD(SolveLinearSystemHouseholderQr){
 	size_t rows1(info[0]->Uint32Value());
 	size_t cols1(info[1]->Uint32Value());
 
-	double *data1 = nullptr;
+	T *data1 = nullptr;
+
+	if (!ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[3]) || !ScalarArray<T>::Is(info[4])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+		return;
+	}
+	Nan::TypedArrayContents<T> contents1(info[2]);
+	data1 = *contents1;
+	T *parameterData = nullptr;
+	parameterData = *(Nan::TypedArrayContents<T>(info[3]));
+	T *resultData = nullptr;
+	resultData = *(Nan::TypedArrayContents<T>(info[4]));
+
+	size_t nrhs = CountSolveColumns<T>(info, rows1, cols1);
+	if (nrhs == 0) {
+		return;
+	}
 
-	if (!info[2]->IsFloat64Array() || !info[3]->IsFloat64Array() || !info[4]->IsFloat64Array()) {
-		Nan::ThrowTypeError("Wrong arguments - expected Float64Array");
+	StridedView<T> matrixA;
+	if (!ReadView(info, 5, data1, contents1.length(), rows1, cols1, matrixA)) {
 		return;
 	}
-	data1 = *(Nan::TypedArrayContents<double>(info[2]));
-	CMd matrixA(data1, rows1, cols1);	
-	double *parameterData = nullptr;
-	parameterData = *(Nan::TypedArrayContents<double>(info[3]));
-	double *resultVectorData = nullptr;
-	resultVectorData = *(Nan::TypedArrayContents<double>(info[4]));
-	MVd paramVector(parameterData, rows1, 1);
-	MVd resultVector(resultVectorData, rows1, 1);
-	resultVector = matrixA.householderQr().solve(paramVector);
-
-	//TODO: maybe support tolerance and get the required precision: double relative_error = (matrixA*resultVector - paramVector).norm() / paramVector.norm();
+
+	if (matrixA.IsDense()) {
+		SolveLinearSystemHouseholderQrKernel(data1, rows1, cols1, nrhs, parameterData, resultData);
+	}
+	else {
+		// the decomposition copies A, so a view costs no more than a dense matrix
+		Eigen::HouseholderQR<MatrixX<T> > qr(rows1, cols1);
+		if (matrixA.transposed) {
+			qr.compute(matrixA.Stored().transpose());
+		}
+		else {
+			qr.compute(matrixA.Stored());
+		}
+		Md(resultData, cols1, nrhs) = qr.solve(CMd(parameterData, rows1, nrhs));
+	}
 	Local<Boolean> b = Nan::New(true);
 	info.GetReturnValue().Set(b);
 }
 
+NAN_METHOD(SolveLinearSystemHouseholderQr){
+	if (info[4]->IsFloat32Array()) {
+		SolveLinearSystemHouseholderQrImpl<float>(info);
+	}
+	else {
+		SolveLinearSystemHouseholderQrImpl<double>(info);
+	}
+}
+
 /**
   *  Matrix multiplication:
   *  Given compatible matrices A,B returns A*B.
@@ -1050,17 +2165,65 @@ NAN_METHOD(SolveLinearSystemHouseholderQr){
   *  arguments:
   *  info[0]: Number represent the number of rows of the left matrix.
   *  info[1]: Number represent the number of columns of the left matrix.
-  *  info[2]: Buffer(object created by Float64Array) represent the left numjs.Matrix object .
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) represent the left numjs.Matrix object .
   *  info[3]: Number represent the number of rows of the right matrix.
   *  info[4]: Number represent the number of columns of the right matrix.
-  *  info[5]: Buffer(object created by Float64Array) represent the right numjs.Matrix object .
-  *  info[6]: Buffer(object created by Float64Array) for return value, which is the dot product of
+  *  info[5]: Buffer(object created by Float64Array or Float32Array) represent the right numjs.Matrix object .
+  *  info[6]: Buffer(object created by Float64Array or Float32Array) for return value, which is the dot product of
   *           left matrix and right matrix.
+  *  info[7], info[8]: Optional - leading dimension and transposed flag of the left matrix (see StridedView).
+  *  info[9], info[10]: Optional - leading dimension and transposed flag of the right matrix.
 */
-NAN_METHOD(MatMul){
-	using CMd = Eigen::Map <const Eigen::MatrixXd >;
-	using Md = Eigen::Map <Eigen::MatrixXd >;
+template <int N>
+struct SquareMatMulKernelN {
+	template <typename T>
+	static bool run(size_t n, const T *data1, const T *data2, size_t cols2, T *resRawData){
+		using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+		using CMRd = Eigen::Map <const Eigen::Matrix<T, N, Eigen::Dynamic> >;
+		using MRd = Eigen::Map <Eigen::Matrix<T, N, Eigen::Dynamic> >;
+
+		CMd first(data1, n, n);
+		if (cols2 == n) {
+			Eigen::Map <Eigen::Matrix<T, N, N> > res(resRawData, n, n);
+			res.noalias() = first * Eigen::Map <const Eigen::Matrix<T, N, N> >(data2, n, n);
+		}
+		else {
+			MRd res(resRawData, n, cols2);
+			res.noalias() = first * CMRd(data2, n, cols2);
+		}
+		return true;
+	}
+};
+
+template <typename T>
+static bool MatMulKernel(const T *data1, size_t rows1, size_t cols1,
+                         const T *data2, size_t rows2, size_t cols2, T *resRawData){
+	using CMd = Eigen::Map <const MatrixX<T> >;
+	using Md = Eigen::Map <MatrixX<T> >;
+
+	// the products below write straight into res, so they are only safe when res is not one of the inputs
+	if (Overlaps(resRawData, rows1 * cols2, data1, rows1 * cols1) ||
+		Overlaps(resRawData, rows1 * cols2, data2, rows2 * cols2)) {
+		CMd first(data1, rows1, cols1);
+		CMd second(data2, rows2, cols2);
+		Md res(resRawData, rows1, cols2);
+		res = first * second;
+		return true;
+	}
+
+	if (rows1 == cols1 && cols1 == rows2) {
+		return DispatchFixedSize<SquareMatMulKernelN>(rows1, data1, data2, cols2, resRawData);
+	}
+
+	CMd first(data1, rows1, cols1);
+	CMd second(data2, rows2, cols2);
+	Md res(resRawData, rows1, cols2);
+	res.noalias() = first * second;
+	return true;
+}
 
+template <typename T>
+static NAN_METHOD(MatMulImpl){
 	if (info.Length() < 7) {
 		Nan::ThrowTypeError("Wrong number of arguments");
 		return;
@@ -1074,38 +2237,3086 @@ NAN_METHOD(MatMul){
 	size_t rows1(info[0]->Uint32Value());
 	size_t cols1(info[1]->Uint32Value());
 
-	if (!info[2]->IsFloat64Array() || !info[5]->IsFloat64Array() || !info[6]->IsFloat64Array()) {
-		Nan::ThrowTypeError("Wrong arguments - expected Float64Array");
+	if (!ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[5]) || !ScalarArray<T>::Is(info[6])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
 		return;
 	}
 	
-	double *data1 = *(Nan::TypedArrayContents<double>(info[2]));
-	CMd first(data1, rows1, cols1);
+	Nan::TypedArrayContents<T> contents1(info[2]);
+	T *data1 = *contents1;
 
 	size_t rows2(info[3]->Uint32Value());
 	size_t cols2(info[4]->Uint32Value());
 
-	double *data2 = *(Nan::TypedArrayContents<double>(info[5]));
+	Nan::TypedArrayContents<T> contents2(info[5]);
+	T *data2 = *contents2;
 
-	CMd second(data2, rows2, cols2);
+	T *resRawData = *(Nan::TypedArrayContents<T>(info[6]));
 
-	double *resRawData = *(Nan::TypedArrayContents<double>(info[6]));
+	StridedView<T> left, right;
+	if (!ReadView(info, 7, data1, contents1.length(), rows1, cols1, left) ||
+		!ReadView(info, 9, data2, contents2.length(), rows2, cols2, right)) {
+		return;
+	}
 
-	Md res(resRawData, rows1, cols2);
-	res = first * second;
+	if (left.IsDense() && right.IsDense()) {
+		MatMulKernel(data1, rows1, cols1, data2, rows2, cols2, resRawData);
+	}
+	else {
+		ViewProductKernel(left, right, resRawData);
+	}
 	Local<Boolean> b = Nan::New(true);
 	info.GetReturnValue().Set(b);
 }
 
+NAN_METHOD(MatMul){
+	if (info[6]->IsFloat32Array()) {
+		MatMulImpl<float>(info);
+	}
+	else {
+		MatMulImpl<double>(info);
+	}
+}
 
+/**
+  *  Async variants:
+  *  Same arguments as the synchronous bindings plus a trailing callback(err). The Eigen work runs on the
+  *  libuv threadpool and the results are written into the given output buffers before the callback is called.
+*/
+static void QueueKernel(const Nan::FunctionCallbackInfo<v8::Value>& info, int callbackIndex,
+                        std::function<bool()> kernel, const char *errorMessage){
+    Nan::Callback *callback = new Nan::Callback(info[callbackIndex].As<v8::Function>());
+    KernelWorker *worker = new KernelWorker(callback, kernel, errorMessage);
+
+    for (int i = 0; i < callbackIndex; i++) {
+        if (info[i]->IsFloat64Array() || info[i]->IsFloat32Array()) {
+            worker->SaveToPersistent(std::to_string(i).c_str(), info[i]);
+        }
+    }
+    Nan::AsyncQueueWorker(worker);
+}
 
-void Init(v8::Local<v8::Object> exports) {
-	exports->Set(Nan::New("dot").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Dot)->GetFunction());
-	exports->Set(Nan::New("inner").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Inner)->GetFunction());
-	exports->Set(Nan::New("outer").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Outer)->GetFunction());
-	exports->Set(Nan::New("cholesky").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Cholesky)->GetFunction());
-	exports->Set(Nan::New("svd").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SVD)->GetFunction());
-	exports->Set(Nan::New("matrix_power").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(MatrixPower)->GetFunction());
+template <typename T>
+static NAN_METHOD(InverseAsyncImpl){
+    if (info.Length() < 5) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[1]->IsNumber() || !info[2]->IsNumber() || !info[4]->IsFunction()) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    if (!ScalarArray<T>::Is(info[0]) || !ScalarArray<T>::Is(info[3])) {
+        Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+        return;
+    }
+
+    T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
+    size_t rowsMatrix(info[1]->Uint32Value());
+    size_t colsMatrix(info[2]->Uint32Value());
+    T *refResData = *(Nan::TypedArrayContents<T>(info[3]));
+
+    QueueKernel(info, 4, [=]() {
+        return InverseKernel(refMatrixData, rowsMatrix, colsMatrix, refResData);
+    }, "Inverse failed");
+}
+
+NAN_METHOD(InverseAsync){
+    if (info[3]->IsFloat32Array()) {
+        InverseAsyncImpl<float>(info);
+    }
+    else {
+        InverseAsyncImpl<double>(info);
+    }
+}
+
+template <typename T>
+static NAN_METHOD(CholeskyAsyncImpl){
+    if (info.Length() < 5) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[1]->IsNumber() || !info[2]->IsNumber() || !info[4]->IsFunction()) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    if (!ScalarArray<T>::Is(info[0]) || !ScalarArray<T>::Is(info[3])) {
+        Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+        return;
+    }
+
+    T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
+    size_t rowsMatrix(info[1]->Uint32Value());
+    size_t colsMatrix(info[2]->Uint32Value());
+    T *refResData = *(Nan::TypedArrayContents<T>(info[3]));
+
+    QueueKernel(info, 4, [=]() {
+        return CholeskyKernel(refMatrixData, rowsMatrix, colsMatrix, refResData);
+    }, "Matrix is not positive definite");
+}
+
+NAN_METHOD(CholeskyAsync){
+    if (info[3]->IsFloat32Array()) {
+        CholeskyAsyncImpl<float>(info);
+    }
+    else {
+        CholeskyAsyncImpl<double>(info);
+    }
+}
+
+template <typename T>
+static NAN_METHOD(SVDAsyncImpl){
+    if (info.Length() < 9) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[1]->IsNumber() || !info[2]->IsNumber() || !info[8]->IsFunction()) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    bool isFullMatrices = info[3]->BooleanValue();
+    bool isComputeUV = info[4]->BooleanValue();
+
+    if (!ScalarArray<T>::Is(info[0]) || !ScalarArray<T>::Is(info[6]) ||
+        (isComputeUV && (!ScalarArray<T>::Is(info[5]) || !ScalarArray<T>::Is(info[7])))) {
+        Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+        return;
+    }
+
+    T *refMatrixData = *(Nan::TypedArrayContents<T>(info[0]));
+    int rowsMatrix(info[1]->Uint32Value());
+    int colsMatrix(info[2]->Uint32Value());
+    T *refResU = isComputeUV ? *(Nan::TypedArrayContents<T>(info[5])) : nullptr;
+    T *refResS = *(Nan::TypedArrayContents<T>(info[6]));
+    T *refResV = isComputeUV ? *(Nan::TypedArrayContents<T>(info[7])) : nullptr;
+    int algorithm = info.Length() > 9 && info[9]->IsUint32() ? info[9]->Uint32Value() : kSVDAuto;
+
+    QueueKernel(info, 8, [=]() {
+        return SVDKernel(refMatrixData, rowsMatrix, colsMatrix, isFullMatrices, isComputeUV, refResU, refResS, refResV,
+                         algorithm);
+    }, "SVD failed");
+}
+
+NAN_METHOD(SVDAsync){
+    if (info[6]->IsFloat32Array()) {
+        SVDAsyncImpl<float>(info);
+    }
+    else {
+        SVDAsyncImpl<double>(info);
+    }
+}
+
+template <typename T>
+static NAN_METHOD(GetEigenValuesAsyncImpl){
+	if (info.Length() != 5) {
+		Nan::ThrowTypeError("Wrong number of arguments");
+		return;
+	}
+
+	if (!info[0]->IsUint32() || !info[1]->IsUint32() || !info[4]->IsFunction()) {
+		Nan::ThrowTypeError("Wrong arguments");
+		return;
+	}
+
+	if (!ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[3])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+		return;
+	}
+
+	size_t rows1(info[0]->Uint32Value());
+	size_t cols1(info[1]->Uint32Value());
+	T *data1 = *(Nan::TypedArrayContents<T>(info[2]));
+	T *resRawData = *(Nan::TypedArrayContents<T>(info[3]));
+
+	QueueKernel(info, 4, [=]() {
+		return GetEigenValuesKernel(data1, rows1, cols1, resRawData);
+	}, "Eigen values computation did not converge");
+}
+
+NAN_METHOD(GetEigenValuesAsync){
+	if (info[3]->IsFloat32Array()) {
+		GetEigenValuesAsyncImpl<float>(info);
+	}
+	else {
+		GetEigenValuesAsyncImpl<double>(info);
+	}
+}
+
+template <typename T>
+static NAN_METHOD(SolveLinearSystemHouseholderQrAsyncImpl){
+	if (info.Length() != 6) {
+		Nan::ThrowTypeError("Wrong number of arguments");
+		return;
+	}
+
+	if (!info[0]->IsUint32() || !info[1]->IsUint32() || !info[5]->IsFunction()) {
+		Nan::ThrowTypeError("Wrong arguments");
+		return;
+	}
+
+	if (!ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[3]) || !ScalarArray<T>::Is(info[4])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+		return;
+	}
+
+	size_t rows1(info[0]->Uint32Value());
+	size_t cols1(info[1]->Uint32Value());
+	T *data1 = *(Nan::TypedArrayContents<T>(info[2]));
+	T *parameterData = *(Nan::TypedArrayContents<T>(info[3]));
+	T *resultData = *(Nan::TypedArrayContents<T>(info[4]));
+
+	size_t nrhs = CountSolveColumns<T>(info, rows1, cols1);
+	if (nrhs == 0) {
+		return;
+	}
+
+	QueueKernel(info, 5, [=]() {
+		return SolveLinearSystemHouseholderQrKernel(data1, rows1, cols1, nrhs, parameterData, resultData);
+	}, "Solve failed");
+}
+
+NAN_METHOD(SolveLinearSystemHouseholderQrAsync){
+	if (info[4]->IsFloat32Array()) {
+		SolveLinearSystemHouseholderQrAsyncImpl<float>(info);
+	}
+	else {
+		SolveLinearSystemHouseholderQrAsyncImpl<double>(info);
+	}
+}
+
+template <typename T>
+static NAN_METHOD(MatMulAsyncImpl){
+	if (info.Length() < 8) {
+		Nan::ThrowTypeError("Wrong number of arguments");
+		return;
+	}
+
+	if (!info[0]->IsUint32() || !info[1]->IsUint32() ||
+		!info[3]->IsUint32() || !info[4]->IsUint32() || !info[7]->IsFunction()) {
+		Nan::ThrowTypeError("Wrong arguments");
+		return;
+	}
+
+	if (!ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[5]) || !ScalarArray<T>::Is(info[6])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+		return;
+	}
+
+	size_t rows1(info[0]->Uint32Value());
+	size_t cols1(info[1]->Uint32Value());
+	T *data1 = *(Nan::TypedArrayContents<T>(info[2]));
+	size_t rows2(info[3]->Uint32Value());
+	size_t cols2(info[4]->Uint32Value());
+	T *data2 = *(Nan::TypedArrayContents<T>(info[5]));
+	T *resRawData = *(Nan::TypedArrayContents<T>(info[6]));
+
+	QueueKernel(info, 7, [=]() {
+		return MatMulKernel(data1, rows1, cols1, data2, rows2, cols2, resRawData);
+	}, "Matrix multiplication failed");
+}
+
+NAN_METHOD(MatMulAsync){
+	if (info[6]->IsFloat32Array()) {
+		MatMulAsyncImpl<float>(info);
+	}
+	else {
+		MatMulAsyncImpl<double>(info);
+	}
+}
+
+
+
+/**
+  *  Batched kernels:
+  *  Each buffer holds count matrices stored one after the other, every matrix in the same column-major
+  *  layout as numjs.Matrix.data. Large batches are split across the threads set by set_num_threads.
+*/
+static const int kBatchedParallelThreshold = 64;
+
+// whether a buffer of length elements holds count blocks of size elements, without computing count * size (which
+// can wrap for large uint32 arguments)
+static bool HoldsBlocks(size_t length, size_t count, uint64_t size){
+    return size == 0 || count <= length / size;
+}
+
+template <int N>
+struct SquareMatMulBatchedKernelN {
+    template <typename T>
+    static void run(size_t n, int count, const T *data1, size_t cols2, const T *data2, T *resRawData){
+        using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+        using CMRd = Eigen::Map <const Eigen::Matrix<T, N, Eigen::Dynamic> >;
+        using MRd = Eigen::Map <Eigen::Matrix<T, N, Eigen::Dynamic> >;
+
+        #pragma omp parallel for if(count >= kBatchedParallelThreshold) num_threads(Eigen::nbThreads())
+        for (int i = 0; i < count; i++) {
+            CMd first(data1 + i * n * n, n, n);
+            CMRd second(data2 + i * n * cols2, n, cols2);
+            MRd res(resRawData + i * n * cols2, n, cols2);
+            res.noalias() = first * second;
+        }
+    }
+};
+
+template <typename T>
+static void MatMulBatchedKernel(int count, size_t rows1, size_t cols1, const T *data1,
+                                size_t rows2, size_t cols2, const T *data2, T *resRawData){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    // the products are written straight into res, a result sharing memory with an operand needs a temporary
+    size_t resLength = (size_t)count * rows1 * cols2;
+    if (Overlaps(data1, (size_t)count * rows1 * cols1, resRawData, resLength) ||
+        Overlaps(data2, (size_t)count * rows2 * cols2, resRawData, resLength)) {
+        std::vector<T> temp(resLength);
+        MatMulBatchedKernel(count, rows1, cols1, data1, rows2, cols2, data2, temp.data());
+        std::copy(temp.begin(), temp.end(), resRawData);
+        return;
+    }
+
+    if (rows1 == cols1) {
+        DispatchFixedSize<SquareMatMulBatchedKernelN>(rows1, count, data1, cols2, data2, resRawData);
+        return;
+    }
+
+    #pragma omp parallel for if(count >= kBatchedParallelThreshold) num_threads(Eigen::nbThreads())
+    for (int i = 0; i < count; i++) {
+        CMd first(data1 + i * rows1 * cols1, rows1, cols1);
+        CMd second(data2 + i * rows2 * cols2, rows2, cols2);
+        Md res(resRawData + i * rows1 * cols2, rows1, cols2);
+        res.noalias() = first * second;
+    }
+}
+
+template <int N>
+struct InverseBatchedKernelN {
+    template <typename T>
+    static void run(size_t n, int count, const T *data, T *resRawData){
+        using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+        using Md = Eigen::Map <Eigen::Matrix<T, N, N> >;
+
+        #pragma omp parallel for if(count >= kBatchedParallelThreshold) num_threads(Eigen::nbThreads())
+        for (int i = 0; i < count; i++) {
+            CMd inputMat(data + i * n * n, n, n);
+            Md res(resRawData + i * n * n, n, n);
+            res = inputMat.inverse();
+        }
+    }
+};
+
+template <typename T>
+static void InverseBatchedKernel(int count, size_t n, const T *data, T *resRawData){
+    size_t length = (size_t)count * n * n;
+    if (Overlaps(data, length, resRawData, length)) {
+        std::vector<T> temp(length);
+        InverseBatchedKernel(count, n, data, temp.data());
+        std::copy(temp.begin(), temp.end(), resRawData);
+        return;
+    }
+
+    DispatchFixedSize<InverseBatchedKernelN>(n, count, data, resRawData);
+}
+
+template <int N>
+struct DetBatchedKernelN {
+    template <typename T>
+    static void run(size_t n, int count, const T *data, T *resRawData){
+        using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+
+        #pragma omp parallel for if(count >= kBatchedParallelThreshold) num_threads(Eigen::nbThreads())
+        for (int i = 0; i < count; i++) {
+            CMd inputMat(data + i * n * n, n, n);
+            resRawData[i] = inputMat.determinant();
+        }
+    }
+};
+
+template <typename T>
+static void DetBatchedKernel(int count, size_t n, const T *data, T *resRawData){
+    if (Overlaps(data, (size_t)count * n * n, resRawData, (size_t)count)) {
+        std::vector<T> temp(count);
+        DetBatchedKernel(count, n, data, temp.data());
+        std::copy(temp.begin(), temp.end(), resRawData);
+        return;
+    }
+
+    DispatchFixedSize<DetBatchedKernelN>(n, count, data, resRawData);
+}
+
+template <int N>
+struct SolveBatchedKernelN {
+    template <typename T>
+    static void run(size_t n, int count, const T *dataA, size_t nrhs, const T *dataB, T *resRawData){
+        using CMd = Eigen::Map <const Eigen::Matrix<T, N, N> >;
+        using CMRd = Eigen::Map <const Eigen::Matrix<T, N, Eigen::Dynamic> >;
+        using MRd = Eigen::Map <Eigen::Matrix<T, N, Eigen::Dynamic> >;
+
+        #pragma omp parallel for if(count >= kBatchedParallelThreshold) num_threads(Eigen::nbThreads())
+        for (int i = 0; i < count; i++) {
+            CMd matrixA(dataA + i * n * n, n, n);
+            CMRd matrixB(dataB + i * n * nrhs, n, nrhs);
+            MRd res(resRawData + i * n * nrhs, n, nrhs);
+            res = Eigen::PartialPivLU<Eigen::Matrix<T, N, N> >(matrixA).solve(matrixB);
+        }
+    }
+};
+
+template <typename T>
+static void SolveBatchedKernel(int count, size_t n, const T *dataA, size_t nrhs, const T *dataB, T *resRawData){
+    size_t resLength = (size_t)count * n * nrhs;
+    if (Overlaps(dataA, (size_t)count * n * n, resRawData, resLength) || Overlaps(dataB, resLength, resRawData, resLength)) {
+        std::vector<T> temp(resLength);
+        SolveBatchedKernel(count, n, dataA, nrhs, dataB, temp.data());
+        std::copy(temp.begin(), temp.end(), resRawData);
+        return;
+    }
+
+    DispatchFixedSize<SolveBatchedKernelN>(n, count, dataA, nrhs, dataB, resRawData);
+}
+
+/**
+  *  MatMulBatched:
+  *  Multiplies count pairs of stacked matrices, res[i] = left[i] * right[i].
+  *
+  *  arguments:
+  *  info[0]: Number represent the number of matrices in the batch.
+  *  info[1]: Number represent the number of rows of each left matrix.
+  *  info[2]: Number represent the number of columns of each left matrix.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) holding the stacked left matrices.
+  *  info[4]: Number represent the number of rows of each right matrix.
+  *  info[5]: Number represent the number of columns of each right matrix.
+  *  info[6]: Buffer(object created by Float64Array or Float32Array) holding the stacked right matrices.
+  *  info[7]: Buffer(object created by Float64Array or Float32Array) for return value, the stacked products.
+*/
+template <typename T>
+static NAN_METHOD(MatMulBatchedImpl){
+	if (info.Length() < 8) {
+		Nan::ThrowTypeError("Wrong number of arguments");
+		return;
+	}
+
+	if (!info[0]->IsUint32() || !info[1]->IsUint32() || !info[2]->IsUint32() ||
+		!info[4]->IsUint32() || !info[5]->IsUint32()) {
+		Nan::ThrowTypeError("Wrong arguments");
+		return;
+	}
+
+	if (!ScalarArray<T>::Is(info[3]) || !ScalarArray<T>::Is(info[6]) || !ScalarArray<T>::Is(info[7])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+		return;
+	}
+
+	size_t count(info[0]->Uint32Value());
+	size_t rows1(info[1]->Uint32Value());
+	size_t cols1(info[2]->Uint32Value());
+	size_t rows2(info[4]->Uint32Value());
+	size_t cols2(info[5]->Uint32Value());
+	Nan::TypedArrayContents<T> data1(info[3]);
+	Nan::TypedArrayContents<T> data2(info[6]);
+	Nan::TypedArrayContents<T> resRawData(info[7]);
+
+	if (cols1 != rows2) {
+		Nan::ThrowTypeError("Wrong arguments - the left cols and right rows must agree");
+		return;
+	}
+
+	if (count > INT_MAX) {
+		Nan::ThrowRangeError("Wrong arguments - count is too large");
+		return;
+	}
+
+	if (!HoldsBlocks(data1.length(), count, (uint64_t)rows1 * cols1) || !HoldsBlocks(data2.length(), count, (uint64_t)rows2 * cols2) ||
+		!HoldsBlocks(resRawData.length(), count, (uint64_t)rows1 * cols2)) {
+		Nan::ThrowTypeError("Wrong arguments - buffer is smaller than count matrices");
+		return;
+	}
+
+	MatMulBatchedKernel((int)count, rows1, cols1, *data1, rows2, cols2, *data2, *resRawData);
+	Local<Boolean> b = Nan::New(true);
+	info.GetReturnValue().Set(b);
+}
+
+NAN_METHOD(MatMulBatched){
+	if (info[7]->IsFloat32Array()) {
+		MatMulBatchedImpl<float>(info);
+	}
+	else {
+		MatMulBatchedImpl<double>(info);
+	}
+}
+
+/**
+  *  InverseBatched:
+  *  Computes the inverse of count stacked square matrices.
+  *
+  *  arguments:
+  *  info[0]: Number represent the number of matrices in the batch.
+  *  info[1]: Number n represent the dimensions of each nXn matrix.
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) holding the stacked matrices.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for return value, the stacked inverses.
+*/
+template <typename T>
+static NAN_METHOD(InverseBatchedImpl){
+	if (info.Length() < 4) {
+		Nan::ThrowTypeError("Wrong number of arguments");
+		return;
+	}
+
+	if (!info[0]->IsUint32() || !info[1]->IsUint32()) {
+		Nan::ThrowTypeError("Wrong arguments");
+		return;
+	}
+
+	if (!ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[3])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+		return;
+	}
+
+	size_t count(info[0]->Uint32Value());
+	size_t n(info[1]->Uint32Value());
+	Nan::TypedArrayContents<T> data(info[2]);
+	Nan::TypedArrayContents<T> resRawData(info[3]);
+
+	if (count > INT_MAX) {
+		Nan::ThrowRangeError("Wrong arguments - count is too large");
+		return;
+	}
+
+	if (!HoldsBlocks(data.length(), count, (uint64_t)n * n) || !HoldsBlocks(resRawData.length(), count, (uint64_t)n * n)) {
+		Nan::ThrowTypeError("Wrong arguments - buffer is smaller than count matrices");
+		return;
+	}
+
+	InverseBatchedKernel((int)count, n, *data, *resRawData);
+	Local<Boolean> b = Nan::New(true);
+	info.GetReturnValue().Set(b);
+}
+
+NAN_METHOD(InverseBatched){
+	if (info[3]->IsFloat32Array()) {
+		InverseBatchedImpl<float>(info);
+	}
+	else {
+		InverseBatchedImpl<double>(info);
+	}
+}
+
+/**
+  *  DetBatched:
+  *  Computes the determinant of count stacked square matrices.
+  *
+  *  arguments:
+  *  info[0]: Number represent the number of matrices in the batch.
+  *  info[1]: Number n represent the dimensions of each nXn matrix.
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) holding the stacked matrices.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) for return value, one determinant per matrix.
+*/
+template <typename T>
+static NAN_METHOD(DetBatchedImpl){
+	if (info.Length() < 4) {
+		Nan::ThrowTypeError("Wrong number of arguments");
+		return;
+	}
+
+	if (!info[0]->IsUint32() || !info[1]->IsUint32()) {
+		Nan::ThrowTypeError("Wrong arguments");
+		return;
+	}
+
+	if (!ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[3])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+		return;
+	}
+
+	size_t count(info[0]->Uint32Value());
+	size_t n(info[1]->Uint32Value());
+	Nan::TypedArrayContents<T> data(info[2]);
+	Nan::TypedArrayContents<T> resRawData(info[3]);
+
+	if (count > INT_MAX) {
+		Nan::ThrowRangeError("Wrong arguments - count is too large");
+		return;
+	}
+
+	if (!HoldsBlocks(data.length(), count, (uint64_t)n * n) || resRawData.length() < count) {
+		Nan::ThrowTypeError("Wrong arguments - buffer is smaller than count matrices");
+		return;
+	}
+
+	DetBatchedKernel((int)count, n, *data, *resRawData);
+	Local<Boolean> b = Nan::New(true);
+	info.GetReturnValue().Set(b);
+}
+
+NAN_METHOD(DetBatched){
+	if (info[3]->IsFloat32Array()) {
+		DetBatchedImpl<float>(info);
+	}
+	else {
+		DetBatchedImpl<double>(info);
+	}
+}
+
+/**
+  *  SolveBatched:
+  *  Solves count stacked square systems A[i] * X[i] = B[i] using LU decomposition with partial pivoting.
+  *
+  *  arguments:
+  *  info[0]: Number represent the number of systems in the batch.
+  *  info[1]: Number n represent the dimensions of each nXn coefficient matrix.
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) holding the stacked coefficient matrices.
+  *  info[3]: Number represent the number of right hand sides (columns of each B[i]).
+  *  info[4]: Buffer(object created by Float64Array or Float32Array) holding the stacked right hand sides.
+  *  info[5]: Buffer(object created by Float64Array or Float32Array) for return value, the stacked solutions.
+*/
+template <typename T>
+static NAN_METHOD(SolveBatchedImpl){
+	if (info.Length() < 6) {
+		Nan::ThrowTypeError("Wrong number of arguments");
+		return;
+	}
+
+	if (!info[0]->IsUint32() || !info[1]->IsUint32() || !info[3]->IsUint32()) {
+		Nan::ThrowTypeError("Wrong arguments");
+		return;
+	}
+
+	if (!ScalarArray<T>::Is(info[2]) || !ScalarArray<T>::Is(info[4]) || !ScalarArray<T>::Is(info[5])) {
+		Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+		return;
+	}
+
+	size_t count(info[0]->Uint32Value());
+	size_t n(info[1]->Uint32Value());
+	size_t nrhs(info[3]->Uint32Value());
+	Nan::TypedArrayContents<T> dataA(info[2]);
+	Nan::TypedArrayContents<T> dataB(info[4]);
+	Nan::TypedArrayContents<T> resRawData(info[5]);
+
+	if (count > INT_MAX) {
+		Nan::ThrowRangeError("Wrong arguments - count is too large");
+		return;
+	}
+
+	if (!HoldsBlocks(dataA.length(), count, (uint64_t)n * n) || !HoldsBlocks(dataB.length(), count, (uint64_t)n * nrhs) ||
+		!HoldsBlocks(resRawData.length(), count, (uint64_t)n * nrhs)) {
+		Nan::ThrowTypeError("Wrong arguments - buffer is smaller than count matrices");
+		return;
+	}
+
+	SolveBatchedKernel((int)count, n, *dataA, nrhs, *dataB, *resRawData);
+	Local<Boolean> b = Nan::New(true);
+	info.GetReturnValue().Set(b);
+}
+
+NAN_METHOD(SolveBatched){
+	if (info[5]->IsFloat32Array()) {
+		SolveBatchedImpl<float>(info);
+	}
+	else {
+		SolveBatchedImpl<double>(info);
+	}
+}
+
+/**
+  *  Factorization helpers:
+  *  What the Eigen decompositions do not offer under one name - a success flag, the determinant and
+  *  the reciprocal condition number.
+*/
+template <typename Decomposition>
+static bool FactorSucceeded(const Decomposition &decomposition){
+    return true;
+}
+
+template <typename M>
+static bool FactorSucceeded(const Eigen::LLT<M> &llt){
+    return llt.info() == Eigen::Success;
+}
+
+template <typename M>
+static bool FactorSucceeded(const Eigen::LDLT<M> &ldlt){
+    return ldlt.info() == Eigen::Success;
+}
+
+template <typename M, int UpLo, typename Ordering>
+static bool FactorSucceeded(const Eigen::SimplicialLLT<M, UpLo, Ordering> &llt){
+    return llt.info() == Eigen::Success;
+}
+
+template <typename M, int UpLo, typename Ordering>
+static bool FactorSucceeded(const Eigen::SimplicialLDLT<M, UpLo, Ordering> &ldlt){
+    return ldlt.info() == Eigen::Success;
+}
+
+template <typename M, typename Ordering>
+static bool FactorSucceeded(const Eigen::SparseLU<M, Ordering> &lu){
+    return lu.info() == Eigen::Success;
+}
+
+template <typename M>
+static typename M::Scalar FactorDeterminant(const Eigen::PartialPivLU<M> &lu){
+    return lu.determinant();
+}
+
+template <typename M>
+static typename M::Scalar FactorDeterminant(const Eigen::HouseholderQR<M> &qr){
+    // Q is a product of Householder reflections, each one has a determinant of -1 unless its coefficient is 0
+    typename M::Scalar det = qr.matrixQR().diagonal().prod();
+    for (Eigen::Index i = 0; i < qr.hCoeffs().size(); i++) {
+        if (qr.hCoeffs()(i) != 0) {
+            det = -det;
+        }
+    }
+    return det;
+}
+
+template <typename M>
+static typename M::Scalar FactorDeterminant(const Eigen::LLT<M> &llt){
+    typename M::Scalar diagonalProduct = llt.matrixLLT().diagonal().prod();
+    return diagonalProduct * diagonalProduct;
+}
+
+template <typename M>
+static typename M::Scalar FactorDeterminant(const Eigen::LDLT<M> &ldlt){
+    return ldlt.vectorD().prod();
+}
+
+template <typename M, int UpLo, typename Ordering>
+static typename M::Scalar FactorDeterminant(const Eigen::SimplicialLLT<M, UpLo, Ordering> &llt){
+    return llt.determinant();
+}
+
+template <typename M, int UpLo, typename Ordering>
+static typename M::Scalar FactorDeterminant(const Eigen::SimplicialLDLT<M, UpLo, Ordering> &ldlt){
+    return ldlt.determinant();
+}
+
+template <typename M, typename Ordering>
+static typename M::Scalar FactorDeterminant(const Eigen::SparseLU<M, Ordering> &lu){
+    // SparseLU::determinant only reads the factors but is not declared const
+    return const_cast<Eigen::SparseLU<M, Ordering> &>(lu).determinant();
+}
+
+template <typename Decomposition>
+static typename Decomposition::MatrixType::Scalar FactorRCond(const Decomposition &decomposition){
+    return decomposition.rcond();
+}
+
+template <typename M>
+static typename M::Scalar FactorRCond(const Eigen::HouseholderQR<M> &qr){
+    // HouseholderQR has no condition estimator, the spread of the R diagonal is a cheap (rough) substitute
+    auto diagonal = qr.matrixQR().diagonal().cwiseAbs();
+    return diagonal.size() == 0 || diagonal.maxCoeff() == 0 ? 0 : diagonal.minCoeff() / diagonal.maxCoeff();
+}
+
+// the sparse solvers have no condition estimator, rcond() returns NaN for them
+template <typename M, int UpLo, typename Ordering>
+static typename M::Scalar FactorRCond(const Eigen::SimplicialLLT<M, UpLo, Ordering> &llt){
+    return std::numeric_limits<typename M::Scalar>::quiet_NaN();
+}
+
+template <typename M, int UpLo, typename Ordering>
+static typename M::Scalar FactorRCond(const Eigen::SimplicialLDLT<M, UpLo, Ordering> &ldlt){
+    return std::numeric_limits<typename M::Scalar>::quiet_NaN();
+}
+
+template <typename M, typename Ordering>
+static typename M::Scalar FactorRCond(const Eigen::SparseLU<M, Ordering> &lu){
+    return std::numeric_limits<typename M::Scalar>::quiet_NaN();
+}
+
+// log |det(A)|, from the diagonal of the factors when they have one so it does not overflow for large matrices
+template <typename Decomposition>
+static typename Decomposition::MatrixType::Scalar FactorLogDeterminant(const Decomposition &decomposition){
+    return std::log(std::abs(FactorDeterminant(decomposition)));
+}
+
+template <typename M>
+static typename M::Scalar FactorLogDeterminant(const Eigen::PartialPivLU<M> &lu){
+    return lu.matrixLU().diagonal().cwiseAbs().array().log().sum();
+}
+
+template <typename M>
+static typename M::Scalar FactorLogDeterminant(const Eigen::HouseholderQR<M> &qr){
+    return qr.matrixQR().diagonal().cwiseAbs().array().log().sum();
+}
+
+template <typename M>
+static typename M::Scalar FactorLogDeterminant(const Eigen::LLT<M> &llt){
+    return 2 * llt.matrixLLT().diagonal().array().log().sum();
+}
+
+template <typename M>
+static typename M::Scalar FactorLogDeterminant(const Eigen::LDLT<M> &ldlt){
+    return ldlt.vectorD().cwiseAbs().array().log().sum();
+}
+
+template <typename M, int UpLo, typename Ordering>
+static typename M::Scalar FactorLogDeterminant(const Eigen::SimplicialLLT<M, UpLo, Ordering> &llt){
+    // matrixL() is the lower factor whatever UpLo, the fill reducing permutation does not change the determinant
+    return 2 * llt.matrixL().nestedExpression().diagonal().array().log().sum();
+}
+
+template <typename M, int UpLo, typename Ordering>
+static typename M::Scalar FactorLogDeterminant(const Eigen::SimplicialLDLT<M, UpLo, Ordering> &ldlt){
+    return ldlt.vectorD().cwiseAbs().array().log().sum();
+}
+
+template <typename M, typename Ordering>
+static typename M::Scalar FactorLogDeterminant(const Eigen::SparseLU<M, Ordering> &lu){
+    return lu.logAbsDeterminant();
+}
+
+// Cholesky factors of A can be turned into the factors of A + sigma * v * v' in O(n^2), see RankUpdate.
+// Eigen estimates their rcond from the L1 norm of A taken when they were computed, which an update makes
+// stale, so the updatable ones keep their own (an upper bound once updated) from the lower triangle of A.
+template <typename Decomposition>
+struct FactorUpdatable {
+    static const bool value = false;
+
+    template <typename Input>
+    static double L1Norm(const Input &matrix) { return 0; }
+};
+
+template <typename Decomposition>
+struct SymmetricFactorUpdatable {
+    static const bool value = true;
+
+    template <typename Input>
+    static double L1Norm(const Input &matrix) {
+        double norm = 0;
+        for (Eigen::Index col = 0; col < matrix.cols(); col++) {
+            double sum = (double)(matrix.col(col).tail(matrix.rows() - col).cwiseAbs().sum() +
+                                  matrix.row(col).head(col).cwiseAbs().sum());
+            norm = std::max(norm, sum);
+        }
+        return norm;
+    }
+};
+
+template <typename M>
+struct FactorUpdatable<Eigen::LLT<M> > : SymmetricFactorUpdatable<Eigen::LLT<M> > {};
+
+template <typename M>
+struct FactorUpdatable<Eigen::LDLT<M> > : SymmetricFactorUpdatable<Eigen::LDLT<M> > {};
+
+// a failed downdate leaves the factors half updated, so they are restored from a copy
+template <typename M, typename Vector>
+static bool FactorRankUpdate(Eigen::LLT<M> &llt, const Vector &v, typename M::Scalar sigma){
+    if (sigma >= 0) {
+        llt.rankUpdate(v, sigma);
+        return llt.info() == Eigen::Success;
+    }
+
+    Eigen::LLT<M> previous(llt);
+    llt.rankUpdate(v, sigma);
+    if (llt.info() != Eigen::Success) {
+        llt = previous;
+        return false;
+    }
+    return true;
+}
+
+template <typename M, typename Vector>
+static bool FactorRankUpdate(Eigen::LDLT<M> &ldlt, const Vector &v, typename M::Scalar sigma){
+    if (sigma >= 0) {
+        ldlt.rankUpdate(v, sigma);
+        return ldlt.info() == Eigen::Success;
+    }
+
+    Eigen::LDLT<M> previous(ldlt);
+    ldlt.rankUpdate(v, sigma);
+    if (ldlt.info() != Eigen::Success) {
+        ldlt = previous;
+        return false;
+    }
+    return true;
+}
+
+// 1 / (|A|_1 * |A^-1|_1) for symmetric A, |A^-1|_1 estimated by Hager's method from a few solves against the factors
+template <typename Decomposition>
+static typename Decomposition::MatrixType::Scalar SymmetricRCondEstimate(const Decomposition &decomposition, double l1Norm){
+    using T = typename Decomposition::MatrixType::Scalar;
+    Eigen::Index n = decomposition.rows();
+    if (n == 0) {
+        return 1;
+    }
+    if (l1Norm == 0) {
+        return 0;
+    }
+
+    VectorX<T> x = VectorX<T>::Constant(n, T(1) / n), y, z;
+    double inverseNorm = 0;
+    for (int iteration = 0; iteration < 5; iteration++) {
+        y = decomposition.solve(x);
+        inverseNorm = std::max(inverseNorm, (double)y.cwiseAbs().sum());
+        z = decomposition.solve(VectorX<T>(y.unaryExpr([](T value) { return value < 0 ? T(-1) : T(1); })));
+
+        Eigen::Index j;
+        if ((double)z.cwiseAbs().maxCoeff(&j) <= (double)z.dot(x)) {
+            break;
+        }
+        x.setZero();
+        x(j) = 1;
+    }
+
+    return std::isfinite(inverseNorm) && inverseNorm > 0 ? (T)(1 / (l1Norm * inverseNorm)) : 0;
+}
+
+// the rcond of factors changed by a rank update, only the updatable ones ever are
+template <typename Decomposition>
+static typename Decomposition::MatrixType::Scalar FactorUpdatedRCond(const Decomposition &decomposition, double l1Norm){
+    return FactorRCond(decomposition);
+}
+
+template <typename M>
+static typename M::Scalar FactorUpdatedRCond(const Eigen::LLT<M> &llt, double l1Norm){
+    return SymmetricRCondEstimate(llt, l1Norm);
+}
+
+template <typename M>
+static typename M::Scalar FactorUpdatedRCond(const Eigen::LDLT<M> &ldlt, double l1Norm){
+    return SymmetricRCondEstimate(ldlt, l1Norm);
+}
+
+/**
+  *  Factorization:
+  *  A decomposition of a matrix computed once and kept in native memory by the JS object wrapping it,
+  *  so every further solve against the same matrix costs O(n^2) instead of a new O(n^3) factorization.
+  *  Decomposition is one of Eigen::PartialPivLU, Eigen::HouseholderQR, Eigen::LLT or Eigen::LDLT over
+  *  MatrixX<float> or MatrixX<double>, or one of the sparse Eigen::SimplicialLLT, Eigen::SimplicialLDLT
+  *  and Eigen::SparseLU (see SparseFactorize).
+  *
+  *  JS properties and methods:
+  *  rows, cols: the shape of the factorized matrix A.
+  *  solve(b): returns x such that A * x = b (the least squares solution for a non square QR). b holds one or
+  *            more right hand sides of A.rows elements each, stored column by column, in the dtype of A.
+  *  solveInto(b, out): same as solve, writes x into out instead of allocating it.
+  *  determinant(): the determinant of A, square matrices only.
+  *  logDeterminant(): log |det(A)|, square matrices only, finite where determinant() overflows.
+  *  rcond(): an estimate of the reciprocal condition number of A, after a rank update one estimated
+  *          from the updated factors (Hager's method, a few O(n^2) solves).
+  *  rankUpdate(v, sigma): LLT and LDLT only - replaces the factors of A by those of A + sigma * v * v' in O(n^2),
+  *            an update for sigma > 0 and a downdate for sigma < 0 (1 when omitted). v holds A.rows elements in
+  *            the dtype of A. A downdate which leaves an LLT matrix not positive definite throws and keeps the
+  *            factors unchanged.
+*/
+template <typename Decomposition>
+class Factorization : public Nan::ObjectWrap {
+public:
+    using T = typename Decomposition::MatrixType::Scalar;
+    using MatrixType = MatrixX<T>;
+
+    // factorizes the matrix and returns the wrapping object, throws errorMessage when the decomposition fails.
+    // bytes is the native memory reported to V8 for the lifetime of the object.
+    template <typename Input>
+    static void NewInstance(const Nan::FunctionCallbackInfo<v8::Value>& info, const char *className,
+                            const Input &matrix, size_t bytes, const char *errorMessage){
+        size_t rows = matrix.rows(), cols = matrix.cols();
+
+        if (constructor.IsEmpty()) {
+            v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>();
+            tpl->SetClassName(Nan::New(className).ToLocalChecked());
+            tpl->InstanceTemplate()->SetInternalFieldCount(1);
+            Nan::SetPrototypeMethod(tpl, "solve", Solve);
+            Nan::SetPrototypeMethod(tpl, "solveInto", SolveInto);
+            Nan::SetPrototypeMethod(tpl, "determinant", Determinant);
+            Nan::SetPrototypeMethod(tpl, "logDeterminant", LogDeterminant);
+            Nan::SetPrototypeMethod(tpl, "rcond", RCond);
+            SetRankUpdateMethod(tpl, std::integral_constant<bool, FactorUpdatable<Decomposition>::value>());
+            constructor.Reset(Nan::GetFunction(tpl).ToLocalChecked());
+        }
+
+        v8::Local<v8::Object> instance = Nan::NewInstance(Nan::New(constructor)).ToLocalChecked();
+        Factorization *factorization = new Factorization(rows, cols, bytes);
+        factorization->Wrap(instance);
+        factorization->decomposition.compute(matrix);
+        factorization->l1Norm = FactorUpdatable<Decomposition>::L1Norm(matrix);
+
+        if (!FactorSucceeded(factorization->decomposition)) {
+            Nan::ThrowError(errorMessage);
+            return;
+        }
+
+        Nan::Set(instance, Nan::New("rows").ToLocalChecked(), Nan::New((uint32_t)rows));
+        Nan::Set(instance, Nan::New("cols").ToLocalChecked(), Nan::New((uint32_t)cols));
+        info.GetReturnValue().Set(instance);
+    }
+
+private:
+    // rankUpdate only exists, and RankUpdate is only instantiated, for the updatable decompositions
+    static void SetRankUpdateMethod(v8::Local<v8::FunctionTemplate> tpl, std::true_type){
+        Nan::SetPrototypeMethod(tpl, "rankUpdate", RankUpdate);
+    }
+
+    static void SetRankUpdateMethod(v8::Local<v8::FunctionTemplate> tpl, std::false_type){
+    }
+
+    Factorization(size_t rows, size_t cols, size_t bytes) : rows(rows), cols(cols), bytes(bytes), updated(false), l1Norm(0) {
+        Nan::AdjustExternalMemory(bytes);
+    }
+
+    ~Factorization() {
+        Nan::AdjustExternalMemory(-(int64_t)bytes);
+    }
+
+    // the number of right hand sides in b, 0 when b is not a whole number of A.rows long columns
+    static size_t CountRightHandSides(const Nan::FunctionCallbackInfo<v8::Value>& info, Factorization *self){
+        if (info.Length() < 1 || !ScalarArray<T>::Is(info[0])) {
+            Nan::ThrowTypeError("Wrong arguments - b must be a typed array of the factorized matrix dtype");
+            return 0;
+        }
+
+        size_t length = Nan::TypedArrayContents<T>(info[0]).length();
+        if (length == 0 || length % self->rows != 0) {
+            Nan::ThrowTypeError("Wrong arguments - b must hold columns of A.rows elements");
+            return 0;
+        }
+        return length / self->rows;
+    }
+
+    void SolveKernel(const T *b, size_t nrhs, T *x) const {
+        Eigen::Map <const MatrixType> rhs(b, rows, nrhs);
+        Eigen::Map <MatrixType> res(x, cols, nrhs);
+
+        // the solvers write straight into res, solving in place needs a temporary
+        if (Overlaps(b, rows * nrhs, x, cols * nrhs)) {
+            res = MatrixType(decomposition.solve(rhs));
+        }
+        else {
+            res = decomposition.solve(rhs);
+        }
+    }
+
+    static NAN_METHOD(Solve){
+        Factorization *self = Nan::ObjectWrap::Unwrap<Factorization>(info.Holder());
+        size_t nrhs = CountRightHandSides(info, self);
+        if (nrhs == 0) {
+            return;
+        }
+
+        v8::Local<v8::Value> x = ScalarArray<T>::New(self->cols * nrhs);
+        self->SolveKernel(*(Nan::TypedArrayContents<T>(info[0])), nrhs, *(Nan::TypedArrayContents<T>(x)));
+        info.GetReturnValue().Set(x);
+    }
+
+    static NAN_METHOD(SolveInto){
+        Factorization *self = Nan::ObjectWrap::Unwrap<Factorization>(info.Holder());
+        size_t nrhs = CountRightHandSides(info, self);
+        if (nrhs == 0) {
+            return;
+        }
+
+        if (info.Length() < 2 || !ScalarArray<T>::Is(info[1]) ||
+            Nan::TypedArrayContents<T>(info[1]).length() != self->cols * nrhs) {
+            Nan::ThrowTypeError("Wrong arguments - out must be a typed array of A.cols elements per right hand side");
+            return;
+        }
+
+        self->SolveKernel(*(Nan::TypedArrayContents<T>(info[0])), nrhs, *(Nan::TypedArrayContents<T>(info[1])));
+        Local<Boolean> b = Nan::New(true);
+        info.GetReturnValue().Set(b);
+    }
+
+    static NAN_METHOD(Determinant){
+        Factorization *self = Nan::ObjectWrap::Unwrap<Factorization>(info.Holder());
+        if (self->rows != self->cols) {
+            Nan::ThrowError("The determinant is only defined for square matrices");
+            return;
+        }
+
+        v8::Local<v8::Number> num = Nan::New((double)FactorDeterminant(self->decomposition));
+        info.GetReturnValue().Set(num);
+    }
+
+    static NAN_METHOD(LogDeterminant){
+        Factorization *self = Nan::ObjectWrap::Unwrap<Factorization>(info.Holder());
+        if (self->rows != self->cols) {
+            Nan::ThrowError("The determinant is only defined for square matrices");
+            return;
+        }
+
+        v8::Local<v8::Number> num = Nan::New((double)FactorLogDeterminant(self->decomposition));
+        info.GetReturnValue().Set(num);
+    }
+
+    static NAN_METHOD(RCond){
+        Factorization *self = Nan::ObjectWrap::Unwrap<Factorization>(info.Holder());
+        T rcond = self->updated ? FactorUpdatedRCond(self->decomposition, self->l1Norm) : FactorRCond(self->decomposition);
+        v8::Local<v8::Number> num = Nan::New((double)rcond);
+        info.GetReturnValue().Set(num);
+    }
+
+    static NAN_METHOD(RankUpdate){
+        Factorization *self = Nan::ObjectWrap::Unwrap<Factorization>(info.Holder());
+        if (info.Length() < 1 || !ScalarArray<T>::Is(info[0]) || Nan::TypedArrayContents<T>(info[0]).length() != self->rows) {
+            Nan::ThrowTypeError("Wrong arguments - v must be a typed array of A.rows elements of the factorized matrix dtype");
+            return;
+        }
+
+        T sigma = info.Length() > 1 && info[1]->IsNumber() ? (T)info[1]->NumberValue() : 1;
+        Nan::TypedArrayContents<T> data(info[0]);
+        Eigen::Map <const VectorX<T> > v(*data, self->rows);
+
+        if (!FactorRankUpdate(self->decomposition, v, sigma)) {
+            Nan::ThrowError(sigma < 0 ? "The downdated matrix is not positive definite" : "Rank update failed");
+            return;
+        }
+
+        // |A + sigma * v * v'|_1 <= |A|_1 + |sigma| * |v|_1 * |v|_inf
+        self->l1Norm += std::abs((double)sigma) * (double)v.cwiseAbs().sum() * (double)v.cwiseAbs().maxCoeff();
+        self->updated = true;
+        Local<Boolean> b = Nan::New(true);
+        info.GetReturnValue().Set(b);
+    }
+
+    static Nan::Persistent<v8::Function> constructor;
+
+    size_t rows;
+    size_t cols;
+    size_t bytes;
+    // whether rankUpdate changed the factors since they were computed, and the L1 norm (bound) of the updatable ones
+    bool updated;
+    double l1Norm;
+    Decomposition decomposition;
+};
+
+template <typename Decomposition>
+Nan::Persistent<v8::Function> Factorization<Decomposition>::constructor;
+
+/**
+  *  LU, QR, CholeskyFactor, LDLT:
+  *  Factorize a matrix once and return a Factorization object to solve against it repeatedly.
+  *  LU uses partial pivoting and QR Householder reflections, LLT (cholesky_factor) requires a positive
+  *  definite matrix and LDLT a positive or negative semidefinite one. Only QR accepts non square matrices.
+  *
+  *  arguments:
+  *  info[0]: Buffer(object created by Float64Array or Float32Array) represent the numjs.Matrix object to factorize.
+  *  info[1]: Number represent the number of rows of the matrix.
+  *  info[2]: Number represent the number of columns of the matrix.
+  *  info[3], info[4]: Optional - leading dimension and transposed flag of the matrix (see StridedView).
+*/
+template <typename Decomposition>
+static void FactorizeImpl(const Nan::FunctionCallbackInfo<v8::Value>& info, const char *className,
+                          bool isSquareOnly, const char *errorMessage){
+    using T = typename Decomposition::MatrixType::Scalar;
+
+    if (info.Length() < 3) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[1]->IsUint32() || !info[2]->IsUint32()) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    size_t rowsMatrix(info[1]->Uint32Value());
+    size_t colsMatrix(info[2]->Uint32Value());
+    Nan::TypedArrayContents<T> data(info[0]);
+
+    StridedView<T> matrix;
+    if (rowsMatrix == 0 || colsMatrix == 0) {
+        Nan::ThrowTypeError("Wrong arguments - the buffer must hold rows * cols elements");
+        return;
+    }
+    if (!ReadView(info, 3, *data, data.length(), rowsMatrix, colsMatrix, matrix)) {
+        return;
+    }
+
+    if (isSquareOnly && rowsMatrix != colsMatrix) {
+        Nan::ThrowTypeError("Wrong arguments - matrix must be square");
+        return;
+    }
+
+    size_t bytes = rowsMatrix * colsMatrix * sizeof(T);
+    if (matrix.transposed) {
+        Factorization<Decomposition>::NewInstance(info, className, matrix.Stored().transpose(), bytes, errorMessage);
+    }
+    else {
+        Factorization<Decomposition>::NewInstance(info, className, matrix.Stored(), bytes, errorMessage);
+    }
+}
+
+template <template <typename> class Decomposition>
+static void Factorize(const Nan::FunctionCallbackInfo<v8::Value>& info, const char *className,
+                      bool isSquareOnly, const char *errorMessage){
+    if (info[0]->IsFloat32Array()) {
+        FactorizeImpl<Decomposition<MatrixX<float> > >(info, className, isSquareOnly, errorMessage);
+    }
+    else if (info[0]->IsFloat64Array()) {
+        FactorizeImpl<Decomposition<MatrixX<double> > >(info, className, isSquareOnly, errorMessage);
+    }
+    else {
+        Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array");
+    }
+}
+
+template <typename M> using LUDecomposition = Eigen::PartialPivLU<M>;
+template <typename M> using QRDecomposition = Eigen::HouseholderQR<M>;
+template <typename M> using LLTDecomposition = Eigen::LLT<M>;
+template <typename M> using LDLTDecomposition = Eigen::LDLT<M>;
+
+NAN_METHOD(LU){
+    Factorize<LUDecomposition>(info, "LU", true, "LU decomposition failed");
+}
+
+NAN_METHOD(QR){
+    Factorize<QRDecomposition>(info, "QR", false, "QR decomposition failed");
+}
+
+NAN_METHOD(CholeskyFactor){
+    Factorize<LLTDecomposition>(info, "LLT", true, "Matrix is not positive definite");
+}
+
+NAN_METHOD(LDLT){
+    Factorize<LDLTDecomposition>(info, "LDLT", true, "Matrix is not positive or negative semidefinite");
+}
+
+/**
+  *  GramAccumulator:
+  *  Accumulates the Gram matrix X' * X, the column means and the covariance of a data matrix X of d columns
+  *  fed in chunks of rows, in O(d^2) memory whatever the number of rows. Each chunk is centered on its own
+  *  mean and added to the lower triangle of the scatter matrix by a symmetric rank-k update (SYRK, half the
+  *  flops of the general product), then merged with the previous rows by the pairwise update of Chan et al.:
+  *  S = S_a + S_b + n_a * n_b / n * (mean_b - mean_a) * (mean_b - mean_a)'. This keeps the covariance
+  *  accurate for data far from zero, and X' * X = S + n * mean * mean'. Sums are kept in double precision.
+  *
+  *  JS methods:
+  *  add(chunk, rowMajor): adds the rows of chunk, a Float64Array or Float32Array of whole rows of d elements,
+  *                        stored row after row when rowMajor is true and column-major (a numjs.Matrix) otherwise.
+  *  count(): the number of rows added.
+  *  gramInto(out), covarianceInto(out, ddof), correlationInto(out): write the full symmetric d x d matrix into out,
+  *                        a Float64Array or Float32Array of d * d elements. The covariance is divided by
+  *                        count - ddof, the correlation of a column with no variance is NaN.
+  *  meanInto(out): writes the d column means into out.
+  *  reset(): forgets every row.
+*/
+class GramAccumulator : public Nan::ObjectWrap {
+public:
+    static void NewInstance(const Nan::FunctionCallbackInfo<v8::Value>& info, size_t d){
+        if (constructor.IsEmpty()) {
+            v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>();
+            tpl->SetClassName(Nan::New("GramAccumulator").ToLocalChecked());
+            tpl->InstanceTemplate()->SetInternalFieldCount(1);
+            Nan::SetPrototypeMethod(tpl, "add", Add);
+            Nan::SetPrototypeMethod(tpl, "count", Count);
+            Nan::SetPrototypeMethod(tpl, "gramInto", GramInto);
+            Nan::SetPrototypeMethod(tpl, "covarianceInto", CovarianceInto);
+            Nan::SetPrototypeMethod(tpl, "correlationInto", CorrelationInto);
+            Nan::SetPrototypeMethod(tpl, "meanInto", MeanInto);
+            Nan::SetPrototypeMethod(tpl, "reset", Reset);
+            constructor.Reset(Nan::GetFunction(tpl).ToLocalChecked());
+        }
+
+        v8::Local<v8::Object> instance = Nan::NewInstance(Nan::New(constructor)).ToLocalChecked();
+        GramAccumulator *accumulator = new GramAccumulator(d);
+        accumulator->Wrap(instance);
+        info.GetReturnValue().Set(instance);
+    }
+
+private:
+    GramAccumulator(size_t d) : d(d), rows(0), mean(Eigen::VectorXd::Zero(d)), scatter(Eigen::MatrixXd::Zero(d, d)) {
+        Nan::AdjustExternalMemory(d * d * sizeof(double));
+    }
+
+    ~GramAccumulator() {
+        Nan::AdjustExternalMemory(-(int64_t)(d * d * sizeof(double)));
+    }
+
+    template <typename T>
+    void AddKernel(const T *data, size_t chunkRows, bool rowMajor){
+        if (chunkRows == 0) {
+            return;
+        }
+
+        // the chunk as d x chunkRows, one row of X per column
+        Eigen::MatrixXd centered;
+        if (rowMajor) {
+            centered = Eigen::Map <const MatrixX<T> > (data, d, chunkRows).template cast<double>();
+        }
+        else {
+            centered = Eigen::Map <const MatrixX<T> > (data, chunkRows, d).transpose().template cast<double>();
+        }
+
+        Eigen::VectorXd chunkMean = centered.rowwise().mean();
+        centered.colwise() -= chunkMean;
+        scatter.selfadjointView<Eigen::Lower>().rankUpdate(centered);
+
+        double total = rows + (double)chunkRows;
+        Eigen::VectorXd delta = chunkMean - mean;
+        scatter.selfadjointView<Eigen::Lower>().rankUpdate(delta, rows * chunkRows / total);
+        mean += delta * (chunkRows / total);
+        rows = total;
+    }
+
+    // the full symmetric matrix from the lower triangle of the scatter matrix
+    Eigen::MatrixXd Scatter() const {
+        return scatter.selfadjointView<Eigen::Lower>();
+    }
+
+    // writes result into info[0], false (with an exception thrown) when it is not a typed array of length elements
+    static bool WriteResult(const Nan::FunctionCallbackInfo<v8::Value>& info, const Eigen::MatrixXd &result){
+        size_t length = result.size();
+        if (info.Length() > 0 && info[0]->IsFloat64Array() && Nan::TypedArrayContents<double>(info[0]).length() == length) {
+            Eigen::Map <Eigen::MatrixXd> (*(Nan::TypedArrayContents<double>(info[0])), result.rows(), result.cols()) = result;
+        }
+        else if (info.Length() > 0 && info[0]->IsFloat32Array() && Nan::TypedArrayContents<float>(info[0]).length() == length) {
+            Eigen::Map <Eigen::MatrixXf> (*(Nan::TypedArrayContents<float>(info[0])), result.rows(), result.cols()) = result.cast<float>();
+        }
+        else {
+            Nan::ThrowTypeError("Wrong arguments - out must be a Float64Array or Float32Array of the result size");
+            return false;
+        }
+
+        Local<Boolean> b = Nan::New(true);
+        info.GetReturnValue().Set(b);
+        return true;
+    }
+
+    static NAN_METHOD(Add){
+        GramAccumulator *self = Nan::ObjectWrap::Unwrap<GramAccumulator>(info.Holder());
+        bool rowMajor = info.Length() < 2 || info[1]->BooleanValue();
+
+        if (info.Length() > 0 && info[0]->IsFloat64Array()) {
+            Nan::TypedArrayContents<double> data(info[0]);
+            if (data.length() % self->d != 0) {
+                Nan::ThrowTypeError("Wrong arguments - the chunk must hold whole rows of d elements");
+                return;
+            }
+            self->AddKernel(*data, data.length() / self->d, rowMajor);
+        }
+        else if (info.Length() > 0 && info[0]->IsFloat32Array()) {
+            Nan::TypedArrayContents<float> data(info[0]);
+            if (data.length() % self->d != 0) {
+                Nan::ThrowTypeError("Wrong arguments - the chunk must hold whole rows of d elements");
+                return;
+            }
+            self->AddKernel(*data, data.length() / self->d, rowMajor);
+        }
+        else {
+            Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array");
+            return;
+        }
+
+        v8::Local<v8::Number> num = Nan::New(self->rows);
+        info.GetReturnValue().Set(num);
+    }
+
+    static NAN_METHOD(Count){
+        GramAccumulator *self = Nan::ObjectWrap::Unwrap<GramAccumulator>(info.Holder());
+        v8::Local<v8::Number> num = Nan::New(self->rows);
+        info.GetReturnValue().Set(num);
+    }
+
+    static NAN_METHOD(GramInto){
+        GramAccumulator *self = Nan::ObjectWrap::Unwrap<GramAccumulator>(info.Holder());
+        Eigen::MatrixXd gram = self->Scatter();
+        gram.noalias() += self->rows * self->mean * self->mean.transpose();
+        WriteResult(info, gram);
+    }
+
+    static NAN_METHOD(CovarianceInto){
+        GramAccumulator *self = Nan::ObjectWrap::Unwrap<GramAccumulator>(info.Holder());
+        double ddof = info.Length() > 1 && info[1]->IsNumber() ? info[1]->NumberValue() : 1;
+        if (self->rows <= ddof) {
+            Nan::ThrowRangeError("The covariance needs more rows than ddof");
+            return;
+        }
+
+        WriteResult(info, self->Scatter() / (self->rows - ddof));
+    }
+
+    static NAN_METHOD(CorrelationInto){
+        GramAccumulator *self = Nan::ObjectWrap::Unwrap<GramAccumulator>(info.Holder());
+        if (self->rows == 0) {
+            Nan::ThrowRangeError("The correlation needs at least one row");
+            return;
+        }
+
+        // the scale of the scatter matrix cancels out
+        Eigen::MatrixXd correlation = self->Scatter();
+        Eigen::VectorXd scale = correlation.diagonal().cwiseSqrt().cwiseInverse();
+        correlation = scale.asDiagonal() * correlation * scale.asDiagonal();
+        WriteResult(info, correlation);
+    }
+
+    static NAN_METHOD(MeanInto){
+        GramAccumulator *self = Nan::ObjectWrap::Unwrap<GramAccumulator>(info.Holder());
+        WriteResult(info, self->mean);
+    }
+
+    static NAN_METHOD(Reset){
+        GramAccumulator *self = Nan::ObjectWrap::Unwrap<GramAccumulator>(info.Holder());
+        self->rows = 0;
+        self->mean.setZero();
+        self->scatter.setZero();
+        Local<Boolean> b = Nan::New(true);
+        info.GetReturnValue().Set(b);
+    }
+
+    static Nan::Persistent<v8::Function> constructor;
+
+    size_t d;
+    double rows;
+    Eigen::VectorXd mean;
+    Eigen::MatrixXd scatter;
+};
+
+Nan::Persistent<v8::Function> GramAccumulator::constructor;
+
+/**
+  *  NewGramAccumulator:
+  *  Returns a new GramAccumulator.
+  *
+  *  arguments:
+  *  info[0]: Number d - the number of columns of the data.
+*/
+NAN_METHOD(NewGramAccumulator){
+    if (info.Length() < 1 || !info[0]->IsUint32() || info[0]->Uint32Value() == 0) {
+        Nan::ThrowTypeError("Wrong arguments - d must be a positive number");
+        return;
+    }
+
+    GramAccumulator::NewInstance(info, info[0]->Uint32Value());
+}
+
+/**
+  *  Sparse matrices:
+  *  A numjs.SparseMatrix is passed as six consecutive arguments (see ReadSparse): rows, cols, indptr (Int32Array
+  *  of outer size + 1 offsets into indices and values), indices (Int32Array of row indices for CSC, column indices
+  *  for CSR), values (Float64Array or Float32Array) and a Boolean which is true for CSR and false for CSC.
+  *  The buffers are mapped as an Eigen::SparseMatrix without copying, so memory and time scale with the number
+  *  of nonzeros.
+*/
+template <typename T>
+struct SparseArgs {
+    using CSC = Eigen::Map <const Eigen::SparseMatrix<T, Eigen::ColMajor, int> >;
+    using CSR = Eigen::Map <const Eigen::SparseMatrix<T, Eigen::RowMajor, int> >;
+
+    size_t rows, cols;
+    const int *indptr;
+    const int *indices;
+    const T *values;
+    int nnz;
+    bool isCsr;
+
+    CSC Csc() const { return CSC(rows, cols, nnz, indptr, indices, values); }
+    CSR Csr() const { return CSR(rows, cols, nnz, indptr, indices, values); }
+};
+
+template <typename T>
+static bool ReadSparse(const Nan::FunctionCallbackInfo<v8::Value>& info, int index, SparseArgs<T> &sparse){
+    if (info.Length() < index + 6 || !info[index]->IsUint32() || !info[index + 1]->IsUint32() ||
+        !info[index + 2]->IsInt32Array() || !info[index + 3]->IsInt32Array() || !ScalarArray<T>::Is(info[index + 4])) {
+        Nan::ThrowTypeError("Wrong arguments - expected rows, cols, Int32Array indptr and indices and the values");
+        return false;
+    }
+
+    Nan::TypedArrayContents<int32_t> indptr(info[index + 2]);
+    Nan::TypedArrayContents<int32_t> indices(info[index + 3]);
+    Nan::TypedArrayContents<T> values(info[index + 4]);
+    sparse.rows = info[index]->Uint32Value();
+    sparse.cols = info[index + 1]->Uint32Value();
+    sparse.isCsr = info[index + 5]->BooleanValue();
+
+    size_t outer = sparse.isCsr ? sparse.rows : sparse.cols;
+    if (indptr.length() != outer + 1 || (*indptr)[0] != 0 || (*indptr)[outer] < 0 ||
+        (size_t)(*indptr)[outer] > indices.length() || (size_t)(*indptr)[outer] > values.length()) {
+        Nan::ThrowTypeError("Wrong arguments - malformed sparse matrix");
+        return false;
+    }
+
+    sparse.indptr = *indptr;
+    sparse.indices = *indices;
+    sparse.values = *values;
+    sparse.nnz = (*indptr)[outer];
+    return true;
+}
+
+// wraps a compressed sparse matrix as {indptr, indices, values} typed arrays
+template <typename T, int Options>
+static v8::Local<v8::Object> NewSparseObject(const Eigen::SparseMatrix<T, Options, int> &matrix){
+    size_t outer = matrix.outerSize(), nnz = matrix.nonZeros();
+    v8::Local<v8::Int32Array> indptr = v8::Int32Array::New(
+        v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), (outer + 1) * sizeof(int32_t)), 0, outer + 1);
+    v8::Local<v8::Int32Array> indices = v8::Int32Array::New(
+        v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), nnz * sizeof(int32_t)), 0, nnz);
+    v8::Local<v8::Value> values = ScalarArray<T>::New(nnz);
+
+    std::copy(matrix.outerIndexPtr(), matrix.outerIndexPtr() + outer + 1, *(Nan::TypedArrayContents<int32_t>(indptr)));
+    std::copy(matrix.innerIndexPtr(), matrix.innerIndexPtr() + nnz, *(Nan::TypedArrayContents<int32_t>(indices)));
+    std::copy(matrix.valuePtr(), matrix.valuePtr() + nnz, *(Nan::TypedArrayContents<T>(values)));
+
+    v8::Local<v8::Object> result = Nan::New<v8::Object>();
+    Nan::Set(result, Nan::New("indptr").ToLocalChecked(), indptr);
+    Nan::Set(result, Nan::New("indices").ToLocalChecked(), indices);
+    Nan::Set(result, Nan::New("values").ToLocalChecked(), values);
+    return result;
+}
+
+/**
+  *  SparseFromTriplets:
+  *  Builds a compressed sparse matrix from (row, col, value) triplets, duplicates are summed.
+  *
+  *  arguments:
+  *  info[0]: Number represent the number of rows of the matrix.
+  *  info[1]: Number represent the number of columns of the matrix.
+  *  info[2]: Int32Array of the row index of every triplet.
+  *  info[3]: Int32Array of the column index of every triplet.
+  *  info[4]: Float64Array or Float32Array of the value of every triplet.
+  *  info[5]: Boolean - true for CSR, false for CSC.
+  *
+  *  Return value: {indptr, indices, values}.
+*/
+template <typename T>
+static void SparseFromTripletsImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info.Length() < 6 || !info[0]->IsUint32() || !info[1]->IsUint32() ||
+        !info[2]->IsInt32Array() || !info[3]->IsInt32Array() || !ScalarArray<T>::Is(info[4])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    int rows(info[0]->Uint32Value());
+    int cols(info[1]->Uint32Value());
+    Nan::TypedArrayContents<int32_t> rowIndices(info[2]);
+    Nan::TypedArrayContents<int32_t> colIndices(info[3]);
+    Nan::TypedArrayContents<T> values(info[4]);
+
+    if (rowIndices.length() != values.length() || colIndices.length() != values.length()) {
+        Nan::ThrowTypeError("Wrong arguments - the triplet arrays must have the same length");
+        return;
+    }
+
+    std::vector<Eigen::Triplet<T, int> > triplets;
+    triplets.reserve(values.length());
+    for (size_t i = 0; i < values.length(); i++) {
+        int row = (*rowIndices)[i], col = (*colIndices)[i];
+        if (row < 0 || row >= rows || col < 0 || col >= cols) {
+            Nan::ThrowRangeError("Triplet index out of range");
+            return;
+        }
+        triplets.push_back(Eigen::Triplet<T, int>(row, col, (*values)[i]));
+    }
+
+    if (info[5]->BooleanValue()) {
+        Eigen::SparseMatrix<T, Eigen::RowMajor, int> matrix(rows, cols);
+        matrix.setFromTriplets(triplets.begin(), triplets.end());
+        info.GetReturnValue().Set(NewSparseObject(matrix));
+    }
+    else {
+        Eigen::SparseMatrix<T, Eigen::ColMajor, int> matrix(rows, cols);
+        matrix.setFromTriplets(triplets.begin(), triplets.end());
+        info.GetReturnValue().Set(NewSparseObject(matrix));
+    }
+}
+
+NAN_METHOD(SparseFromTriplets){
+    if (info[4]->IsFloat32Array()) {
+        SparseFromTripletsImpl<float>(info);
+    }
+    else {
+        SparseFromTripletsImpl<double>(info);
+    }
+}
+
+/**
+  *  SparseDenseMul, DenseSparseMul:
+  *  Sparse times dense and dense times sparse products, the result is dense.
+  *
+  *  arguments (SparseDenseMul):
+  *  info[0] - info[5]: the sparse left matrix S (see ReadSparse).
+  *  info[6]: Number represent the number of columns of the dense right matrix (its rows are S.cols).
+  *  info[7]: Buffer(object created by Float64Array or Float32Array) represent the dense right matrix.
+  *  info[8]: Buffer(object created by Float64Array or Float32Array) for return value, S.rows x info[6].
+  *
+  *  arguments (DenseSparseMul):
+  *  info[0]: Number represent the number of rows of the dense left matrix (its cols are S.rows).
+  *  info[1]: Buffer(object created by Float64Array or Float32Array) represent the dense left matrix.
+  *  info[2] - info[7]: the sparse right matrix S (see ReadSparse).
+  *  info[8]: Buffer(object created by Float64Array or Float32Array) for return value, info[0] x S.cols.
+*/
+template <typename T>
+static void SparseDenseMulImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    SparseArgs<T> sparse;
+    if (!ReadSparse(info, 0, sparse)) {
+        return;
+    }
+
+    if (!info[6]->IsUint32() || !ScalarArray<T>::Is(info[7]) || !ScalarArray<T>::Is(info[8])) {
+        Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+        return;
+    }
+
+    size_t denseCols(info[6]->Uint32Value());
+    const T *denseData = *(Nan::TypedArrayContents<T>(info[7]));
+    T *resRawData = *(Nan::TypedArrayContents<T>(info[8]));
+    CMd dense(denseData, sparse.cols, denseCols);
+    Md res(resRawData, sparse.rows, denseCols);
+
+    // the products write straight into res, which must not be the dense input
+    if (Overlaps<T>(resRawData, sparse.rows * denseCols, denseData, sparse.cols * denseCols)) {
+        MatrixX<T> temp = sparse.isCsr ? MatrixX<T>(sparse.Csr() * dense) : MatrixX<T>(sparse.Csc() * dense);
+        res = temp;
+    }
+    else if (sparse.isCsr) {
+        res.noalias() = sparse.Csr() * dense;
+    }
+    else {
+        res.noalias() = sparse.Csc() * dense;
+    }
+
+    info.GetReturnValue().Set(Nan::New(true));
+}
+
+NAN_METHOD(SparseDenseMul){
+    if (info[8]->IsFloat32Array()) {
+        SparseDenseMulImpl<float>(info);
+    }
+    else {
+        SparseDenseMulImpl<double>(info);
+    }
+}
+
+template <typename T>
+static void DenseSparseMulImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    SparseArgs<T> sparse;
+    if (!ReadSparse(info, 2, sparse)) {
+        return;
+    }
+
+    if (!info[0]->IsUint32() || !ScalarArray<T>::Is(info[1]) || !ScalarArray<T>::Is(info[8])) {
+        Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+        return;
+    }
+
+    size_t denseRows(info[0]->Uint32Value());
+    const T *denseData = *(Nan::TypedArrayContents<T>(info[1]));
+    T *resRawData = *(Nan::TypedArrayContents<T>(info[8]));
+    CMd dense(denseData, denseRows, sparse.rows);
+    Md res(resRawData, denseRows, sparse.cols);
+
+    if (Overlaps<T>(resRawData, denseRows * sparse.cols, denseData, denseRows * sparse.rows)) {
+        MatrixX<T> temp = sparse.isCsr ? MatrixX<T>(dense * sparse.Csr()) : MatrixX<T>(dense * sparse.Csc());
+        res = temp;
+    }
+    else if (sparse.isCsr) {
+        res.noalias() = dense * sparse.Csr();
+    }
+    else {
+        res.noalias() = dense * sparse.Csc();
+    }
+
+    info.GetReturnValue().Set(Nan::New(true));
+}
+
+NAN_METHOD(DenseSparseMul){
+    if (info[8]->IsFloat32Array()) {
+        DenseSparseMulImpl<float>(info);
+    }
+    else {
+        DenseSparseMulImpl<double>(info);
+    }
+}
+
+/**
+  *  SparseSparseMul:
+  *  Sparse times sparse product, the result is sparse.
+  *
+  *  arguments:
+  *  info[0] - info[5]: the left sparse matrix A (see ReadSparse).
+  *  info[6] - info[11]: the right sparse matrix B.
+  *  info[12]: Boolean - true for a CSR result, false for CSC.
+  *
+  *  Return value: {indptr, indices, values} of A * B.
+*/
+template <typename Result, typename T>
+static void SparseSparseMulKernel(const SparseArgs<T> &left, const SparseArgs<T> &right, Result &res){
+    if (left.isCsr && right.isCsr) {
+        res = left.Csr() * right.Csr();
+    }
+    else if (left.isCsr) {
+        res = left.Csr() * right.Csc();
+    }
+    else if (right.isCsr) {
+        res = left.Csc() * right.Csr();
+    }
+    else {
+        res = left.Csc() * right.Csc();
+    }
+    res.makeCompressed();
+}
+
+template <typename T>
+static void SparseSparseMulImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    SparseArgs<T> left, right;
+    if (!ReadSparse(info, 0, left) || !ReadSparse(info, 6, right)) {
+        return;
+    }
+
+    if (left.cols != right.rows) {
+        Nan::ThrowTypeError("Wrong arguments - A.cols must equal B.rows");
+        return;
+    }
+
+    if (info.Length() > 12 && info[12]->BooleanValue()) {
+        Eigen::SparseMatrix<T, Eigen::RowMajor, int> res;
+        SparseSparseMulKernel(left, right, res);
+        info.GetReturnValue().Set(NewSparseObject(res));
+    }
+    else {
+        Eigen::SparseMatrix<T, Eigen::ColMajor, int> res;
+        SparseSparseMulKernel(left, right, res);
+        info.GetReturnValue().Set(NewSparseObject(res));
+    }
+}
+
+NAN_METHOD(SparseSparseMul){
+    if (info[4]->IsFloat32Array()) {
+        SparseSparseMulImpl<float>(info);
+    }
+    else {
+        SparseSparseMulImpl<double>(info);
+    }
+}
+
+/**
+  *  SparseLLT, SparseLDLT, SparseLU:
+  *  Sparse direct solvers, returned as the same Factorization objects as the dense LU, QR, CholeskyFactor and
+  *  LDLT (rcond() is NaN, Eigen has no sparse condition estimator). SimplicialLLT and SimplicialLDLT read the
+  *  lower triangle of a symmetric matrix and reorder it with AMD, SparseLU handles any square matrix with
+  *  COLAMD ordering. The memory reported to V8 is the size of the input, the fill-in of the factors is not
+  *  known up front.
+  *
+  *  arguments:
+  *  info[0] - info[5]: the sparse matrix to factorize (see ReadSparse), it must be square.
+*/
+template <typename Decomposition>
+static void SparseFactorizeImpl(const Nan::FunctionCallbackInfo<v8::Value>& info, const char *className,
+                                const char *errorMessage){
+    using T = typename Decomposition::MatrixType::Scalar;
+
+    SparseArgs<T> sparse;
+    if (!ReadSparse(info, 0, sparse)) {
+        return;
+    }
+
+    if (sparse.rows != sparse.cols || sparse.rows == 0) {
+        Nan::ThrowTypeError("Wrong arguments - matrix must be square");
+        return;
+    }
+
+    // the solvers take a compressed column-major matrix, CSR input is converted (CSC is copied as is)
+    Eigen::SparseMatrix<T, Eigen::ColMajor, int> matrix;
+    if (sparse.isCsr) {
+        matrix = sparse.Csr();
+    }
+    else {
+        matrix = sparse.Csc();
+    }
+
+    size_t bytes = sparse.nnz * (sizeof(T) + sizeof(int)) + (sparse.cols + 1) * sizeof(int);
+    Factorization<Decomposition>::NewInstance(info, className, matrix, bytes, errorMessage);
+}
+
+template <template <typename> class Decomposition>
+static void SparseFactorize(const Nan::FunctionCallbackInfo<v8::Value>& info, const char *className,
+                            const char *errorMessage){
+    if (info[4]->IsFloat32Array()) {
+        SparseFactorizeImpl<Decomposition<Eigen::SparseMatrix<float, Eigen::ColMajor, int> > >(info, className, errorMessage);
+    }
+    else {
+        SparseFactorizeImpl<Decomposition<Eigen::SparseMatrix<double, Eigen::ColMajor, int> > >(info, className, errorMessage);
+    }
+}
+
+template <typename M> using SparseLLTDecomposition = Eigen::SimplicialLLT<M>;
+template <typename M> using SparseLDLTDecomposition = Eigen::SimplicialLDLT<M>;
+template <typename M> using SparseLUDecomposition = Eigen::SparseLU<M, Eigen::COLAMDOrdering<int> >;
+
+NAN_METHOD(SparseLLT){
+    SparseFactorize<SparseLLTDecomposition>(info, "SparseLLT", "Matrix is not positive definite");
+}
+
+NAN_METHOD(SparseLDLT){
+    SparseFactorize<SparseLDLTDecomposition>(info, "SparseLDLT", "Matrix is not positive or negative semidefinite");
+}
+
+NAN_METHOD(SparseLU){
+    SparseFactorize<SparseLUDecomposition>(info, "SparseLU", "Matrix is singular");
+}
+
+/**
+  *  Iterative solvers:
+  *  ConjugateGradient (symmetric positive definite A, both triangles are read), BiCGSTAB (any square A) and
+  *  LeastSquaresConjugateGradient (any A, minimizes |A * x - b|), all with a diagonal preconditioner.
+  *  Every iteration costs one product with A, so a sparse A costs O(nonzeros) per iteration instead of the
+  *  O(n^3) of a direct solve, and the caller trades accuracy for latency with the tolerance and the
+  *  iteration cap. A is a dense matrix (IterativeSolve) or a sparse one (SparseIterativeSolve).
+  *
+  *  arguments shared by both bindings, starting at index (see ReadIterativeArgs):
+  *  info[index]: Buffer(object created by Float64Array or Float32Array) represent b, A.rows elements.
+  *  info[index + 1]: Buffer(object created by Float64Array or Float32Array) for return value x, A.cols elements.
+  *                   Holds the initial guess when info[index + 4] is true.
+  *  info[index + 2]: Number represent the relative tolerance |A * x - b| / |b|, 0 for the Eigen default.
+  *  info[index + 3]: Number represent the maximum number of iterations, 0 for the Eigen default (2 * A.cols).
+  *  info[index + 4]: Boolean - true to start from the values of x instead of zeros.
+  *
+  *  Return value: {converged, iterations, error}, error is the achieved relative residual.
+*/
+enum IterativeMethod { kConjugateGradient = 0, kBiCGSTAB = 1, kLeastSquaresConjugateGradient = 2 };
+
+template <typename T>
+struct IterativeArgs {
+    const T *b;
+    T *x;
+    size_t lengthB, lengthX;
+    T tolerance;
+    int maxIterations;
+    bool useGuess;
+};
+
+template <typename T>
+static bool ReadIterativeArgs(const Nan::FunctionCallbackInfo<v8::Value>& info, int index, size_t rows, size_t cols,
+                              IterativeArgs<T> &args){
+    if (info.Length() < index + 5 || !ScalarArray<T>::Is(info[index]) || !ScalarArray<T>::Is(info[index + 1]) ||
+        !info[index + 2]->IsNumber() || !info[index + 3]->IsUint32()) {
+        Nan::ThrowTypeError("Wrong arguments - expected b, x, tolerance and max iterations");
+        return false;
+    }
+
+    Nan::TypedArrayContents<T> b(info[index]);
+    Nan::TypedArrayContents<T> x(info[index + 1]);
+    if (b.length() != rows || x.length() != cols) {
+        Nan::ThrowTypeError("Wrong arguments - b must have A.rows elements and x A.cols elements");
+        return false;
+    }
+
+    args.b = *b;
+    args.x = *x;
+    args.lengthB = b.length();
+    args.lengthX = x.length();
+    args.tolerance = (T)info[index + 2]->NumberValue();
+    args.maxIterations = info[index + 3]->Uint32Value();
+    args.useGuess = info[index + 4]->BooleanValue();
+    return true;
+}
+
+template <typename Solver, typename Input, typename T>
+static v8::Local<v8::Object> IterativeSolveKernel(const Input &matrix, const IterativeArgs<T> &args){
+    using CMVd = Eigen::Map <const VectorX<T> >;
+    using MVd = Eigen::Map <VectorX<T> >;
+
+    Solver solver;
+    if (args.tolerance > 0) {
+        solver.setTolerance(args.tolerance);
+    }
+    if (args.maxIterations > 0) {
+        solver.setMaxIterations(args.maxIterations);
+    }
+    solver.compute(matrix);
+
+    // the solvers iterate in x and read b on every iteration, so b is copied when x overlaps it
+    VectorX<T> copyB;
+    const T *dataB = args.b;
+    if (Overlaps(args.b, args.lengthB, (const T *)args.x, args.lengthX)) {
+        copyB = CMVd(args.b, args.lengthB);
+        dataB = copyB.data();
+    }
+    CMVd b(dataB, args.lengthB);
+
+    MVd x(args.x, args.lengthX);
+    if (args.useGuess) {
+        VectorX<T> guess = x;
+        x = solver.solveWithGuess(b, guess);
+    }
+    else {
+        x = solver.solve(b);
+    }
+
+    v8::Local<v8::Object> result = Nan::New<v8::Object>();
+    Nan::Set(result, Nan::New("converged").ToLocalChecked(), Nan::New(solver.info() == Eigen::Success));
+    Nan::Set(result, Nan::New("iterations").ToLocalChecked(), Nan::New((double)solver.iterations()));
+    Nan::Set(result, Nan::New("error").ToLocalChecked(), Nan::New((double)solver.error()));
+    return result;
+}
+
+// M is the matrix type the solver is instantiated on, Input a map of the same storage order which it reads in place
+template <typename M, typename Input, typename T>
+static void IterativeSolveDispatch(const Nan::FunctionCallbackInfo<v8::Value>& info, int method,
+                                   const Input &matrix, const IterativeArgs<T> &args){
+    if (method != kLeastSquaresConjugateGradient && matrix.rows() != matrix.cols()) {
+        Nan::ThrowTypeError("Wrong arguments - matrix must be square, use the least squares solver otherwise");
+        return;
+    }
+
+    switch (method) {
+    case kConjugateGradient:
+        info.GetReturnValue().Set(IterativeSolveKernel<Eigen::ConjugateGradient<M, Eigen::Lower | Eigen::Upper> >(matrix, args));
+        break;
+    case kBiCGSTAB:
+        info.GetReturnValue().Set(IterativeSolveKernel<Eigen::BiCGSTAB<M> >(matrix, args));
+        break;
+    case kLeastSquaresConjugateGradient:
+        info.GetReturnValue().Set(IterativeSolveKernel<Eigen::LeastSquaresConjugateGradient<M> >(matrix, args));
+        break;
+    default:
+        Nan::ThrowTypeError("Wrong arguments - unknown iterative method");
+    }
+}
+
+/**
+  *  IterativeSolve:
+  *  info[0]: Number represent the method, 0 ConjugateGradient, 1 BiCGSTAB, 2 LeastSquaresConjugateGradient.
+  *  info[1]: Number represent the number of rows of A.
+  *  info[2]: Number represent the number of columns of A.
+  *  info[3]: Buffer(object created by Float64Array or Float32Array) represent A.
+  *  info[4] - info[8]: b, x, tolerance, max iterations and the warm start flag (see ReadIterativeArgs).
+  *  info[9], info[10]: optional - the ld and transposed of a view A (see ReadView).
+*/
+template <typename T>
+static void IterativeSolveImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info.Length() < 9 || !info[0]->IsUint32() || !info[1]->IsUint32() || !info[2]->IsUint32() ||
+        !ScalarArray<T>::Is(info[3])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    int method(info[0]->Uint32Value());
+    size_t rows(info[1]->Uint32Value());
+    size_t cols(info[2]->Uint32Value());
+    Nan::TypedArrayContents<T> contents(info[3]);
+
+    StridedView<T> matrix;
+    IterativeArgs<T> args;
+    if (!ReadView(info, 9, *contents, contents.length(), rows, cols, matrix) ||
+        !ReadIterativeArgs(info, 4, rows, cols, args)) {
+        return;
+    }
+
+    // the solvers keep a reference to a strided A, only a transposed view is copied
+    if (matrix.transposed) {
+        IterativeSolveDispatch<MatrixX<T> >(info, method, matrix.Stored().transpose(), args);
+    }
+    else {
+        IterativeSolveDispatch<MatrixX<T> >(info, method, matrix.Stored(), args);
+    }
+}
+
+NAN_METHOD(IterativeSolve){
+    if (info[3]->IsFloat32Array()) {
+        IterativeSolveImpl<float>(info);
+    }
+    else {
+        IterativeSolveImpl<double>(info);
+    }
+}
+
+/**
+  *  SparseIterativeSolve:
+  *  info[0]: Number represent the method, 0 ConjugateGradient, 1 BiCGSTAB, 2 LeastSquaresConjugateGradient.
+  *  info[1] - info[6]: the sparse matrix A (see ReadSparse), read in place in its own storage order.
+  *  info[7] - info[11]: b, x, tolerance, max iterations and the warm start flag (see ReadIterativeArgs).
+*/
+template <typename T>
+static void SparseIterativeSolveImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (!info[0]->IsUint32()) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    int method(info[0]->Uint32Value());
+    SparseArgs<T> sparse;
+    IterativeArgs<T> args;
+    if (!ReadSparse(info, 1, sparse) || !ReadIterativeArgs(info, 7, sparse.rows, sparse.cols, args)) {
+        return;
+    }
+
+    if (sparse.isCsr) {
+        IterativeSolveDispatch<Eigen::SparseMatrix<T, Eigen::RowMajor, int> >(info, method, sparse.Csr(), args);
+    }
+    else {
+        IterativeSolveDispatch<Eigen::SparseMatrix<T, Eigen::ColMajor, int> >(info, method, sparse.Csc(), args);
+    }
+}
+
+NAN_METHOD(SparseIterativeSolve){
+    if (info[5]->IsFloat32Array()) {
+        SparseIterativeSolveImpl<float>(info);
+    }
+    else {
+        SparseIterativeSolveImpl<double>(info);
+    }
+}
+
+/**
+  *  Top eigenpairs:
+  *  The k largest (or smallest) eigenpairs of a symmetric matrix by the thick restart Lanczos method: a Krylov
+  *  basis of ncv vectors is built with one product with A per vector, the Ritz pairs of the projected matrix
+  *  are extracted, and the best ones are kept as the start of the next basis until the k wanted residuals
+  *  |A * x - value * x| drop below tol * max |value|. Memory is n * (ncv + 1) besides A, and A is only used
+  *  in products, so a sparse A costs O(nonzeros) per step. A is dense (TopEigen) or sparse (SparseTopEigen).
+  *
+  *  arguments shared by both bindings, starting at index (see ReadTopEigenArgs):
+  *  info[index]: Number represent k, 0 < k < n.
+  *  info[index + 1]: Boolean - true for the largest eigenvalues, false for the smallest.
+  *  info[index + 2]: Number represent ncv, the size of the Krylov basis, k < ncv <= n.
+  *  info[index + 3]: Number represent tol, 0 for the Eigen dummy precision of the dtype.
+  *  info[index + 4]: Number represent the maximum number of restarts.
+  *  info[index + 5]: Buffer(object created by Float64Array or Float32Array) for the k eigenvalues, the wanted
+  *                   end of the spectrum first.
+  *  info[index + 6]: Buffer(object created by Float64Array or Float32Array) for the n x k eigenvectors, or null
+  *                   to skip them.
+  *
+  *  Return value: {converged, iterations}, iterations is the number of restarts.
+*/
+// one step of the Lanczos process with full reorthogonalization: extends the basis with A * v_j and fills column j of
+// the projected matrix, returns the norm of the new residual (0 when the Krylov subspace became invariant)
+template <typename T, typename Operator>
+static T LanczosStep(const Operator &matrix, MatrixX<T> &basis, MatrixX<T> &projected, int j, std::minstd_rand &random){
+    VectorX<T> w = matrix * basis.col(j);
+
+    // twice is enough (Kahan), the projection onto the basis so far is column j of V' * A * V
+    VectorX<T> h = basis.leftCols(j + 1).transpose() * w;
+    w.noalias() -= basis.leftCols(j + 1) * h;
+    VectorX<T> correction = basis.leftCols(j + 1).transpose() * w;
+    w.noalias() -= basis.leftCols(j + 1) * correction;
+    h += correction;
+
+    projected.col(j).head(j + 1) = h;
+    projected.row(j).head(j + 1) = h.transpose();
+
+    T beta = w.norm();
+    if (beta <= Eigen::NumTraits<T>::epsilon() * std::max(h.norm(), T(1))) {
+        // invariant subspace, continue from a random vector orthogonal to the basis, uncoupled from it
+        std::uniform_real_distribution<double> uniform(-1, 1);
+        for (Eigen::Index i = 0; i < w.size(); i++) {
+            w[i] = (T)uniform(random);
+        }
+        for (int pass = 0; pass < 2; pass++) {
+            w.noalias() -= basis.leftCols(j + 1) * (basis.leftCols(j + 1).transpose() * w);
+        }
+        basis.col(j + 1) = w.normalized();
+        return 0;
+    }
+
+    basis.col(j + 1) = w / beta;
+    return beta;
+}
+
+// returns the number of restarts, -1 when maxRestarts was reached without converging
+template <typename T, typename Operator>
+static int TopEigenKernel(const Operator &matrix, int k, bool largest, int ncv, T tol, int maxRestarts,
+                          T *resValues, T *resVectors){
+    using MVd = Eigen::Map <VectorX<T> >;
+
+    Eigen::Index n = matrix.rows();
+    MatrixX<T> basis = MatrixX<T>::Zero(n, ncv + 1);
+    MatrixX<T> projected = MatrixX<T>::Zero(ncv, ncv);
+    std::minstd_rand random(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    for (Eigen::Index i = 0; i < n; i++) {
+        basis(i, 0) = (T)uniform(random);
+    }
+    basis.col(0).normalize();
+
+    // the number of Ritz vectors kept across a restart, more than k helps the wanted ones converge
+    int keep = std::min(k + (ncv - k) / 2, ncv - 1);
+    int start = 0;
+    for (int restart = 0; ; restart++) {
+        T beta = 0;
+        // the coupling beta of v_j to v_j+1 is filled in by the projection of step j + 1, the last one is the residual
+        for (int j = start; j < ncv; j++) {
+            beta = LanczosStep(matrix, basis, projected, j, random);
+        }
+
+        Eigen::SelfAdjointEigenSolver<MatrixX<T> > eigenSolver(projected);
+        const VectorX<T> &theta = eigenSolver.eigenvalues();
+        const MatrixX<T> &ritz = eigenSolver.eigenvectors();
+
+        // the eigenvalues come in increasing order, order[i] is the index of the i-th wanted one
+        std::vector<int> order(ncv);
+        for (int i = 0; i < ncv; i++) {
+            order[i] = largest ? ncv - 1 - i : i;
+        }
+
+        T scale = std::max(std::abs(theta[0]), std::abs(theta[ncv - 1]));
+        bool converged = true;
+        for (int i = 0; i < k && converged; i++) {
+            converged = std::abs(beta * ritz(ncv - 1, order[i])) <= tol * std::max(scale, T(1e-30));
+        }
+
+        if (converged || restart >= maxRestarts) {
+            for (int i = 0; i < k; i++) {
+                resValues[i] = theta[order[i]];
+                if (resVectors) {
+                    MVd(resVectors + i * n, n) = basis.leftCols(ncv) * ritz.col(order[i]);
+                }
+            }
+            return converged ? restart : -1;
+        }
+
+        // thick restart: the kept Ritz vectors and the residual vector start the next basis, the projected
+        // matrix becomes diag(theta) bordered by the couplings beta * s of the Ritz vectors to the residual
+        MatrixX<T> selected(ncv, keep);
+        for (int i = 0; i < keep; i++) {
+            selected.col(i) = ritz.col(order[i]);
+        }
+        MatrixX<T> kept = basis.leftCols(ncv) * selected;
+        basis.col(keep) = basis.col(ncv);
+        basis.leftCols(keep) = kept;
+
+        projected.setZero();
+        for (int i = 0; i < keep; i++) {
+            projected(i, i) = theta[order[i]];
+        }
+        start = keep;
+    }
+}
+
+template <typename T>
+struct TopEigenArgs {
+    int k;
+    bool largest;
+    int ncv;
+    T tol;
+    int maxRestarts;
+    T *values;
+    T *vectors;
+};
+
+template <typename T>
+static bool ReadTopEigenArgs(const Nan::FunctionCallbackInfo<v8::Value>& info, int index, size_t n,
+                             TopEigenArgs<T> &args){
+    if (info.Length() < index + 6 || !info[index]->IsUint32() || !info[index + 2]->IsUint32() ||
+        !info[index + 3]->IsNumber() || !info[index + 4]->IsUint32() || !ScalarArray<T>::Is(info[index + 5])) {
+        Nan::ThrowTypeError("Wrong arguments - expected k, largest, ncv, tol, max restarts and the eigenvalue buffer");
+        return false;
+    }
+
+    args.k = info[index]->Uint32Value();
+    args.largest = info[index + 1]->BooleanValue();
+    args.ncv = info[index + 2]->Uint32Value();
+    args.tol = (T)info[index + 3]->NumberValue();
+    args.maxRestarts = info[index + 4]->Uint32Value();
+    if (args.k == 0 || (size_t)args.k >= n || args.ncv <= args.k || (size_t)args.ncv > n) {
+        Nan::ThrowRangeError("k and ncv must satisfy 0 < k < ncv <= n and k < n");
+        return false;
+    }
+    if (args.tol <= 0) {
+        args.tol = Eigen::NumTraits<T>::dummy_precision();
+    }
+
+    Nan::TypedArrayContents<T> values(info[index + 5]);
+    if (values.length() != (size_t)args.k) {
+        Nan::ThrowTypeError("Wrong arguments - the eigenvalue buffer must have k elements");
+        return false;
+    }
+    args.values = *values;
+    args.vectors = nullptr;
+
+    if (info.Length() > index + 6 && ScalarArray<T>::Is(info[index + 6])) {
+        Nan::TypedArrayContents<T> vectors(info[index + 6]);
+        if (vectors.length() != n * args.k) {
+            Nan::ThrowTypeError("Wrong arguments - the eigenvector buffer must have n * k elements");
+            return false;
+        }
+        args.vectors = *vectors;
+    }
+    return true;
+}
+
+template <typename T, typename Operator>
+static void TopEigenDispatch(const Nan::FunctionCallbackInfo<v8::Value>& info, const Operator &matrix,
+                             const TopEigenArgs<T> &args){
+    int restarts = TopEigenKernel(matrix, args.k, args.largest, args.ncv, args.tol, args.maxRestarts,
+                                  args.values, args.vectors);
+
+    v8::Local<v8::Object> result = Nan::New<v8::Object>();
+    Nan::Set(result, Nan::New("converged").ToLocalChecked(), Nan::New(restarts >= 0));
+    Nan::Set(result, Nan::New("iterations").ToLocalChecked(), Nan::New(restarts >= 0 ? restarts : args.maxRestarts));
+    info.GetReturnValue().Set(result);
+}
+
+/**
+  *  TopEigen:
+  *  info[0]: Number represent the number of rows of A.
+  *  info[1]: Number represent the number of columns of A, A must be square.
+  *  info[2]: Buffer(object created by Float64Array or Float32Array) represent the symmetric A.
+  *  info[3] - info[9]: k, largest, ncv, tol, max restarts and the result buffers (see ReadTopEigenArgs).
+  *  info[10], info[11]: optional - the ld and transposed of a view A (see ReadView).
+*/
+template <typename T>
+static void TopEigenImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    if (info.Length() < 9 || !info[0]->IsUint32() || !info[1]->IsUint32() || !ScalarArray<T>::Is(info[2])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    size_t rows(info[0]->Uint32Value());
+    size_t cols(info[1]->Uint32Value());
+    Nan::TypedArrayContents<T> contents(info[2]);
+    if (rows != cols) {
+        Nan::ThrowTypeError("Wrong arguments - matrix must be square");
+        return;
+    }
+
+    StridedView<T> matrix;
+    TopEigenArgs<T> args;
+    if (!ReadView(info, 10, *contents, contents.length(), rows, cols, matrix) ||
+        !ReadTopEigenArgs(info, 3, rows, args)) {
+        return;
+    }
+
+    // the products read a view in place
+    if (matrix.transposed) {
+        TopEigenDispatch(info, matrix.Stored().transpose(), args);
+    }
+    else {
+        TopEigenDispatch(info, matrix.Stored(), args);
+    }
+}
+
+NAN_METHOD(TopEigen){
+    if (info[2]->IsFloat32Array()) {
+        TopEigenImpl<float>(info);
+    }
+    else {
+        TopEigenImpl<double>(info);
+    }
+}
+
+/**
+  *  SparseTopEigen:
+  *  info[0] - info[5]: the symmetric sparse matrix A (see ReadSparse).
+  *  info[6] - info[12]: k, largest, ncv, tol, max restarts and the result buffers (see ReadTopEigenArgs).
+*/
+template <typename T>
+static void SparseTopEigenImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    SparseArgs<T> sparse;
+    TopEigenArgs<T> args;
+    if (!ReadSparse(info, 0, sparse)) {
+        return;
+    }
+
+    if (sparse.rows != sparse.cols) {
+        Nan::ThrowTypeError("Wrong arguments - matrix must be square");
+        return;
+    }
+
+    if (!ReadTopEigenArgs(info, 6, sparse.rows, args)) {
+        return;
+    }
+
+    if (sparse.isCsr) {
+        TopEigenDispatch(info, sparse.Csr(), args);
+    }
+    else {
+        TopEigenDispatch(info, sparse.Csc(), args);
+    }
+}
+
+NAN_METHOD(SparseTopEigen){
+    if (info[4]->IsFloat32Array()) {
+        SparseTopEigenImpl<float>(info);
+    }
+    else {
+        SparseTopEigenImpl<double>(info);
+    }
+}
+
+/**
+  *  Expression evaluation:
+  *  numjs.linalg.js builds an expression tree (linalg.expr) and ships it here as a prefix program, so
+  *  compound formulas such as A*B + s*C run in one call without JS side temporaries.
+  *  Each node of the program starts with its opcode:
+  *    kExprLeaf, leaf index, rows, cols, ld - a matrix from the leaves array, ld apart columns (see StridedView)
+  *    kExprAdd / kExprSub / kExprMul, left node, right node - sum, difference and matrix product
+  *    kExprScale, scalar, node - the node multiplied by a scalar
+  *    kExprTranspose, node
+  *  The tree is flattened into a sum of scaled terms. Products are computed with GEMM straight into the
+  *  result (alpha folds the scalars, transposed leaves are read in place), then the plain matrices are
+  *  added in passes of up to three at once. Only operands which are neither a leaf nor a transposed
+  *  leaf, such as (A + B) * C, are evaluated into a temporary.
+*/
+enum ExprOp { kExprLeaf = 0, kExprAdd = 1, kExprSub = 2, kExprMul = 3, kExprScale = 4, kExprTranspose = 5 };
+
+template <typename T>
+struct ExprNode {
+    int op;
+    int left, right;
+    T scalar;
+    const T *data;
+    size_t rows, cols;
+    size_t ld;
+};
+
+template <typename T>
+static int ParseExpr(const double *program, size_t length, size_t &pos,
+                     const std::vector<const T *> &leafData, const std::vector<size_t> &leafLengths,
+                     std::vector<ExprNode<T> > &nodes){
+    if (pos >= length) {
+        return -1;
+    }
+
+    ExprNode<T> node = {(int)program[pos++], -1, -1, 1, nullptr, 0, 0, 0};
+    switch (node.op) {
+        case kExprLeaf: {
+            if (pos + 4 > length) {
+                return -1;
+            }
+            size_t leaf = (size_t)program[pos];
+            node.rows = (size_t)program[pos + 1];
+            node.cols = (size_t)program[pos + 2];
+            node.ld = (size_t)program[pos + 3];
+            pos += 4;
+            if (leaf >= leafData.size() || node.ld < node.rows ||
+                (node.cols > 0 && node.ld * (node.cols - 1) + node.rows > leafLengths[leaf])) {
+                return -1;
+            }
+            node.data = leafData[leaf];
+            break;
+        }
+        case kExprAdd:
+        case kExprSub:
+        case kExprMul: {
+            node.left = ParseExpr(program, length, pos, leafData, leafLengths, nodes);
+            node.right = node.left < 0 ? -1 : ParseExpr(program, length, pos, leafData, leafLengths, nodes);
+            if (node.right < 0) {
+                return -1;
+            }
+            const ExprNode<T> &left = nodes[node.left], &right = nodes[node.right];
+            if (node.op == kExprMul ? left.cols != right.rows : left.rows != right.rows || left.cols != right.cols) {
+                return -1;
+            }
+            node.rows = left.rows;
+            node.cols = node.op == kExprMul ? right.cols : left.cols;
+            break;
+        }
+        case kExprScale:
+        case kExprTranspose: {
+            if (node.op == kExprScale) {
+                if (pos >= length) {
+                    return -1;
+                }
+                node.scalar = (T)program[pos++];
+            }
+            node.left = ParseExpr(program, length, pos, leafData, leafLengths, nodes);
+            if (node.left < 0) {
+                return -1;
+            }
+            node.rows = node.op == kExprScale ? nodes[node.left].rows : nodes[node.left].cols;
+            node.cols = node.op == kExprScale ? nodes[node.left].cols : nodes[node.left].rows;
+            break;
+        }
+        default:
+            return -1;
+    }
+
+    nodes.push_back(node);
+    return (int)nodes.size() - 1;
+}
+
+template <typename T>
+class ExprEvaluator {
+public:
+    using CMd = Eigen::Map <const MatrixX<T>, 0, Eigen::OuterStride<> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    explicit ExprEvaluator(const std::vector<ExprNode<T> > &nodes) : nodes_(nodes) {}
+
+    void Evaluate(int index, Md &dst){
+        std::vector<Term> terms;
+        CollectTerms(index, 1, terms);
+
+        bool accumulate = false;
+        for (size_t i = 0; i < terms.size(); i++) {
+            if (nodes_[terms[i].node].op == kExprMul) {
+                ProductTerm(terms[i], dst, accumulate);
+                accumulate = true;
+            }
+        }
+
+        // reserved up front, a reallocation would move the temporaries the operands point into
+        std::vector<Operand> operands(terms.size());
+        size_t count = 0;
+        for (size_t i = 0; i < terms.size(); i++) {
+            if (nodes_[terms[i].node].op != kExprMul) {
+                Resolve(terms[i].node, operands[count]);
+                operands[count++].factor *= terms[i].factor;
+            }
+        }
+
+        for (size_t i = 0; i < count; ) {
+            size_t passSize = 0;
+            while (i + passSize < count && passSize < 3 && !operands[i + passSize].transposed) {
+                passSize++;
+            }
+
+            if (passSize == 0) {
+                Store(dst, operands[i].factor * Map(operands[i]).transpose(), accumulate);
+                passSize = 1;
+            }
+            else if (passSize == 1) {
+                Store(dst, operands[i].factor * Map(operands[i]), accumulate);
+            }
+            else if (passSize == 2) {
+                Store(dst, operands[i].factor * Map(operands[i]) + operands[i + 1].factor * Map(operands[i + 1]), accumulate);
+            }
+            else {
+                Store(dst, operands[i].factor * Map(operands[i]) + operands[i + 1].factor * Map(operands[i + 1]) +
+                    operands[i + 2].factor * Map(operands[i + 2]), accumulate);
+            }
+
+            accumulate = true;
+            i += passSize;
+        }
+    }
+
+private:
+    struct Term {
+        T factor;
+        int node;
+    };
+
+    // a matrix read in place (a leaf, possibly transposed) or evaluated into temp
+    struct Operand {
+        T factor;
+        const T *data;
+        size_t rows, cols;
+        size_t ld;
+        bool transposed;
+        MatrixX<T> temp;
+    };
+
+    void CollectTerms(int index, T factor, std::vector<Term> &terms){
+        const ExprNode<T> &node = nodes_[index];
+        switch (node.op) {
+            case kExprAdd:
+            case kExprSub:
+                CollectTerms(node.left, factor, terms);
+                CollectTerms(node.right, node.op == kExprSub ? -factor : factor, terms);
+                break;
+            case kExprScale:
+                CollectTerms(node.left, factor * node.scalar, terms);
+                break;
+            default:
+                terms.push_back({factor, index});
+        }
+    }
+
+    void Resolve(int index, Operand &operand){
+        operand.factor = 1;
+        while (nodes_[index].op == kExprScale) {
+            operand.factor *= nodes_[index].scalar;
+            index = nodes_[index].left;
+        }
+
+        operand.transposed = nodes_[index].op == kExprTranspose;
+        if (operand.transposed) {
+            index = nodes_[index].left;
+        }
+
+        const ExprNode<T> &node = nodes_[index];
+        operand.rows = node.rows;
+        operand.cols = node.cols;
+        if (node.op == kExprLeaf) {
+            operand.data = node.data;
+            operand.ld = node.ld;
+        }
+        else {
+            operand.temp.resize(node.rows, node.cols);
+            Md temp(operand.temp.data(), node.rows, node.cols);
+            Evaluate(index, temp);
+            operand.data = operand.temp.data();
+            operand.ld = node.rows;
+        }
+    }
+
+    static CMd Map(const Operand &operand){
+        return CMd(operand.data, operand.rows, operand.cols, Eigen::OuterStride<>(operand.ld));
+    }
+
+    template <typename Expression>
+    static void Store(Md &dst, const Expression &value, bool accumulate){
+        if (accumulate) {
+            dst += value;
+        }
+        else {
+            dst = value;
+        }
+    }
+
+    template <typename Left, typename Right>
+    static void Product(Md &dst, T alpha, const Left &left, const Right &right, bool accumulate){
+        if (accumulate) {
+            dst.noalias() += alpha * left * right;
+        }
+        else {
+            dst.noalias() = alpha * left * right;
+        }
+    }
+
+    void ProductTerm(const Term &term, Md &dst, bool accumulate){
+        Operand left, right;
+        Resolve(nodes_[term.node].left, left);
+        Resolve(nodes_[term.node].right, right);
+        T alpha = term.factor * left.factor * right.factor;
+
+        if (left.transposed && right.transposed) {
+            Product(dst, alpha, Map(left).transpose(), Map(right).transpose(), accumulate);
+        }
+        else if (left.transposed) {
+            Product(dst, alpha, Map(left).transpose(), Map(right), accumulate);
+        }
+        else if (right.transposed) {
+            Product(dst, alpha, Map(left), Map(right).transpose(), accumulate);
+        }
+        else {
+            Product(dst, alpha, Map(left), Map(right), accumulate);
+        }
+    }
+
+    const std::vector<ExprNode<T> > &nodes_;
+};
+
+/**
+  *  EvalExpr:
+  *  Evaluates an expression program (see ExprEvaluator) into a matrix.
+  *
+  *  arguments:
+  *  info[0]: Float64Array holding the prefix program.
+  *  info[1]: Array of the leaf buffers (Float64Array or Float32Array, all of the type of info[4]).
+  *  info[2]: Number represent the number of rows of the result.
+  *  info[3]: Number represent the number of columns of the result.
+  *  info[4]: Buffer(object created by Float64Array or Float32Array) for return value, may be one of the leaves.
+*/
+template <typename T>
+static void EvalExprImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    if (info.Length() < 5) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[0]->IsFloat64Array() || !info[1]->IsArray() || !info[2]->IsNumber() || !info[3]->IsNumber() ||
+        !ScalarArray<T>::Is(info[4])) {
+        Nan::ThrowTypeError("Wrong arguments");
+        return;
+    }
+
+    Local<Array> leaves = Local<Array>::Cast(info[1]);
+    std::vector<const T *> leafData;
+    std::vector<size_t> leafLengths;
+    for (uint32_t i = 0; i < leaves->Length(); i++) {
+        Local<Value> leaf = leaves->Get(i);
+        if (!ScalarArray<T>::Is(leaf)) {
+            Nan::ThrowTypeError("Wrong arguments - expected Float64Array or Float32Array buffers of one type");
+            return;
+        }
+        Nan::TypedArrayContents<T> contents(leaf);
+        leafData.push_back(*contents);
+        leafLengths.push_back(contents.length());
+    }
+
+    Nan::TypedArrayContents<double> program(info[0]);
+    size_t rows(info[2]->Uint32Value());
+    size_t cols(info[3]->Uint32Value());
+    std::vector<ExprNode<T> > nodes;
+    size_t pos = 0;
+    int root = ParseExpr(*program, program.length(), pos, leafData, leafLengths, nodes);
+    if (root < 0 || pos != program.length() || nodes[root].rows != rows || nodes[root].cols != cols) {
+        Nan::ThrowTypeError("Malformed expression");
+        return;
+    }
+
+    Nan::TypedArrayContents<T> resContents(info[4]);
+    if (resContents.length() < rows * cols) {
+        Nan::ThrowTypeError("Wrong arguments - the output buffer is too small");
+        return;
+    }
+
+    ExprEvaluator<T> evaluator(nodes);
+    Md res(*resContents, rows, cols);
+    bool aliased = false;
+    for (size_t i = 0; i < leafData.size(); i++) {
+        aliased = aliased || Overlaps<T>(*resContents, rows * cols, leafData[i], leafLengths[i]);
+    }
+
+    if (aliased) {
+        MatrixX<T> temp(rows, cols);
+        Md tempMap(temp.data(), rows, cols);
+        evaluator.Evaluate(root, tempMap);
+        res = temp;
+    }
+    else {
+        evaluator.Evaluate(root, res);
+    }
+
+    info.GetReturnValue().Set(Nan::New(true));
+}
+
+NAN_METHOD(EvalExpr){
+    if (info[4]->IsFloat32Array()) {
+        EvalExprImpl<float>(info);
+    }
+    else {
+        EvalExprImpl<double>(info);
+    }
+}
+
+/**
+  *  Alloc:
+  *  Allocates the storage of a numjs.Matrix natively, 64 byte aligned (see AlignedAlloc). The memory is
+  *  owned by the returned typed array and released when it is garbage collected.
+  *
+  *  arguments:
+  *  info[0]: Number represent the number of elements.
+  *  info[1]: Boolean - true for a Float32Array, false for a Float64Array.
+  *  info[2]: Optional - Number every element is set to. Without it the elements are left uninitialized.
+  *
+  *  Return value: a Float64Array or Float32Array of info[0] elements.
+*/
+template <typename T>
+static void AllocImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    size_t length(info[0]->Uint32Value());
+    size_t bytes = length * sizeof(T);
+
+    char *data = AlignedAlloc(bytes);
+    if (data == nullptr) {
+        Nan::ThrowError("Out of memory");
+        return;
+    }
+
+    if (info.Length() > 2 && info[2]->IsNumber()) {
+        FillKernel(reinterpret_cast<T *>(data), length, (T)info[2]->NumberValue());
+    }
+
+    v8::Local<v8::Object> buffer = Nan::NewBuffer(data, bytes, AlignedFree, nullptr).ToLocalChecked();
+    info.GetReturnValue().Set(ScalarArray<T>::New(buffer.As<v8::Uint8Array>()->Buffer(), length));
+}
+
+NAN_METHOD(Alloc){
+    if (info.Length() < 2) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[0]->IsUint32()) {
+        Nan::ThrowTypeError("Wrong argument given, should be a number");
+        return;
+    }
+
+    if (info[1]->BooleanValue()) {
+        AllocImpl<float>(info);
+    }
+    else {
+        AllocImpl<double>(info);
+    }
+}
+
+/**
+  *  MapFile:
+  *  Maps a region of a file (the data of a .npy file) into memory copy on write and wraps it as a typed array
+  *  without reading it: pages are loaded from the file the first time they are touched, writes go to private
+  *  copies and never reach the file. The mapping is released when the typed array is garbage collected.
+  *
+  *  arguments:
+  *  info[0]: String - the path of the file.
+  *  info[1]: Number - the byte offset of the region, a multiple of the element size.
+  *  info[2]: Number represent the number of elements of the region.
+  *  info[3]: Boolean - true for a Float32Array, false for a Float64Array.
+  *
+  *  Return value: a Float64Array or Float32Array of info[2] elements.
+*/
+// how MapRegion maps a file: private pages for map_file, shared ones for the operands and result of mat_mul_tiled
+enum MapMode { kMapCopyOnWrite, kMapRead, kMapReadWrite };
+
+#ifdef _WIN32
+static void UnmapRegion(char *data, size_t length){
+    UnmapViewOfFile(data);
+}
+
+// writes the dirty pages of [begin, end) back to the file, the system trims the working set by itself
+static void ReleaseRegion(char *data, size_t begin, size_t end, bool flush){
+    if (flush && end > begin) {
+        FlushViewOfFile(data + begin, end - begin);
+    }
+}
+
+// the start of the view, offset rounded down to the allocation granularity, or nullptr on failure (including a file
+// shorter than offset + bytes, whose missing pages would fault when touched)
+static char *MapRegion(const char *path, double offset, size_t bytes, MapMode mode, size_t *mapStart){
+    if (offset < 0) {
+        return nullptr;
+    }
+
+    SYSTEM_INFO system;
+    GetSystemInfo(&system);
+    *mapStart = (size_t)offset - (size_t)offset % system.dwAllocationGranularity;
+
+    wchar_t widePath[MAX_PATH];
+    if (MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath, MAX_PATH) == 0) {
+        return nullptr;
+    }
+    DWORD access = mode == kMapReadWrite ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    HANDLE file = CreateFileW(widePath, access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart < (uint64_t)offset + bytes) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    DWORD protect = mode == kMapCopyOnWrite ? PAGE_WRITECOPY : mode == kMapRead ? PAGE_READONLY : PAGE_READWRITE;
+    HANDLE mapping = CreateFileMappingW(file, nullptr, protect, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+
+    uint64_t start = *mapStart;
+    DWORD viewAccess = mode == kMapCopyOnWrite ? FILE_MAP_COPY : mode == kMapRead ? FILE_MAP_READ : FILE_MAP_WRITE;
+    void *view = MapViewOfFile(mapping, viewAccess, (DWORD)(start >> 32), (DWORD)start, (size_t)offset - *mapStart + bytes);
+    CloseHandle(mapping);
+    return static_cast<char *>(view);
+}
+#else
+static void UnmapRegion(char *data, size_t length){
+    munmap(data, length);
+}
+
+// writes the dirty pages of [begin, end) back to the file when flush is set and drops the whole pages of the
+// range from the process, so a pass over a mapping larger than the memory does not keep it resident
+static void ReleaseRegion(char *data, size_t begin, size_t end, bool flush){
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    begin -= begin % page;
+    end -= end % page;
+    if (end <= begin) {
+        return;
+    }
+    if (flush) {
+        msync(data + begin, end - begin, MS_SYNC);
+    }
+    madvise(data + begin, end - begin, MADV_DONTNEED);
+}
+
+// the start of the mapping, offset rounded down to a page, or nullptr on failure (including a file shorter than
+// offset + bytes, touching the pages past its end would raise SIGBUS)
+static char *MapRegion(const char *path, double offset, size_t bytes, MapMode mode, size_t *mapStart){
+    if (offset < 0) {
+        return nullptr;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    *mapStart = (size_t)offset - (size_t)offset % page;
+
+    int fd = open(path, mode == kMapReadWrite ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (uint64_t)status.st_size < (uint64_t)offset + bytes) {
+        close(fd);
+        return nullptr;
+    }
+    int protect = mode == kMapRead ? PROT_READ : PROT_READ | PROT_WRITE;
+    void *data = mmap(nullptr, (size_t)offset - *mapStart + bytes, protect, mode == kMapCopyOnWrite ? MAP_PRIVATE : MAP_SHARED,
+                      fd, (off_t)*mapStart);
+    close(fd);
+    return data == MAP_FAILED ? nullptr : static_cast<char *>(data);
+}
+#endif
+
+// free callback of the map_file buffers, hint is the length of the mapping
+static void UnmapFree(char *data, void *hint){
+    UnmapRegion(data, reinterpret_cast<uintptr_t>(hint));
+}
+
+// a region of a file mapped for the duration of a native call
+template <typename T>
+class MappedRegion {
+public:
+    MappedRegion(const char *path, double offset, size_t length, MapMode mode) : length(length * sizeof(T)) {
+        base = MapRegion(path, offset, this->length, mode, &mapStart);
+        skip = (size_t)offset - mapStart;
+    }
+    ~MappedRegion() {
+        if (base != nullptr) {
+            UnmapRegion(base, skip + length);
+        }
+    }
+
+    bool ok() const { return base != nullptr; }
+    T *data() const { return reinterpret_cast<T *>(base + skip); }
+
+    // releases the elements [begin, end) of the region, see ReleaseRegion
+    void release(size_t begin, size_t end, bool flush) const {
+        ReleaseRegion(base, skip + begin * sizeof(T), skip + end * sizeof(T), flush);
+    }
+
+private:
+    char *base;
+    size_t length, mapStart, skip;
+};
+
+template <typename T>
+static void MapFileImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    Nan::Utf8String path(info[0]);
+    double offset = info[1]->NumberValue();
+    size_t length(info[2]->Uint32Value());
+    size_t bytes = length * sizeof(T), mapStart;
+
+    if (offset < 0 || std::fmod(offset, (double)sizeof(T)) != 0 || length == 0) {
+        Nan::ThrowRangeError("The region must be non empty and start at a multiple of the element size");
+        return;
+    }
+
+    char *data = MapRegion(*path, offset, bytes, kMapCopyOnWrite, &mapStart);
+    if (data == nullptr) {
+        Nan::ThrowError((std::string("Could not map ") + *path + " - missing, or shorter than the region").c_str());
+        return;
+    }
+
+    size_t mapBytes = (size_t)offset - mapStart + bytes;
+    v8::Local<v8::Object> buffer = Nan::NewBuffer(data, mapBytes, UnmapFree, reinterpret_cast<void *>(mapBytes)).ToLocalChecked();
+    info.GetReturnValue().Set(ScalarArray<T>::New(buffer.As<v8::Uint8Array>()->Buffer(), length, (size_t)offset - mapStart));
+}
+
+NAN_METHOD(MapFile){
+    if (info.Length() < 4) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[0]->IsString() || !info[1]->IsNumber() || !info[2]->IsUint32()) {
+        Nan::ThrowTypeError("Wrong arguments given, should be a path, a byte offset and a number of elements");
+        return;
+    }
+
+    if (info[3]->BooleanValue()) {
+        MapFileImpl<float>(info);
+    }
+    else {
+        MapFileImpl<double>(info);
+    }
+}
+
+/**
+  *  MatMulTiled:
+  *  Out-of-core product C = A * B of matrices stored in files (the data of .npy files), which do not have to fit
+  *  in memory. A, B and C are mapped rather than read; C is computed one panel of tile columns at a time, each
+  *  tile x tile block of the panel by Eigen's GEMM over the tile x tile blocks of A and B. Once a panel is done
+  *  its pages of C are written back and its pages of B and C are dropped from the process, so only one panel of
+  *  C is dirty at a time and the rest is clean file cache. The blocks of a panel are spread across the threads set by
+  *  set_num_threads, each of them running a single threaded GEMM.
+  *
+  *  arguments:
+  *  info[0]: String - the path of the file holding A.
+  *  info[1]: Number - the byte offset of the elements of A in the file.
+  *  info[2]: Boolean - whether A is stored row-major (C order) rather than column-major.
+  *  info[3], info[4], info[5]: the same for B.
+  *  info[6]: String - the path of the file receiving C, it must be large enough already. C is stored column-major.
+  *  info[7]: Number - the byte offset of the elements of C in the file.
+  *  info[8]: Number represent the number of rows of A and C.
+  *  info[9]: Number represent the number of columns of A and rows of B.
+  *  info[10]: Number represent the number of columns of B and C.
+  *  info[11]: Number represent the tile size.
+  *  info[12]: Boolean - true for float32 elements, false for float64.
+*/
+// the block (row, col, rows, cols) of a matrix stored column-major, or row-major as its transpose
+template <bool RowMajor>
+struct StoredBlock {
+    template <typename Stored>
+    static auto get(const Stored &stored, Eigen::Index row, Eigen::Index col, Eigen::Index rows, Eigen::Index cols)
+        -> decltype(stored.block(row, col, rows, cols)) {
+        return stored.block(row, col, rows, cols);
+    }
+};
+
+template <>
+struct StoredBlock<true> {
+    template <typename Stored>
+    static auto get(const Stored &stored, Eigen::Index row, Eigen::Index col, Eigen::Index rows, Eigen::Index cols)
+        -> decltype(stored.block(col, row, cols, rows).transpose()) {
+        return stored.block(col, row, cols, rows).transpose();
+    }
+};
+
+template <bool RowMajorA, bool RowMajorB, typename T>
+static void MatMulTiledKernel(const MappedRegion<T> &a, const MappedRegion<T> &b, const MappedRegion<T> &c,
+                              size_t rows, size_t inner, size_t cols, size_t tile){
+    using CMd = Eigen::Map <const MatrixX<T> >;
+    using Md = Eigen::Map <MatrixX<T> >;
+
+    CMd storedA(a.data(), RowMajorA ? inner : rows, RowMajorA ? rows : inner);
+    CMd storedB(b.data(), RowMajorB ? cols : inner, RowMajorB ? inner : cols);
+    Md res(c.data(), rows, cols);
+    int rowTiles = (int)((rows + tile - 1) / tile);
+
+    for (size_t col = 0; col < cols; col += tile) {
+        size_t panelCols = std::min(tile, cols - col);
+
+        #pragma omp parallel for schedule(dynamic) num_threads(Eigen::nbThreads())
+        for (int rowTile = 0; rowTile < rowTiles; rowTile++) {
+            size_t row = rowTile * tile, blockRows = std::min(tile, rows - row);
+            auto block = res.block(row, col, blockRows, panelCols);
+
+            for (size_t k = 0; k < inner; k += tile) {
+                size_t depth = std::min(tile, inner - k);
+                auto left = StoredBlock<RowMajorA>::get(storedA, row, k, blockRows, depth);
+                auto right = StoredBlock<RowMajorB>::get(storedB, k, col, depth, panelCols);
+                if (k == 0) {
+                    block.noalias() = left * right;
+                }
+                else {
+                    block.noalias() += left * right;
+                }
+            }
+        }
+
+        // a column-major panel of C (or of B) is one contiguous range of the file, a row-major one of B is not
+        c.release(col * rows, (col + panelCols) * rows, true);
+        if (!RowMajorB) {
+            b.release(col * inner, (col + panelCols) * inner, false);
+        }
+    }
+}
+
+template <typename T>
+static void MatMulTiledImpl(const Nan::FunctionCallbackInfo<v8::Value>& info){
+    size_t rows(info[8]->Uint32Value());
+    size_t inner(info[9]->Uint32Value());
+    size_t cols(info[10]->Uint32Value());
+    size_t tile(info[11]->Uint32Value());
+    bool rowMajorA = info[2]->BooleanValue(), rowMajorB = info[5]->BooleanValue();
+
+    Nan::Utf8String pathA(info[0]), pathB(info[3]), pathC(info[6]);
+    MappedRegion<T> a(*pathA, info[1]->NumberValue(), rows * inner, kMapRead);
+    MappedRegion<T> b(*pathB, info[4]->NumberValue(), inner * cols, kMapRead);
+    MappedRegion<T> c(*pathC, info[7]->NumberValue(), rows * cols, kMapReadWrite);
+    if (!a.ok() || !b.ok() || !c.ok()) {
+        Nan::ThrowError("Could not map the operand and result files - missing, or shorter than the matrices");
+        return;
+    }
+
+    if (rowMajorA && rowMajorB) {
+        MatMulTiledKernel<true, true>(a, b, c, rows, inner, cols, tile);
+    }
+    else if (rowMajorA) {
+        MatMulTiledKernel<true, false>(a, b, c, rows, inner, cols, tile);
+    }
+    else if (rowMajorB) {
+        MatMulTiledKernel<false, true>(a, b, c, rows, inner, cols, tile);
+    }
+    else {
+        MatMulTiledKernel<false, false>(a, b, c, rows, inner, cols, tile);
+    }
+
+    info.GetReturnValue().Set(Nan::New(true));
+}
+
+NAN_METHOD(MatMulTiled){
+    if (info.Length() < 13) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[0]->IsString() || !info[3]->IsString() || !info[6]->IsString() ||
+        !info[1]->IsNumber() || !info[4]->IsNumber() || !info[7]->IsNumber()) {
+        Nan::ThrowTypeError("Wrong arguments given, should be paths and byte offsets");
+        return;
+    }
+
+    if (!info[8]->IsUint32() || !info[9]->IsUint32() || !info[10]->IsUint32() || !info[11]->IsUint32() ||
+        info[8]->Uint32Value() == 0 || info[9]->Uint32Value() == 0 || info[10]->Uint32Value() == 0 ||
+        info[11]->Uint32Value() == 0) {
+        Nan::ThrowRangeError("The dimensions and the tile size must be positive");
+        return;
+    }
+
+    if (info[12]->BooleanValue()) {
+        MatMulTiledImpl<float>(info);
+    }
+    else {
+        MatMulTiledImpl<double>(info);
+    }
+}
+
+/**
+  *  SetNumThreads:
+  *  Sets the number of threads Eigen uses for its parallel kernels (matrix products).
+  *  Only has an effect when the addon is built with OpenMP.
+  *
+  *  arguments:
+  *  info[0]: Number n - the number of threads, must be positive.
+*/
+NAN_METHOD(SetNumThreads){
+    if (info.Length() < 1) {
+        Nan::ThrowTypeError("Wrong number of arguments");
+        return;
+    }
+
+    if (!info[0]->IsUint32() || info[0]->Uint32Value() == 0) {
+        Nan::ThrowTypeError("Wrong argument given, should be a positive number");
+        return;
+    }
+
+    Eigen::setNbThreads(info[0]->Uint32Value());
+    Local<Boolean> b = Nan::New(true);
+    info.GetReturnValue().Set(b);
+}
+
+/**
+  *  GetNumThreads:
+  *  Return value: a Number represent the number of threads Eigen uses for its parallel kernels
+  *                (always 1 when the addon is built without OpenMP).
+*/
+NAN_METHOD(GetNumThreads){
+    v8::Local<v8::Number> num = Nan::New(Eigen::nbThreads());
+    info.GetReturnValue().Set(num);
+}
+
+/**
+  *  SimdInstructionSets:
+  *  Return value: a String naming the SIMD instruction sets Eigen's kernels were compiled for in this build of the
+  *                addon, e.g. "SSE, SSE2" for the baseline build and "AVX512, FMA, AVX2, AVX, SSE, ..." for the
+  *                AVX-512 one (see binding.gyp).
+*/
+NAN_METHOD(SimdInstructionSets){
+    info.GetReturnValue().Set(Nan::New(Eigen::SimdInstructionSetsInUse()).ToLocalChecked());
+}
+
+void Init(v8::Local<v8::Object> exports) {
+    // the async workers call into Eigen from several threadpool threads
+    Eigen::initParallel();
+
+	exports->Set(Nan::New("dot").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Dot)->GetFunction());
+	exports->Set(Nan::New("inner").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Inner)->GetFunction());
+	exports->Set(Nan::New("outer").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Outer)->GetFunction());
+	exports->Set(Nan::New("cholesky").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Cholesky)->GetFunction());
+	exports->Set(Nan::New("svd").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SVD)->GetFunction());
+	exports->Set(Nan::New("svd_k").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SVDK)->GetFunction());
+	exports->Set(Nan::New("lstsq").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Lstsq)->GetFunction());
+	exports->Set(Nan::New("pinv").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Pinv)->GetFunction());
+	exports->Set(Nan::New("matrix_power").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(MatrixPower)->GetFunction());
+	exports->Set(Nan::New("expm").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Expm)->GetFunction());
+	exports->Set(Nan::New("logm").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Logm)->GetFunction());
+	exports->Set(Nan::New("sqrtm").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Sqrtm)->GetFunction());
 	exports->Set(Nan::New("eye").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Eye)->GetFunction());
 	exports->Set(Nan::New("identity").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Identity)->GetFunction());
 	exports->Set(Nan::New("tri").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Tri)->GetFunction());
@@ -1116,8 +5327,50 @@ void Init(v8::Local<v8::Object> exports) {
     exports->Set(Nan::New("trace").ToLocalChecked(),	Nan::New<v8::FunctionTemplate>(Trace)->GetFunction());
     exports->Set(Nan::New("matrix_rank").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Rank)->GetFunction());
 	exports->Set(Nan::New("get_eigen_values").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(GetEigenValues)->GetFunction());
+	exports->Set(Nan::New("eigh").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Eigh)->GetFunction());
+	exports->Set(Nan::New("eig").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Eig)->GetFunction());
 	exports->Set(Nan::New("solve_linear_system_householder_qr").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SolveLinearSystemHouseholderQr)->GetFunction());
 	exports->Set(Nan::New("mat_mul").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(MatMul)->GetFunction());
+
+	exports->Set(Nan::New("inv_async").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(InverseAsync)->GetFunction());
+	exports->Set(Nan::New("cholesky_async").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(CholeskyAsync)->GetFunction());
+	exports->Set(Nan::New("svd_async").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SVDAsync)->GetFunction());
+	exports->Set(Nan::New("get_eigen_values_async").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(GetEigenValuesAsync)->GetFunction());
+	exports->Set(Nan::New("solve_linear_system_householder_qr_async").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SolveLinearSystemHouseholderQrAsync)->GetFunction());
+	exports->Set(Nan::New("mat_mul_async").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(MatMulAsync)->GetFunction());
+
+	exports->Set(Nan::New("mat_mul_batched").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(MatMulBatched)->GetFunction());
+	exports->Set(Nan::New("inv_batched").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(InverseBatched)->GetFunction());
+	exports->Set(Nan::New("det_batched").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(DetBatched)->GetFunction());
+	exports->Set(Nan::New("solve_batched").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SolveBatched)->GetFunction());
+
+	exports->Set(Nan::New("alloc").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(Alloc)->GetFunction());
+	exports->Set(Nan::New("map_file").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(MapFile)->GetFunction());
+	exports->Set(Nan::New("mat_mul_tiled").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(MatMulTiled)->GetFunction());
+	exports->Set(Nan::New("eval_expr").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(EvalExpr)->GetFunction());
+
+	exports->Set(Nan::New("lu").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(LU)->GetFunction());
+	exports->Set(Nan::New("qr").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(QR)->GetFunction());
+	exports->Set(Nan::New("cholesky_factor").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(CholeskyFactor)->GetFunction());
+	exports->Set(Nan::New("ldlt").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(LDLT)->GetFunction());
+	exports->Set(Nan::New("gram_accumulator").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(NewGramAccumulator)->GetFunction());
+
+	exports->Set(Nan::New("sparse_from_triplets").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SparseFromTriplets)->GetFunction());
+	exports->Set(Nan::New("sparse_dense_mul").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SparseDenseMul)->GetFunction());
+	exports->Set(Nan::New("dense_sparse_mul").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(DenseSparseMul)->GetFunction());
+	exports->Set(Nan::New("sparse_sparse_mul").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SparseSparseMul)->GetFunction());
+	exports->Set(Nan::New("sparse_llt").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SparseLLT)->GetFunction());
+	exports->Set(Nan::New("sparse_ldlt").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SparseLDLT)->GetFunction());
+	exports->Set(Nan::New("sparse_lu").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SparseLU)->GetFunction());
+
+	exports->Set(Nan::New("iterative_solve").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(IterativeSolve)->GetFunction());
+	exports->Set(Nan::New("sparse_iterative_solve").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SparseIterativeSolve)->GetFunction());
+	exports->Set(Nan::New("top_eigen").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(TopEigen)->GetFunction());
+	exports->Set(Nan::New("sparse_top_eigen").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SparseTopEigen)->GetFunction());
+
+	exports->Set(Nan::New("set_num_threads").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SetNumThreads)->GetFunction());
+	exports->Set(Nan::New("get_num_threads").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(GetNumThreads)->GetFunction());
+	exports->Set(Nan::New("simd_instruction_sets").ToLocalChecked(), Nan::New<v8::FunctionTemplate>(SimdInstructionSets)->GetFunction());
 }
 
 NODE_MODULE(addon, Init)
@@ -1,775 +1,3118 @@
-var linalg = require('./build/Release/numjs.linalg');
+/**
+ * binding.gyp builds the bindings once per instruction set: numjs.linalg (the compiler default, SSE2 on x86),
+ * numjs.linalg.avx2 and numjs.linalg.avx512, plus the numjs.linalg.cpu probe. The widest build the CPU and OS
+ * support is loaded, the NUMJS_LINALG_ISA environment variable (sse2, avx2 or avx512) asks for a narrower one.
+ * A build missing from build/Release (e.g. on other architectures) is skipped.
+ */
+var ISA_BUILDS = [
+    {isa: "avx512", suffix: ".avx512", requires: ["avx512f", "avx512dq", "avx512bw", "avx512vl", "avx2", "fma"]},
+    {isa: "avx2", suffix: ".avx2", requires: ["avx2", "fma"]},
+    {isa: "sse2", suffix: "", requires: []}
+];
+
+function loadNative() {
+    var features = {}, requested = process.env.NUMJS_LINALG_ISA, start = 0;
+
+    try {
+        features = require('./build/Release/numjs.linalg.cpu').cpu_features();
+    }
+    catch (e) {
+        // an older build without the probe, only the baseline build is safe
+        start = ISA_BUILDS.length - 1;
+    }
+
+    if (requested) {
+        var index = ISA_BUILDS.map(function (build) { return build.isa; }).indexOf(requested);
+        if (index === -1) {
+            throw new Error("NUMJS_LINALG_ISA must be one of sse2, avx2 or avx512");
+        }
+        start = Math.max(start, index);
+    }
+
+    for (var i = start; i < ISA_BUILDS.length; i++) {
+        var build = ISA_BUILDS[i];
+        if (build.requires.some(function (feature) { return !features[feature]; })) {
+            continue;
+        }
+
+        try {
+            return {isa: build.isa, suffix: build.suffix, features: features,
+                bindings: require('./build/Release/numjs.linalg' + build.suffix)};
+        }
+        catch (e) {
+            if (build.suffix === "") {
+                throw e;
+            }
+        }
+    }
+}
+
+var loaded = loadNative();
+var native = loaded.bindings;
+// the native bindings, an instrumented copy of them while stats are enabled (see numjs_linalg.enable_stats)
+var linalg = native;
+var fs = require('fs');
+var zlib = require('zlib');
+
+// the typed array behind Matrix.data for every supported dtype
+var dtypes = {float32: Float32Array, float64: Float64Array};
+
+// the dtype of a result computed from left and right, either of which may be a plain number
+function commonDtype(left, right) {
+    var leftDtype = left && left.dtype, rightDtype = right && right.dtype;
+
+    if (leftDtype && rightDtype && leftDtype !== rightDtype) {
+        throw new Error("The matrices must have the same dtype");
+    }
+
+    return leftDtype || rightDtype || "float64";
+}
+
+// array itself when it is a typed array of dtype, otherwise a natively allocated copy converted to dtype
+function asDtype(array, dtype) {
+    if (array instanceof dtypes[dtype]) {
+        return array;
+    }
+
+    var converted = allocData(array.length, dtype);
+    converted.set(array);
+    return converted;
+}
+
+function isFloatArray(array) {
+    return array instanceof Float64Array || array instanceof Float32Array;
+}
+
+// the out parameter of a wrapper, validated against the result shape, or a new uninitialized matrix when it is missing
+function outMatrix(out, rows, cols, dtype) {
+    if (out === undefined || out === null) {
+        return new numjs_linalg.Matrix([], rows, cols, {isEmpty: true, dtype: dtype});
+    }
+
+    if (!(out instanceof numjs_linalg.Matrix)) {
+        throw new Error("The out parameter is not instance of Matrix");
+    }
+
+    if (out.rows !== rows || out.cols !== cols) {
+        throw new Error("The out parameter must be a " + rows + "x" + cols + " matrix");
+    }
+
+    if (out.dtype !== dtype) {
+        throw new Error("The out parameter must have the same dtype as the input matrices");
+    }
+
+    if (!isDense(out)) {
+        throw new Error("The out parameter must be a dense matrix, not a view");
+    }
+
+    return out;
+}
+
+// same as outMatrix for the results returned as a typed array
+function outArray(out, length, dtype) {
+    if (out === undefined || out === null) {
+        return allocData(length, dtype);
+    }
+
+    if (!(out instanceof dtypes[dtype]) || out.length !== length) {
+        throw new Error("The out parameter must be a " + dtypes[dtype].name + " of " + length + " elements");
+    }
+
+    return out;
+}
+
+// the method argument of linalg.matrix_rank
+var RANK_METHODS = {svd: 0, qr: 1, lu: 2};
+
+// the algorithm argument of linalg.svd and linalg.svd_async
+var SVD_ALGORITHMS = {auto: 0, jacobi: 1, bdc: 2};
+
+function svdAlgorithm(algorithm) {
+    if (algorithm === undefined || algorithm === null) {
+        return SVD_ALGORITHMS.auto;
+    }
+    if (!SVD_ALGORITHMS.hasOwnProperty(algorithm)) {
+        throw new Error("algorithm must be 'auto', 'jacobi' or 'bdc'");
+    }
+    return SVD_ALGORITHMS[algorithm];
+}
+
+// the six arguments the native sparse functions take for a SparseMatrix
+function sparseArgs(matrix) {
+    return [matrix.rows, matrix.cols, matrix.indptr, matrix.indices, matrix.values, matrix.format === "csr"];
+}
+
+// the .npy descr of every supported dtype, see numjs_linalg.load
+var NPY_DESCRS = {"<f8": "float64", "<f4": "float32"};
+
+// files are read and written in chunks below the 2GB limit of a single fs.readSync / fs.writeSync call
+var IO_CHUNK = 1 << 30;
+
+function readAll(fd, bytes, position) {
+    for (var done = 0; done < bytes.length;) {
+        var read = fs.readSync(fd, bytes, done, Math.min(IO_CHUNK, bytes.length - done), position + done);
+        if (read === 0) {
+            throw new Error("Unexpected end of file");
+        }
+        done += read;
+    }
+    return bytes;
+}
+
+function writeAll(fd, bytes) {
+    for (var done = 0; done < bytes.length;) {
+        done += fs.writeSync(fd, bytes, done, Math.min(IO_CHUNK, bytes.length - done));
+    }
+}
+
+// the bytes of a typed array, without copying them
+function byteView(data) {
+    return Buffer.from(data.buffer, data.byteOffset, data.byteLength);
+}
+
+// the total length of a .npy header from its first 12 bytes (magic, version and header length)
+function npyHeaderLength(prefix) {
+    if (prefix.toString("latin1", 0, 6) !== "\x93NUMPY") {
+        throw new Error("Not a .npy file");
+    }
+    return prefix[6] === 1 ? 10 + prefix.readUInt16LE(8) : 12 + prefix.readUInt32LE(8);
+}
+
+// {dtype, fortranOrder, rows, cols, length} of the .npy header at the start of bytes, a one dimensional array is
+// read as a 1 x n vector
+function parseNpyHeader(bytes) {
+    var length = npyHeaderLength(bytes), dict = bytes.toString("latin1", 0, length),
+        descr = /'descr'\s*:\s*'([^']*)'/.exec(dict), fortranOrder = /'fortran_order'\s*:\s*(True|False)/.exec(dict),
+        shape = /'shape'\s*:\s*\(([^)]*)\)/.exec(dict);
+
+    if (!descr || !fortranOrder || !shape) {
+        throw new Error("Invalid .npy header");
+    }
+    if (!NPY_DESCRS.hasOwnProperty(descr[1])) {
+        throw new Error("Only little endian float64 ('<f8') and float32 ('<f4') .npy arrays are supported, got '" + descr[1] + "'");
+    }
+
+    var dims = shape[1].split(",").filter(function (dim) { return dim.trim() !== ""; }).map(Number);
+    if (dims.length > 2) {
+        throw new Error("Only one and two dimensional .npy arrays can be loaded as a Matrix");
+    }
+    dims = dims.length === 2 ? dims : dims.length === 1 ? [1, dims[0]] : [1, 1];
+    if (!(dims[0] > 0 && dims[1] > 0)) {
+        throw new Error("Empty .npy arrays can not be loaded as a Matrix");
+    }
+
+    return {dtype: NPY_DESCRS[descr[1]], fortranOrder: fortranOrder[1] === "True", rows: dims[0], cols: dims[1], length: length};
+}
+
+// the header of the .npy array stored at position of the open file
+function readNpyHeader(fd, position) {
+    var prefix = readAll(fd, Buffer.alloc(12), position);
+    return parseNpyHeader(readAll(fd, Buffer.alloc(npyHeaderLength(prefix)), position));
+}
+
+// a version 1.0 .npy header of a Fortran order array, padded with spaces and a newline so the data starts on a
+// 64 byte boundary
+function npyHeader(dtype, rows, cols) {
+    var dict = "{'descr': '" + (dtype === "float32" ? "<f4" : "<f8") + "', 'fortran_order': True, 'shape': (" +
+            rows + ", " + cols + "), }",
+        length = Math.ceil((10 + dict.length + 1) / 64) * 64, header = Buffer.alloc(length, " ");
+
+    header.write("\x93NUMPY\x01\x00", 0, "latin1");
+    header.writeUInt16LE(length - 10, 8);
+    header.write(dict, 10, "latin1");
+    header[length - 1] = 0x0a;
+    return header;
+}
+
+// whether the elements of a .npy array are stored row by row, a C order array with one row or column is not
+function npyRowMajor(header) {
+    return !header.fortranOrder && header.rows > 1 && header.cols > 1;
+}
+
+// a Matrix over the elements of a .npy array in their file order without copying them. A C order array is a
+// transposed view, copied into a dense matrix unless keepView is set
+function npyMatrix(header, data, keepView) {
+    var matrix = Object.create(numjs_linalg.Matrix.prototype), transposed = npyRowMajor(header);
+
+    matrix.rows = transposed ? header.cols : header.rows;
+    matrix.cols = transposed ? header.rows : header.cols;
+    matrix.dtype = header.dtype;
+    matrix.data = data;
+    if (!transposed) {
+        return matrix;
+    }
+
+    matrix = numjs_linalg.transpose(matrix);
+    return keepView ? matrix : numjs_linalg.copy(matrix);
+}
+
+// the .npy array stored at position of the open file, mapped instead of read when mmap is set and the data is
+// suitably aligned
+function loadNpy(fd, path, position, mmap) {
+    var header = readNpyHeader(fd, position), length = header.rows * header.cols, isFloat32 = header.dtype === "float32",
+        dataOffset = position + header.length, data;
+
+    if (fs.fstatSync(fd).size < dataOffset + length * dtypes[header.dtype].BYTES_PER_ELEMENT) {
+        throw new Error("The .npy file is truncated");
+    }
+
+    if (mmap && dataOffset % dtypes[header.dtype].BYTES_PER_ELEMENT === 0) {
+        data = linalg.map_file(path, dataOffset, length, isFloat32);
+    }
+    else {
+        data = allocData(length, header.dtype);
+        readAll(fd, byteView(data), dataOffset);
+    }
+    return npyMatrix(header, data, mmap);
+}
+
+// the .npy array held in bytes, an inflated .npz entry
+function loadNpyBytes(bytes) {
+    var header = parseNpyHeader(bytes), length = header.rows * header.cols,
+        data = allocData(length, header.dtype), end = header.length + data.byteLength;
+
+    if (bytes.length < end) {
+        throw new Error("The .npy array is truncated");
+    }
+    bytes.copy(byteView(data), 0, header.length, end);
+    return npyMatrix(header, data, false);
+}
+
+function readUInt64LE(bytes, offset) {
+    return bytes.readUInt32LE(offset) + bytes.readUInt32LE(offset + 4) * 4294967296;
+}
+
+// the arrays of a .npz file (a zip archive of .npy files, zip64 included) by name. The entries np.savez stores
+// uncompressed are read, or mapped, in place; the np.savez_compressed ones are inflated
+function loadNpz(fd, path, mmap) {
+    var size = fs.fstatSync(fd).size, tailLength = Math.min(size, 65557),
+        tail = readAll(fd, Buffer.alloc(tailLength), size - tailLength), end = tail.length - 22;
+
+    while (end >= 0 && tail.readUInt32LE(end) !== 0x06054b50) {
+        end--;
+    }
+    if (end < 0) {
+        throw new Error("Not a .npz file");
+    }
+
+    var count = tail.readUInt16LE(end + 10), directorySize = tail.readUInt32LE(end + 12),
+        directoryOffset = tail.readUInt32LE(end + 16);
+    if ((count === 0xffff || directoryOffset === 0xffffffff) && end >= 20 && tail.readUInt32LE(end - 20) === 0x07064b50) {
+        var zip64 = readAll(fd, Buffer.alloc(56), readUInt64LE(tail, end - 12));
+        count = readUInt64LE(zip64, 32);
+        directorySize = readUInt64LE(zip64, 40);
+        directoryOffset = readUInt64LE(zip64, 48);
+    }
+
+    var directory = readAll(fd, Buffer.alloc(directorySize), directoryOffset), result = {};
+    for (var i = 0, entry = 0; i < count; i++) {
+        if (directory.readUInt32LE(entry) !== 0x02014b50) {
+            throw new Error("Invalid .npz central directory");
+        }
+
+        var method = directory.readUInt16LE(entry + 10), compressedSize = directory.readUInt32LE(entry + 20),
+            uncompressedSize = directory.readUInt32LE(entry + 24), nameLength = directory.readUInt16LE(entry + 28),
+            extraLength = directory.readUInt16LE(entry + 30), commentLength = directory.readUInt16LE(entry + 32),
+            localOffset = directory.readUInt32LE(entry + 42),
+            name = directory.toString("utf8", entry + 46, entry + 46 + nameLength);
+
+        // the zip64 extra field holds, in this order, the sizes and offset that did not fit in 32 bits
+        for (var extra = entry + 46 + nameLength, extraEnd = extra + extraLength; extra + 4 <= extraEnd;) {
+            var id = directory.readUInt16LE(extra), field = extra + 4;
+            if (id === 0x0001) {
+                if (uncompressedSize === 0xffffffff) { uncompressedSize = readUInt64LE(directory, field); field += 8; }
+                if (compressedSize === 0xffffffff) { compressedSize = readUInt64LE(directory, field); field += 8; }
+                if (localOffset === 0xffffffff) { localOffset = readUInt64LE(directory, field); }
+            }
+            extra += 4 + directory.readUInt16LE(extra + 2);
+        }
+        entry += 46 + nameLength + extraLength + commentLength;
+
+        var local = readAll(fd, Buffer.alloc(30), localOffset),
+            dataOffset = localOffset + 30 + local.readUInt16LE(26) + local.readUInt16LE(28);
+        name = name.replace(/\.npy$/, "");
+
+        if (method === 0) {
+            result[name] = loadNpy(fd, path, dataOffset, mmap);
+        }
+        else if (method === 8) {
+            result[name] = loadNpyBytes(zlib.inflateRawSync(readAll(fd, Buffer.alloc(compressedSize), dataOffset)));
+        }
+        else {
+            throw new Error("Unsupported compression method in .npz entry " + name);
+        }
+    }
+    return result;
+}
+
+// the methods of linalg.iterative_solve and linalg.sparse_iterative_solve
+var ITERATIVE_CG = 0, ITERATIVE_BICGSTAB = 1, ITERATIVE_LSCG = 2;
+
+// the right hand side and solution buffers of matrix_solve_linear and what it returns: a typed array for a typed
+// array b, a matrix.cols x b.cols Matrix for a Matrix b
+function solveArgs(matrix, b, out) {
+    if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+        throw new Error("The first arg must be instanceof numjs.Matrix");
+    }
+    if (b instanceof numjs_linalg.Matrix) {
+        if (b.rows !== matrix.rows) {
+            throw new Error("matrix and the parameter dimensions must agree.");
+        }
+        commonDtype(matrix, b);
+        var x = outMatrix(out, matrix.cols, b.cols, matrix.dtype);
+        return {b: dense(b).data, x: x.data, result: x};
+    }
+    if (!b || b.length !== matrix.rows) {
+        throw new Error("matrix and the parameter dimensions must agree.");
+    }
+    //TODO: check matrix rank ?
+    b = asDtype(b, matrix.dtype);
+    var xArray = outArray(out, matrix.cols, matrix.dtype);
+    return {b: b, x: xArray, result: xArray};
+}
+
+// runs an iterative solver on a dense Matrix or a SparseMatrix, see numjs_linalg.cg
+function iterativeSolve(method, matrix, b, options) {
+    var isSparse = matrix instanceof numjs_linalg.SparseMatrix;
+
+    if (!isSparse && !(matrix instanceof numjs_linalg.Matrix)) {
+        throw new Error("The first arg must be instanceof numjs.Matrix or numjs.SparseMatrix");
+    }
+    if (method !== ITERATIVE_LSCG && matrix.rows !== matrix.cols) {
+        throw new Error("matrix must be square, i.e. M.rows == M.cols");
+    }
+    if (!b || b.length !== matrix.rows) {
+        throw new Error("matrix and the parameter dimensions must agree.");
+    }
+
+    options = options || {};
+    b = asDtype(b, matrix.dtype);
+
+    var x = outArray(options.out, matrix.cols, matrix.dtype), x0 = options.x0;
+    if (x0 !== undefined && x0 !== null) {
+        if (x0.length !== matrix.cols) {
+            throw new Error("The initial guess must have matrix.cols elements");
+        }
+        if (x0 !== x) {
+            x.set(x0);
+        }
+    }
+
+    var tol = options.tol || 0, maxIterations = options.maxIterations || 0, useGuess = x0 !== undefined && x0 !== null, res;
+    if (isSparse) {
+        res = linalg.sparse_iterative_solve.apply(null, [method].concat(sparseArgs(matrix), [b, x, tol, maxIterations, useGuess]));
+    }
+    else {
+        res = linalg.iterative_solve(method, matrix.rows, matrix.cols, matrix.data, b, x, tol, maxIterations, useGuess,
+            leadingDim(matrix), !!matrix.transposed);
+    }
+
+    res.x = x;
+    return res;
+}
+
+// runs one of the native expm, logm and sqrtm on a square matrix, see numjs_linalg.expm
+function matrixFunction(nativeFunction, matrix, out) {
+    if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+        throw new Error("The first arg must be instanceof numjs.Matrix");
+    }
+    matrix = dense(matrix);
+
+    if (matrix.rows !== matrix.cols) {
+        throw new Error("matrix must be square, i.e. M.rows == M.cols");
+    }
+
+    out = outMatrix(out, matrix.rows, matrix.cols, matrix.dtype);
+    nativeFunction(matrix.data, matrix.rows, matrix.cols, out.data);
+    return out;
+}
+
+// the distance between the columns of the stored block of matrix, see numjs_linalg.block
+function leadingDim(matrix) {
+    return matrix.ld !== undefined ? matrix.ld : matrix.rows;
+}
+
+// whether matrix.data holds the matrix as one contiguous column-major block, which is not the case for most views
+function isDense(matrix) {
+    return !matrix.transposed && leadingDim(matrix) === matrix.rows;
+}
+
+// matrix itself when it is dense, otherwise a dense copy for the functions which do not read views in place
+function dense(matrix) {
+    return isDense(matrix) ? matrix : toExpr(matrix).eval();
+}
+
+// a Matrix sharing the storage of matrix: element (i, j) is at offset + i + j * ld, or offset + j + i * ld when transposed
+function makeView(matrix, offset, rows, cols, ld, transposed) {
+    var view = Object.create(numjs_linalg.Matrix.prototype), storedRows = transposed ? cols : rows,
+        storedCols = transposed ? rows : cols;
+
+    view.rows = rows;
+    view.cols = cols;
+    view.dtype = matrix.dtype;
+    view.ld = ld;
+    view.transposed = transposed;
+    view.data = matrix.data.subarray(offset, offset + ld * (storedCols - 1) + storedRows);
+    return view;
+}
+
+/**
+ * Instrumentation, see numjs_linalg.enable_stats. While enabled, every native binding is called through a copy
+ * that records its calls, time, bytes of typed array arguments and their size and latency histograms, and every
+ * exported function through one that records its calls, time and the bytes its JS code allocated. Disabled, the
+ * original functions are called directly and nothing is recorded.
+ */
+var stats = {native: {}, functions: {}}, statsEnabled = false, instrumentedNative = null, originalFunctions = {},
+    allocatedBytes = 0, functionDepth = 0;
+
+// the power of two bucket of a histogram a value falls into
+function histogramBucket(value) {
+    return value <= 1 ? 1 : Math.pow(2, Math.ceil(Math.log(value) / Math.LN2));
+}
+
+function elapsedMs(start) {
+    var elapsed = process.hrtime(start);
+    return elapsed[0] * 1e3 + elapsed[1] / 1e6;
+}
+
+function recordNative(name, ms, bytes, largest) {
+    var entry = stats.native[name] || (stats.native[name] = {calls: 0, timeMs: 0, bytes: 0, latencyUs: {}, elements: {}}),
+        latency = histogramBucket(ms * 1e3), size = histogramBucket(largest);
+
+    entry.calls++;
+    entry.timeMs += ms;
+    entry.bytes += bytes;
+    entry.latencyUs[latency] = (entry.latencyUs[latency] || 0) + 1;
+    entry.elements[size] = (entry.elements[size] || 0) + 1;
+}
+
+// the typed arrays among args, including those inside array arguments (the leaves of eval_expr)
+function forEachTypedArray(args, callback) {
+    for (var i = 0; i < args.length; i++) {
+        if (ArrayBuffer.isView(args[i])) {
+            callback(args[i]);
+        }
+        else if (Array.isArray(args[i])) {
+            forEachTypedArray(args[i], callback);
+        }
+    }
+}
+
+// a native binding that records its calls, async ones when their callback is called. The callback is the only
+// function argument but not always the last one (svd_async takes the algorithm after it).
+function instrumentNative(name, binding) {
+    return function () {
+        var args = Array.prototype.slice.call(arguments), bytes = 0, largest = 0, start, callbackIndex = -1;
+
+        for (var i = 0; i < args.length && callbackIndex === -1; i++) {
+            if (typeof args[i] === "function") {
+                callbackIndex = i;
+            }
+        }
+
+        forEachTypedArray(args, function (array) {
+            bytes += array.byteLength;
+            largest = Math.max(largest, array.length);
+        });
+
+        if (callbackIndex !== -1) {
+            var callback = args[callbackIndex];
+            args[callbackIndex] = function () {
+                recordNative(name, elapsedMs(start), bytes, largest);
+                return callback.apply(this, arguments);
+            };
+            start = process.hrtime();
+            return binding.apply(native, args);
+        }
+
+        start = process.hrtime();
+        try {
+            var result = binding.apply(native, args);
+            if (name === "alloc") {
+                allocatedBytes += result.byteLength;
+            }
+            return result;
+        }
+        finally {
+            recordNative(name, elapsedMs(start), bytes, largest);
+        }
+    };
+}
+
+// an exported function that records its calls, only the outermost one when exported functions call each other
+function instrumentFunction(name, fn) {
+    return function () {
+        if (functionDepth > 0) {
+            return fn.apply(this, arguments);
+        }
+
+        var start = process.hrtime(), allocatedBefore = allocatedBytes;
+        functionDepth++;
+        try {
+            return fn.apply(this, arguments);
+        }
+        finally {
+            functionDepth--;
+            var entry = stats.functions[name] || (stats.functions[name] = {calls: 0, timeMs: 0, allocatedBytes: 0});
+            entry.calls++;
+            entry.timeMs += elapsedMs(start);
+            entry.allocatedBytes += allocatedBytes - allocatedBefore;
+        }
+    };
+}
+
+// the exported functions which are not instrumented: the constructors, the stats functions themselves and the pool
+// functions (with_pool would account the whole scope to itself)
+var UNINSTRUMENTED = ["Matrix", "SparseMatrix", "enable_stats", "stats", "reset_stats", "with_pool", "release", "pool_stats",
+    "clear_pool"];
+
+function setStatsEnabled(enabled) {
+    if (enabled === statsEnabled) {
+        return;
+    }
+    statsEnabled = enabled;
+
+    if (!instrumentedNative) {
+        instrumentedNative = {};
+        Object.keys(native).forEach(function (name) {
+            instrumentedNative[name] = typeof native[name] === "function" ? instrumentNative(name, native[name]) : native[name];
+        });
+    }
+    linalg = enabled ? instrumentedNative : native;
+
+    Object.keys(numjs_linalg).forEach(function (name) {
+        if (typeof numjs_linalg[name] !== "function" || UNINSTRUMENTED.indexOf(name) !== -1) {
+            return;
+        }
+        if (enabled) {
+            originalFunctions[name] = numjs_linalg[name];
+            numjs_linalg[name] = instrumentFunction(name, numjs_linalg[name]);
+        }
+        else if (originalFunctions.hasOwnProperty(name)) {
+            numjs_linalg[name] = originalFunctions[name];
+        }
+    });
+}
+
+/**
+ * Buffer pool, see numjs_linalg.with_pool and numjs_linalg.release. The storage of every matrix and typed array the
+ * wrappers allocate comes from allocData: a released native buffer when one fits, otherwise a new one from
+ * linalg.alloc. Free buffers are kept per dtype in power of two size classes, a buffer of n elements in class
+ * floor(log2(n)), so a request for n elements is served by any buffer of the class above or by a large enough
+ * one of its own class. Released buffers are never handed out twice and the pool never holds more than
+ * pool.limit bytes, the buffers beyond it are left to the garbage collector. The buffers an async call is
+ * working on are busy until it completes: releasing one only defers it, it joins the pool when the call is done.
+ */
+var pool = {free: {float32: [], float64: []}, bytes: 0, limit: 256 * 1024 * 1024, hits: 0, misses: 0, releases: 0,
+    discarded: 0}, pooledBuffers = new WeakSet(), freeBuffers = new WeakSet(), poolScopes = [],
+    busyBuffers = new Map(), deferredBuffers = new Map();
+
+function sizeClass(length) {
+    return 31 - Math.clz32(length);
+}
+
+// a free buffer of at least length elements removed from the pool, or null
+function takeBuffer(length, dtype) {
+    var classes = pool.free[dtype], k = sizeClass(length), list = classes[k + 1];
+
+    if (list && list.length > 0) {
+        return list.pop();
+    }
+
+    list = classes[k];
+    for (var i = list ? list.length - 1 : -1; i >= 0; i--) {
+        if (list[i].length >= length) {
+            return list.splice(i, 1)[0];
+        }
+    }
+    return null;
+}
+
+// a typed array of length elements of dtype, filled with fillValue when it is given
+function allocData(length, dtype, fillValue) {
+    var buffer = length > 0 ? takeBuffer(length, dtype) : null, data;
+
+    if (buffer) {
+        freeBuffers.delete(buffer.buffer);
+        pool.bytes -= buffer.byteLength;
+        pool.hits++;
+        data = buffer.length === length ? buffer : buffer.subarray(0, length);
+        if (fillValue !== undefined) {
+            data.fill(fillValue);
+        }
+    }
+    else {
+        data = linalg.alloc(length, dtype === "float32", fillValue);
+        pooledBuffers.add(data.buffer);
+        pool.misses++;
+    }
+
+    if (poolScopes.length > 0) {
+        poolScopes[poolScopes.length - 1].push(data);
+    }
+    return data;
+}
+
+// gives the whole buffer behind data back to the pool, false when it did not come from allocData or is already free
+function releaseData(data) {
+    var buffer = data.buffer;
+    if (!pooledBuffers.has(buffer) || freeBuffers.has(buffer) || deferredBuffers.has(buffer) ||
+        buffer.byteLength === 0) {
+        return false;
+    }
+
+    if (busyBuffers.has(buffer)) {
+        deferredBuffers.set(buffer, data);
+        return true;
+    }
+
+    if (pool.bytes + buffer.byteLength > pool.limit) {
+        pool.discarded++;
+        return false;
+    }
+
+    var dtype = data instanceof Float32Array ? "float32" : "float64", whole = new dtypes[dtype](buffer),
+        classes = pool.free[dtype], k = sizeClass(whole.length);
+
+    (classes[k] || (classes[k] = [])).push(whole);
+    freeBuffers.add(buffer);
+    pool.bytes += buffer.byteLength;
+    pool.releases++;
+    return true;
+}
+
+// calls start(done) with the storage of arrays busy until the async call reports to done, which hands its error
+// to callback. The buffers released meanwhile go back to the pool then, except the storage of result when the call
+// succeeded: the caller uses it after the Promise settles, so it is dropped from the pool and left to the GC.
+function whileBusy(arrays, result, start, callback) {
+    var buffers = arrays.filter(Boolean).map(function (data) {
+        return data.buffer;
+    });
+
+    buffers.forEach(function (buffer) {
+        busyBuffers.set(buffer, (busyBuffers.get(buffer) || 0) + 1);
+    });
+
+    function done(resolved) {
+        var kept = new Set();
+        collectBuffers(resolved, kept, 0);
+
+        buffers.forEach(function (buffer) {
+            var count = busyBuffers.get(buffer) - 1;
+            if (count > 0) {
+                busyBuffers.set(buffer, count);
+                return;
+            }
+
+            busyBuffers.delete(buffer);
+            if (deferredBuffers.has(buffer)) {
+                var data = deferredBuffers.get(buffer);
+                deferredBuffers.delete(buffer);
+                if (!kept.has(buffer)) {
+                    releaseData(data);
+                }
+            }
+        });
+    }
+
+    try {
+        start(function (err) {
+            done(err ? undefined : result);
+            callback(err);
+        });
+    }
+    catch (e) {
+        done();
+        throw e;
+    }
+}
+
+// adds to buffers the storage reachable from value: a matrix, a typed array, or arrays and objects holding them
+function collectBuffers(value, buffers, depth) {
+    if (ArrayBuffer.isView(value)) {
+        buffers.add(value.buffer);
+    }
+    else if (value instanceof numjs_linalg.Matrix) {
+        buffers.add(value.data.buffer);
+    }
+    else if (value && typeof value === "object" && depth < 4) {
+        Object.keys(value).forEach(function (key) {
+            collectBuffers(value[key], buffers, depth + 1);
+        });
+    }
+}
+
+// releases the buffers allocated in a with_pool scope except those of result, which move to the enclosing scope
+function closeScope(allocated, result) {
+    var kept = new Set();
+    collectBuffers(result, kept, 0);
+
+    allocated.forEach(function (data) {
+        if (kept.has(data.buffer)) {
+            if (poolScopes.length > 0) {
+                poolScopes[poolScopes.length - 1].push(data);
+            }
+        }
+        else {
+            releaseData(data);
+        }
+    });
+}
+
+// the object returned by numjs_linalg.gram_accumulator, the sums live in the native accumulator
+function GramAccumulator(d, dtype) {
+    this.d = d;
+    this.dtype = dtype;
+    this.accumulator = linalg.gram_accumulator(d);
+}
+
+GramAccumulator.prototype.add = function (rows) {
+    if (rows instanceof numjs_linalg.Matrix) {
+        if (rows.cols !== this.d) {
+            throw new Error("The rows must have " + this.d + " columns");
+        }
+        this.accumulator.add(dense(rows).data, false);
+        return this;
+    }
+
+    if (!rows || typeof rows.length !== "number") {
+        throw new Error("The rows must be a numjs.Matrix, a typed array or an array");
+    }
+    if (rows.length % this.d !== 0) {
+        throw new Error("The length of rows must be a multiple of " + this.d);
+    }
+
+    this.accumulator.add(isFloatArray(rows) ? rows : asDtype(rows, "float64"), true);
+    return this;
+};
+
+GramAccumulator.prototype.count = function () {
+    return this.accumulator.count();
+};
+
+GramAccumulator.prototype.gram = function (out) {
+    out = outMatrix(out, this.d, this.d, this.dtype);
+    this.accumulator.gramInto(out.data);
+    return out;
+};
+
+GramAccumulator.prototype.covariance = function (ddof, out) {
+    ddof = ddof === undefined || ddof === null ? 1 : ddof;
+    if (typeof ddof !== "number" || ddof < 0) {
+        throw new Error("ddof must be a non negative number");
+    }
+    if (this.count() <= ddof) {
+        throw new Error("The covariance needs more than ddof rows");
+    }
+
+    out = outMatrix(out, this.d, this.d, this.dtype);
+    this.accumulator.covarianceInto(out.data, ddof);
+    return out;
+};
+
+GramAccumulator.prototype.correlation = function (out) {
+    if (this.count() === 0) {
+        throw new Error("The correlation needs at least one row");
+    }
+
+    out = outMatrix(out, this.d, this.d, this.dtype);
+    this.accumulator.correlationInto(out.data);
+    return out;
+};
+
+GramAccumulator.prototype.mean = function (out) {
+    out = outArray(out, this.d, this.dtype);
+    this.accumulator.meanInto(out);
+    return out;
+};
+
+GramAccumulator.prototype.reset = function () {
+    this.accumulator.reset();
+    return this;
+};
+
+// opcodes of the expression programs run by linalg.eval_expr
+var EXPR_LEAF = 0, EXPR_ADD = 1, EXPR_SUB = 2, EXPR_MUL = 3, EXPR_SCALE = 4, EXPR_TRANSPOSE = 5;
+
+// a lazily evaluated matrix expression node, see numjs_linalg.expr
+function Expr(op, args, rows, cols, dtype, scalar) {
+    this.op = op;
+    this.args = args;
+    this.rows = rows;
+    this.cols = cols;
+    this.dtype = dtype;
+    this.scalar = scalar;
+}
+
+function toExpr(value) {
+    if (value instanceof Expr) {
+        return value;
+    }
+
+    if (!(value instanceof numjs_linalg.Matrix)) {
+        throw new Error("The argument must be instanceof numjs.Matrix or an expression");
+    }
+
+    if (value.transposed) {
+        var stored = new Expr(EXPR_LEAF, [value], value.cols, value.rows, value.dtype);
+        return new Expr(EXPR_TRANSPOSE, [stored], value.rows, value.cols, value.dtype);
+    }
+
+    return new Expr(EXPR_LEAF, [value], value.rows, value.cols, value.dtype);
+}
+
+Expr.prototype.add = function (other) {
+    other = toExpr(other);
+    if (this.rows !== other.rows || this.cols !== other.cols) {
+        throw new Error("matrix dimensions must agree");
+    }
+
+    return new Expr(EXPR_ADD, [this, other], this.rows, this.cols, commonDtype(this, other));
+};
+
+Expr.prototype.sub = function (other) {
+    other = toExpr(other);
+    if (this.rows !== other.rows || this.cols !== other.cols) {
+        throw new Error("matrix dimensions must agree");
+    }
+
+    return new Expr(EXPR_SUB, [this, other], this.rows, this.cols, commonDtype(this, other));
+};
+
+Expr.prototype.mul = function (other) {
+    if (typeof other === "number") {
+        return this.scale(other);
+    }
+
+    other = toExpr(other);
+    if (this.cols !== other.rows) {
+        throw new Error("matrix dimensions must agree, i.e. left.cols == right.rows");
+    }
+
+    return new Expr(EXPR_MUL, [this, other], this.rows, other.cols, commonDtype(this, other));
+};
+
+Expr.prototype.scale = function (scalar) {
+    if (typeof scalar !== "number") {
+        throw new Error("scalar must be a number");
+    }
+
+    return new Expr(EXPR_SCALE, [this], this.rows, this.cols, this.dtype, scalar);
+};
+
+Expr.prototype.transpose = function () {
+    return new Expr(EXPR_TRANSPOSE, [this], this.cols, this.rows, this.dtype);
+};
+
+// appends the prefix program of the expression, each matrix is listed once in leaves
+Expr.prototype.compile = function (program, leaves) {
+    program.push(this.op);
+
+    if (this.op === EXPR_LEAF) {
+        var matrix = this.args[0], index = leaves.indexOf(matrix.data);
+        if (index < 0) {
+            index = leaves.push(matrix.data) - 1;
+        }
+        program.push(index, this.rows, this.cols, leadingDim(matrix));
+        return;
+    }
+
+    if (this.op === EXPR_SCALE) {
+        program.push(this.scalar);
+    }
+
+    for (var i = 0; i < this.args.length; i++) {
+        this.args[i].compile(program, leaves);
+    }
+};
+
+Expr.prototype.eval = function (out) {
+    var program = [], leaves = [];
+    this.compile(program, leaves);
+
+    out = outMatrix(out, this.rows, this.cols, this.dtype);
+    linalg.eval_expr(new Float64Array(program), leaves, this.rows, this.cols, out.data);
+    return out;
+};
 
 var numjs_linalg = {
     /**
      * The matrix base class. represents a rowsXcols matrix
      * ================
      * usage example:
-     * var onesMat = new numjs_linalg.Matrix([1,1,1,1], 2, 2); <- creates a new 2x2 ones matrix
-     * var zeroMat = new numjs_linalg.Matrix([], 4, 4); <- creates a new zero filled 4x4 matrix
-     * var customValsMat = new numjs_linalg.Matrix([1,2,3,4], 2, 2); <- creates a new 2x2 matrix with values {1,2;3,4}
-     * var customValsVector = new numjs_linalg.Matrix([1,2,3,4], 1, 4); <- creates a vector with values {1,2,3,4}
-     * ================
+     * var onesMat = new numjs_linalg.Matrix([1,1,1,1], 2, 2); <- creates a new 2x2 ones matrix
+     * var zeroMat = new numjs_linalg.Matrix([], 4, 4); <- creates a new zero filled 4x4 matrix
+     * var customValsMat = new numjs_linalg.Matrix([1,2,3,4], 2, 2); <- creates a new 2x2 matrix with values {1,2;3,4}
+     * var customValsVector = new numjs_linalg.Matrix([1,2,3,4], 1, 4); <- creates a vector with values {1,2,3,4}
+     * var singleMat = new numjs_linalg.Matrix([1,2,3,4], 2, 2, {dtype: 'float32'}); <- creates a 2x2 single precision matrix
+     * ================
+     * The data is allocated natively on a 64 byte boundary and filled (or copied) in C++, so building large
+     * matrices does not loop over their elements in JS.
+     *
+     * @param array - an array of data to populate the newly built matrix
+     * @param rows - the newly built matrix number of rows
+     * @param cols - the newly built matrix number of cols
+     * @param internalData - optional - {dtype: 'float32' | 'float64'}, defaults to 'float32' when array is
+     *                       a Float32Array and to 'float64' otherwise
+     * @constructor
+     */
+    Matrix: function (array, rows, cols, internalData) {
+        var dtype = (internalData && internalData["dtype"]) || (array instanceof Float32Array ? "float32" : "float64");
+
+        if (!dtypes.hasOwnProperty(dtype)) {
+            throw new Error("dtype must be 'float32' or 'float64'");
+        }
+
+        if (array.length !== 0 && array.length !== rows * cols) {
+            throw new Error("The array.length !== rows*cols");
+        }
+
+        this.rows = rows;
+        this.cols = cols;
+        this.dtype = dtype;
+
+        if (arguments.length > 3 && internalData && internalData["isEmpty"]) {
+            this.data = allocData(rows * cols, dtype);
+        }
+        else if (array.length === 0) {
+            var defaultValue = (internalData && internalData["isOnes"])? 1.0 : 0.0;
+            if (internalData && internalData["fillValue"] !== undefined) {
+                defaultValue = internalData["fillValue"];
+            }
+            this.data = allocData(rows * cols, dtype, defaultValue);
+        }
+        else {
+            this.data = allocData(rows * cols, dtype);
+            this.data.set(array);
+        }
+    },
+
+    /**
+     * A sparse rowsXcols matrix stored in compressed sparse column (CSC, the default) or compressed sparse row (CSR)
+     * format, the layouts of scipy.sparse csc_matrix and csr_matrix. For CSC, the row indices and values of column j
+     * are indices[indptr[j] .. indptr[j + 1] - 1] and values[indptr[j] .. indptr[j + 1] - 1]; CSR swaps rows and
+     * columns. The native functions map these arrays as an Eigen::SparseMatrix without copying them.
+     * ================
+     * usage example:
+     * var S = new numjs_linalg.SparseMatrix(3, 3, [0, 2, 3, 4], [0, 2, 1, 2], [4, 1, 3, 5]); <- CSC, 4 nonzeros
+     * var R = new numjs_linalg.SparseMatrix(2, 4, [0, 1, 2], [3, 0], [7, 8], {format: 'csr'}); <- CSR
+     * ================
+     *
+     * @param rows - the number of rows of the matrix
+     * @param cols - the number of cols of the matrix
+     * @param indptr - cols + 1 (rows + 1 for CSR) offsets into indices and values, converted to an Int32Array
+     * @param indices - the row (col for CSR) index of every nonzero, sorted within each column (row),
+     *                  converted to an Int32Array
+     * @param values - the nonzero values
+     * @param internalData - optional - {format: 'csc' | 'csr', dtype: 'float32' | 'float64'}, dtype defaults to
+     *                       'float32' when values is a Float32Array and to 'float64' otherwise
+     * @constructor
+     */
+    SparseMatrix: function (rows, cols, indptr, indices, values, internalData) {
+        var format = (internalData && internalData["format"]) || "csc",
+            dtype = (internalData && internalData["dtype"]) || (values instanceof Float32Array ? "float32" : "float64");
+
+        if (format !== "csc" && format !== "csr") {
+            throw new Error("format must be 'csc' or 'csr'");
+        }
+        if (!dtypes.hasOwnProperty(dtype)) {
+            throw new Error("dtype must be 'float32' or 'float64'");
+        }
+
+        this.rows = rows;
+        this.cols = cols;
+        this.format = format;
+        this.dtype = dtype;
+        this.indptr = indptr instanceof Int32Array ? indptr : new Int32Array(indptr);
+        this.indices = indices instanceof Int32Array ? indices : new Int32Array(indices);
+        this.values = values instanceof dtypes[dtype] ? values : new dtypes[dtype](values);
+        this.nnz = this.values.length;
+
+        // the arrays built by the native functions are valid by construction
+        if (internalData && internalData["isValid"]) return;
+
+        var outer = format === "csr" ? rows : cols, inner = format === "csr" ? cols : rows;
+        if (this.indptr.length !== outer + 1 || this.indptr[0] !== 0 || this.indptr[outer] !== this.indices.length ||
+            this.indices.length !== this.values.length) {
+            throw new Error("indptr must hold outer size + 1 offsets into indices and values");
+        }
+
+        for (var i = 0; i < outer; i++) {
+            if (this.indptr[i + 1] < this.indptr[i]) {
+                throw new Error("indptr must be non decreasing");
+            }
+            for (var j = this.indptr[i]; j < this.indptr[i + 1]; j++) {
+                if (this.indices[j] < 0 || this.indices[j] >= inner || (j > this.indptr[i] && this.indices[j] <= this.indices[j - 1])) {
+                    throw new Error("indices must be sorted and inside the matrix");
+                }
+            }
+        }
+    },
+
+    /**
+     * Creates a new zero filled matrix with the shape specified by number of rows and cols
+     * =======================
+     * usage example:
+     * var newMat = numjs_linalg.zeros(3,4); <- creates a new 3X4 zero filled matrix
+     * var newMat = numjs_linalg.zeros(3); <- creates a new 3X3 zero filled matrix
+     * var zeroVector = numjs_linalg.zeros(1, 4) <- creates a new zero filled vector
+     * var zeroScalar = numjs_linalg.zeros(1) <- creates a 0 value scalar
+     * var singleMat = numjs_linalg.zeros(3, 4, 'float32'); <- creates a new 3X4 single precision zero filled matrix
+     * =======================
+     *
+     * @param rows - the number of rows for the newly built matrix
+     * @param cols - the number of cols for the newly built matrix - OPTIONAL - defaults to rows
+     * @param dtype - 'float32' or 'float64' - OPTIONAL - defaults to 'float64'
+     * @returns {numjs_linalg.Matrix}
+     */
+    zeros: function(rows, cols, dtype) {
+        if (!rows)  {
+            throw new Error("now input parameters given");
+        }
+
+        if (!cols) {
+            cols = rows;
+        }
+
+        if (rows <= 0 || cols <= 0) {
+            throw new Error("rows and cols parameters must be positive numbers");
+        }
+
+        return new numjs_linalg.Matrix([], rows, cols, {dtype: dtype});
+    },
+
+    /**
+     * Creates a new one-value filled matrix with the shape specified by number of rows and cols
+     * =======================
+     * usage example:
+     * var newMat = numjs_linalg.ones(3,4); <- creates a new 3X4 one-value filled matrix
+     * var newMat = numjs_linalg.ones(3); <- creates a new 3X3 one-value filled matrix
+     * var oneVector = numjs_linalg.ones(1, 4) <- creates a new ones filled vector
+     * var oneScalar = numjs_linalg.ones(1) <- creates a 1 value scalar
+     * ========================
+     *
+     * @param rows - the number of rows for the newly built matrix
+     * @param cols - the number of cols for the newly built matrix - optional - defaults to rows
+     * @param dtype - 'float32' or 'float64' - optional - defaults to 'float64'
+     * @returns {numjs_linalg.Matrix}
+     */
+    ones: function(rows, cols, dtype) {
+        if (!rows)  {
+            throw new Error("now input parameters given");
+        }
+
+        if (!cols) {
+            cols = rows;
+        }
+
+        if (rows <= 0 || cols <= 0) {
+            throw new Error("rows and cols parameters must be positive numbers");
+        }
+
+        return new numjs_linalg.Matrix([], rows, cols, {isOnes:true, dtype: dtype});
+    },
+
+    /**
+     * Creates a new matrix filled with value, with the shape specified by number of rows and cols
+     * ========================
+     * usage example:
+     * var newMat = numjs_linalg.full(3, 4, 0.5); <- creates a new 3X4 matrix filled with 0.5
+     * var newMat = numjs_linalg.full(3, null, -1, 'float32'); <- creates a new 3X3 single precision matrix filled with -1
+     * ========================
+     *
+     * @param rows - the number of rows for the newly built matrix
+     * @param cols - the number of cols for the newly built matrix - optional - defaults to rows
+     * @param value - the number every element is set to
+     * @param dtype - 'float32' or 'float64' - optional - defaults to 'float64'
+     * @returns {numjs_linalg.Matrix}
+     */
+    full: function(rows, cols, value, dtype) {
+        if (!rows)  {
+            throw new Error("now input parameters given");
+        }
+
+        if (!cols) {
+            cols = rows;
+        }
+
+        if (rows <= 0 || cols <= 0) {
+            throw new Error("rows and cols parameters must be positive numbers");
+        }
+
+        if (typeof value !== "number") {
+            throw new Error("value must be a number");
+        }
+
+        return new numjs_linalg.Matrix([], rows, cols, {fillValue: value, dtype: dtype});
+    },
+
+
+    /**
+     * Creates a new empty matrix, with no initialized values within it.
+     * ===================
+     * usage example:
+     * var emptyMat = numjs_linalg.empty(3, 3); <- creates a 3x3 empty matrix
+     * var nonSquareEmpty = numjs_linalg.empty(3, 4); <- creates a 3x4 empty matrix
+     * var emptySquareMat = numjs_linalg.empty(5); <-creates a 5x5 empty matrix
+     * ===================
+     *
+     * @param rows - the number of matrix rows
+     * @param cols - the number of matrix cols - optional - defaults to rows
+     * @param dtype - 'float32' or 'float64' - optional - defaults to 'float64'
+     */
+    empty: function(rows, cols, dtype) {
+        if (!rows) {
+            throw new Error("input parameters are undefined")
+        }
+
+        if (!cols) {
+            cols = rows;
+        }
+
+        if (rows <= 0 || cols <= 0) {
+            throw new Error("rows and cols parameters must be positive");
+        }
+
+        return new numjs_linalg.Matrix([], rows, cols, {isEmpty: true, dtype: dtype});
+    },
+
+    /**
+     * Computes the Dot product of matrices.
+     * For 2-D matrices it is equivalent to matrix multiplication,
+     * and for 1-D matrix it is equivalent to inner product of vectors
+     * ==================
+     * usage example:
+     * var jsMatLeft = linalg.ones([1, 1, 1, 1], 1, 4); <- creates a ones vector
+     * var jsMatRight = new linalg.Matrix([2, 2, 1, 1], 4, 1); <- creates a custom values vector
+     * var dotproduct = linalg.dot(jsMatLeft, jsMatRight) <- computes the dot product == 6
+     *
+     * var jsMatRight = new linalg.Matrix([2, 2, 1, 1], 2, 2); <- creates a new custom values matrix
+     * var dotproduct = linalg.dot(2, jsMatRight); <- computes the dot product of the matrix with a number
+     * ==================
+     *
+     * @param leftMatrix - The left input matrix to perform dot computation
+     * @param rightMatrix - The right input matrix to perform dot computation
+     * @param out - optional - a matrix of the result shape and dtype to write the dot product into
+     */
+    dot: function (leftMatrix, rightMatrix, out) {
+        var lrows = 1, lcols = 1, rrows = 1, rcols = 1, dtype;
+
+        if (!leftMatrix || !rightMatrix) {
+            throw new Error("The input parameters are undefined");
+
+        }
+
+        if (!isNaN(leftMatrix) && !isNaN(rightMatrix)) {
+            return leftMatrix * rightMatrix;
+        }
+
+        if (leftMatrix instanceof numjs_linalg.Matrix) {
+            lrows = leftMatrix.rows;
+            lcols = leftMatrix.cols;
+        }
+        else if (isNaN(leftMatrix)) {
+            throw new Error("The leftMatrix parameter is not instance of Matrix or a number");
+
+        }
+
+        if (rightMatrix instanceof numjs_linalg.Matrix) {
+            rrows = rightMatrix.rows;
+            rcols = rightMatrix.cols;
+        }
+        else if (isNaN(rightMatrix)) {
+            throw new Error("The rightMatrix parameter is not instance of Matrix or a number");
+
+        }
+
+        dtype = commonDtype(leftMatrix, rightMatrix);
+
+        // matrix products read views in place, scaling needs the matrix as one block
+        if (!isNaN(leftMatrix) || !isNaN(rightMatrix)) {
+            leftMatrix = isNaN(leftMatrix) ? dense(leftMatrix) : leftMatrix;
+            rightMatrix = isNaN(rightMatrix) ? dense(rightMatrix) : rightMatrix;
+        }
+
+        var newRows = lrows, newCols = rcols;
+
+        if (!isNaN(leftMatrix) && isNaN(rightMatrix)) {// scalar*mat
+            newRows = rrows;
+            newCols = rcols;
+        }
+        else if (isNaN(leftMatrix) && !isNaN(rightMatrix)) {// mat*scalar
+            newRows = lrows;
+            newCols = lcols;
+        }
+
+        out = outMatrix(out, newRows, newCols, dtype);
+
+        var isSuc = linalg.dot(lrows, lcols, leftMatrix.data ? leftMatrix.data : leftMatrix,
+            rrows, rcols, rightMatrix.data ? rightMatrix.data : rightMatrix, out.data,
+            leadingDim(leftMatrix), !!leftMatrix.transposed, leadingDim(rightMatrix), !!rightMatrix.transposed);
+
+        if (out.rows * out.cols === 1) {
+            return out.data[0];
+        }
+
+        return out;
+    },
+
+    /**
+     * Computes the ordinary inner product of vectors for 1-D matrices, or in 2 dimensions, computes the sum product
+     * over the last axes. (i.e. sum of left.row[i] * right.row[j])
+     * If a or b are scalars, computes a*b.
+     * NOTE: If a and b are nonscalar, their last dimensions of must match. (i.e. the number of cols)
+     * ==================
+     * usage example:
+     * Compute the sum product over the second axes of two 2-D matrices
+     * var jsMatLeft = new linalg.Matrix([1, 4, 2, 5, 3, 6], 2, 3); <- creates a new 2x3 matrix
+     * var jsMatRight = new linalg.Matrix([7, 10,8, 11,9, 12], 2, 3); <- creates a new 2x3 matrix
+     * var matrix = linalg.inner(jsMatLeft, jsMatRight); compute the sum product over the second axes
+     *
+     * Compute the inner product of two 1-D matrices
+     * var jsMatLeft = new linalg.Matrix([1, 1, 1, 1], 1, 4); <- creates a new 1x4 matrix (vector)
+     * var jsMatRight = new linalg.Matrix([2, 2, 1, 1], 1, 4); <- creates a new 1x4 matrix (vector)
+     * var innerProduct = linalg.inner(2, jsMatRight); <- computes the inner product of the matrices
+     * ==================
+     *
+     * @param leftMatrix - The left input matrix to perform inner/sum product computation
+     * @param rightMatrix - The right input matrix to perform inner/sum product computation
+     * @param out - optional - a matrix of the result shape and dtype to write the inner/sum product into
+     */
+    inner: function (leftMatrix, rightMatrix, out) {
+        var lrows = 1, lcols = 1, rrows = 1, rcols = 1, newRows, newCols;
+
+        if (!leftMatrix || !rightMatrix) {
+            throw new Error("The input parameters are undefined");
+        }
+
+        // In case left matrix and right matrix are both scalars
+        if (!isNaN(leftMatrix) && !isNaN(rightMatrix)) {
+            return leftMatrix * rightMatrix;
+        }
+
+        if (leftMatrix instanceof numjs_linalg.Matrix) {
+            lrows = leftMatrix.rows;
+            lcols = leftMatrix.cols;
+        }
+        else if (isNaN(leftMatrix)) {
+            throw new Error("The leftMatrix parameter is not instance of Matrix or a number");
+        }
+
+        if (rightMatrix instanceof numjs_linalg.Matrix) {
+            rrows = rightMatrix.rows;
+            rcols = rightMatrix.cols;
+        }
+        else if (isNaN(rightMatrix)) {
+            throw new Error("The rightMatrix parameter is not instance of Matrix or a number");
+        }
+
+        if(isNaN(leftMatrix) && isNaN(rightMatrix) && rightMatrix.cols !== leftMatrix.cols){
+            throw new Error("The last dimensions of left and right matrices must match");
+        }
+
+        if (!isNaN(leftMatrix) || !isNaN(rightMatrix)) {
+            leftMatrix = isNaN(leftMatrix) ? dense(leftMatrix) : leftMatrix;
+            rightMatrix = isNaN(rightMatrix) ? dense(rightMatrix) : rightMatrix;
+        }
+
+        newRows = lrows;
+        newCols = rrows;
+
+        // In case left matrix is scalar
+        if (!isNaN(leftMatrix) && isNaN(rightMatrix)) {// scalar*mat
+            newRows = rrows;
+            newCols = rcols;
+        }
+        // In case right matrix is scalar
+        else if (isNaN(leftMatrix) && !isNaN(rightMatrix)) {// mat*scalar
+            newRows = lrows;
+            newCols = lcols;
+        }
+
+        // Create new matrix for the results, unless one was given
+        out = outMatrix(out, newRows, newCols, commonDtype(leftMatrix, rightMatrix));
+
+        var isSuc = linalg.inner(lrows, lcols, leftMatrix.data ? leftMatrix.data : leftMatrix,
+            rrows, rcols, rightMatrix.data ? rightMatrix.data : rightMatrix, out.data,
+            leadingDim(leftMatrix), !!leftMatrix.transposed, leadingDim(rightMatrix), !!rightMatrix.transposed);
+
+        if (out.rows * out.cols === 1) {
+            return out.data[0];
+        }
+
+        return out;
+    },
+
+    /**
+     * Compute the outer product of two 1-D matrices. (i.e. out[i, j] = a[i] * b[j])
+     * If a or b are scalars, computes a*b.
+     * ==================
+     * usage example:
+     * var jsMatLeft = new linalg.Matrix([1, 1, 1, 1], 1, 4); <- creates a new 1x4 matrix (vector)
+     * var jsMatRight = new linalg.Matrix([2, 2, 1, 1], 1, 4); <- creates a new 1x4 matrix (vector)
+     * var matrix = linalg.outer(jsMatLeft, jsMatRight); <- computes the outer product of the two matrices
+     * ==================
+     *
+     * @param leftVector - The left input 1-D matrix to perform outer product computation.
+     *                      Input is flattened if not already 1-dimensional.
+     * @param rightVector - The right input 1-D matrix to perform outer product computation.
+     *                      Input is flattened if not already 1-dimensional.
+     * @param out - optional - a matrix of the result shape and dtype to write the outer product into
+     * @return The ordinary outer product of two vectors.
+     */
+    outer: function (leftVector, rightVector, out) {
+        var lrows = 1, lcols = 1, rrows = 1, rcols = 1, newRows, newCols;
+
+        if (!leftVector || !rightVector) {
+            throw new Error("The input parameters are undefined");
+        }
+
+        // In case left matrix and right matrix are both scalars
+        if (!isNaN(leftVector) && !isNaN(rightVector)) {
+            return leftVector * rightVector;
+        }
+
+        if (leftVector instanceof numjs_linalg.Matrix) {
+            lrows = leftVector.rows * leftVector.cols;
+            lcols = 1;
+        }
+        else if (isNaN(leftVector)) {
+            throw new Error("The leftMatrix parameter is not instance of Matrix or a number");
+        }
+
+        if (rightVector instanceof numjs_linalg.Matrix) {
+            if (leftVector instanceof numjs_linalg.Matrix){
+                rrows = 1;
+                rcols = rightVector.rows * rightVector.cols;
+            }
+            else {
+                rrows = rightVector.rows;
+                rcols = rightVector.cols;
+            }
+        }
+        else if (isNaN(rightVector)) {
+            throw new Error("The rightMatrix parameter is not instance of Matrix or a number");
+        }
+
+        // the inputs are flattened, which needs them as one block
+        leftVector = isNaN(leftVector) ? dense(leftVector) : leftVector;
+        rightVector = isNaN(rightVector) ? dense(rightVector) : rightVector;
+
+        newRows = lrows;
+        newCols = rcols;
+
+        // In case left matrix is scalar
+        if (!isNaN(leftVector) && isNaN(rightVector)) {// scalar*mat
+            newRows = rrows;
+            newCols = rcols;
+        }
+        // In case right matrix is scalar
+        else if (isNaN(leftVector) && !isNaN(rightVector)) {// mat*scalar
+            newRows = lrows;
+            newCols = lcols;
+        }
+
+        out = outMatrix(out, newRows, newCols, commonDtype(leftVector, rightVector));
+
+        var isSuc = linalg.outer(lrows, lcols, leftVector.data ? leftVector.data : leftVector,
+            rrows, rcols, rightVector.data ? rightVector.data : rightVector, out.data);
+
+        if (out.rows * out.cols === 1) {
+            return out.data[0];
+        }
+
+        return out;
+    },
+
+    /**
+     * Creates a square nXn identity matrix - a matrix with ones on the main diagonal
+     * and zeros elsewhere.
+     * =====================
+     * usage example:
+     * var mat = numjs_linalg.identity(3); <- creates a 3x3 identity matrix
+     * var mat2 = numjs_linalg.identity(5); <- creates a 5x5 identity matrix
+     * var scalar = numjs_linalg.identity(1); <- creates a single 1 value (scalar)
+     * =====================
+     *
+     * @param n - the dimensions of the nXn matrix
+     * @param dtype - 'float32' or 'float64' - optional - defaults to 'float64'
+     */
+    identity: function(n, dtype) {
+        if (!n || n <= 0) {
+            throw new Error("invalid argument, should be a positive number");
+        }
+
+        var out = new numjs_linalg.Matrix([], n, n, {isEmpty: true, dtype: dtype});
+        linalg.identity(n, out.data);
+        return out;
+    },
+
+    /**
+     * Creates a matrix with ones on the main diagonal and zeros elsewhere
+     * the matrix can be of any size, not necessarily nXn
+     * =========================
+     * usage example:
+     * var eyeMat = numjs_linalg.eye(3,4); <- creates a 3x4 eye matrix
+     * var idMat = numjs_linalg.eye(3); <- creates a 3x3 identity matrix
+     * var eyeMat2 = numjs_linalg.eye(5, 5) <- creates a 5x5 indentity matrix
+     * var scalar = numjs_linalg.eye(1) <- creates a scalar with the value of 1.
+     * =========================
+     *
+     * @param n - the number of matrix rows
+     * @param m - the number of matrix cols - optional parameter, defaults to n
+     * @param dtype - 'float32' or 'float64' - optional parameter, defaults to 'float64'
+     */
+    eye: function(n, m, dtype) {
+        if (!n) {
+            throw new Error("Undefined arguments")
+        }
+
+        if (!m) {
+            m = n;
+        }
+
+        if (n <= 0 || m <= 0) {
+            throw new Error("The rows and cols arguments must be positive");
+        }
+
+        var out = new numjs_linalg.Matrix([], n, m, {isEmpty: true, dtype: dtype});
+        linalg.eye(n, m, out.data);
+        return out;
+    },
+
+    /**
+     * Creates a matrix with ones at and below the main diagonal and zeros elsewhere
+     * matrix size is nXm.
+     * ============================
+     * usage example:
+     * var mat = tri(3,3); <- creates a 3x3 lower triagonal matrix
+     * var mat = tri(5,7); <- creates a 5x7 lower triagonal matrix
+     * var scalar = tri(1,1); <- creates a scalar with the value of 1
+     * ============================
+     *
+     * @param n - the number of matrix rows
+     * @param m - the number of matrix cols
+     * @param dtype - 'float32' or 'float64' - optional - defaults to 'float64'
+     */
+    tri : function(n, m, dtype) {
+        if (!n || !m) {
+            throw new Error("Must specify two arguments - number of rows and number of cols");
+        }
+
+        if (n <= 0 || m <= 0) {
+            throw new Error("The rows and cols arguments must be positive");
+        }
+
+        var out = new numjs_linalg.Matrix([], n, m, {isEmpty: true, dtype: dtype});
+        linalg.tri(n,m, out.data);
+        return out;
+    },
+
+    /**
+     * Creates a copy of a given matrix with all elements above the diagonal zeroed
+     * (a lower triagonal copy of the input)
+     * ==============
+     * usage example:
+     * var mat = new linalg.Matrix([1,2,3,4,5,6,7,8,9], 3, 3); <- input matrix
+     * var trilMat = linalg.tril(mat); <- creates a lower triagonal copy of mat
+     *
+     * var mat = linalg.ones(5); <- creates a 5x5 ones matrix
+     * var trilMat = linalg.tril(mat); <- creates a lower triagonal copy of mat
+     * ==============
+     *
+     * @param matrix - the matrix to convert into a lower triagonal matrix
+     * @param out - optional - a matrix of the same shape and dtype to write the result into, may be matrix itself
+     */
+    tril: function(matrix, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The argument must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+
+        out = outMatrix(out, matrix.rows, matrix.cols, matrix.dtype);
+        linalg.tril(matrix.data, matrix.rows, matrix.cols, out.data);
+        return out;
+    },
+
+    /**
+     * Creates a copy of a given matrix with all elements below the diagonal zeroed
+     * ==============
+     * usage example:
+     * var mat = new linalg.Matrix([1,2,3,4,5,6,7,8,9], 3, 3); <- input matrix
+     * var triMat = linalg.tril(mat); <- creates an upper triagonal matrix of mat
+     *
+     * var mat = linalg.ones(5); <- creates a 5x5 ones matrix
+     * var trilMat = linalg.tril(mat); <- creates an upper triagonal copy of mat
+     * ==============
+     *
+     * @param matrix - the matrix to convert into an upper triagonal matrix
+     * @param out - optional - a matrix of the same shape and dtype to write the result into, may be matrix itself
+     */
+    triu: function(matrix, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The argument must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+
+        out = outMatrix(out, matrix.rows, matrix.cols, matrix.dtype);
+        linalg.triu(matrix.data, matrix.rows, matrix.cols, out.data);
+        return out;
+    },
+
+    /**
+     * Raise a square matrix to the (integer) power n, by repeated squaring in O(log |n|) matrix products.
+     * =================
+     * usage example:
+     * var inputMat = new linalg.Matrix([1, 1, 1, 1], 2, 2); <- create a new input 2x2 ones matrix
+     * var powerMat = linalg.matrix_power(inputMat, 3); <- returns a new matrix raised to the power of 3
+     *
+     * var inputMat = new linalg.Matrix([1,1,1,1, 2, 2); <- create a new input 2x2 ones matrix
+     * var identityMat = linalg.matrix_power(inputMat, 0); <- create identity matrix by raising it to the power of 0
+     * =================
+     *
+     * @param matrix - the input matrix
+     * @param n - integer that represents the exponent, can be positive, negative or zero.
+     *            For a real power p use expm(p * logm(M)).
+     * @param out - optional - a matrix of the same shape and dtype to write the result into
+     */
+    matrix_power: function (matrix, n, out) {
+        if (typeof n !== "number" || n % 1 !== 0) {
+            throw new Error("The exponent must be an integer");
+        }
+
+        if (n === 1 && !out) {
+            return matrix;
+        }
+
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
+        }
+
+        out = outMatrix(out, matrix.rows, matrix.cols, matrix.dtype);
+        linalg.matrix_power(matrix.data, matrix.rows, matrix.cols, n, out.data);
+        return out;
+    },
+
+    /**
+     * Matrix functions of a square matrix.
+     * ========================
+     * usage example:
+     * var P = linalg.expm(linalg.scale_(linalg.copy(Q), t)); <- the transition matrix exp(Q * t) of a Markov chain
+     * var L = linalg.logm(A); <- expm(L) == A
+     * var R = linalg.sqrtm(A); <- R * R == A
+     * ========================
+     *
+     * expm - the matrix exponential, by scaling and squaring with Pade approximants.
+     * logm - the principal logarithm, A must have no eigenvalues on the non positive real axis (throws otherwise).
+     * sqrtm - the principal square root, A must have no eigenvalues on the negative real axis (throws otherwise).
+     *
+     * @param matrix - the square input matrix
+     * @param out - optional - a matrix of the same shape and dtype to write the result into, may be matrix itself
+     * @returns {numjs_linalg.Matrix}
+     */
+    expm: function (matrix, out) {
+        return matrixFunction(linalg.expm, matrix, out);
+    },
+
+    logm: function (matrix, out) {
+        return matrixFunction(linalg.logm, matrix, out);
+    },
+
+    sqrtm: function (matrix, out) {
+        return matrixFunction(linalg.sqrtm, matrix, out);
+    },
+
+    /**
+     * Computes the (multiplicative) inverse of a square matrix
+     * =================
+     * usage example:
+     * var inverse = linalg.inv(mat); <- returns a new matrix
+     * linalg.inv(mat, inverse); <- writes the inverse into an existing matrix
+     * =================
+     *
+     * @param matrix - the square matrix to invert
+     * @param out - optional - a matrix of the same shape and dtype to write the result into, may be matrix itself
+     */
+    inv: function (matrix, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
+        }
+
+        out = outMatrix(out, matrix.rows, matrix.cols, matrix.dtype);
+        linalg.inv(matrix.data, matrix.rows, matrix.cols, out.data);
+        return out;
+    },
+
+    /**
+     * Cholesky decomposition.
+     *
+     * Return the Cholesky decomposition, L * L.H, of the square matrix a, where L is lower-triangular
+     * and .H is the conjugate transpose operator (which is the ordinary transpose if a is real-valued).
+     * a must be Hermitian (symmetric if real-valued) and positive-definite. Only L is actually returned.
+     * =================
+     * usage example:
+     * var jsMat = new linalg.Matrix([4, -1, 2, -1, 6, 0, 2, 0, 5], 3, 3); <- create a 3x3 Hermitian and positive-definite matrix
+     * var matrix = linalg.cholesky(jsMat); <-  return the lower-triangular Cholesky factor of jsMat
+     * =================
+     *
+     * @param matrix - the input matrix. Must be Hermitian (symmetric if all elements are real), positive-definite input matrix.
+     * @param out - optional - a matrix of the same shape and dtype to write the result into, may be matrix itself
+     * @return The lower-triangular Cholesky factor of a. Returns a matrix object if a is a matrix object.
+     */
+    cholesky: function (matrix, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
+        }
+
+        out = outMatrix(out, matrix.rows, matrix.cols, matrix.dtype);
+        linalg.cholesky(matrix.data, matrix.rows, matrix.cols, out.data);
+        return out;
+    },
+
+    /**
+     * Computes The sum along the diagonals of a matrix
+     * =================
+     * usage example:
+     * var inputMat = new linalg.Matrix([1, 1, 1, 1], 2, 2); <- create a new 2x2 ones matrix
+     * var trace = linalg.trace(inputMat); <- returns the matrix trace
+     * ================
+     *
+     * @param matrix - the input matrix to compute its trace
+     */
+    trace: function(matrix) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+
+        return linalg.trace(matrix.data, matrix.rows, matrix.cols);
+    },
+
+    /**
+     * Singular Value Decomposition.
+     * Factors the matrix a as u * np.diag(s) * v, where u and v are unitary and s is a 1-d array of a�s singular values.
+     * =================
+     * usage example:
+     * var jsMat = new linalg.Matrix([0.68, -0.211, 0.566, 0.597, 0.823, -0.605], 3, 2); <- create a new 3X2 matrix
+     * var svdObj = linalg.svd(jsMat, false, false); <- compute the Singular Value Decomposition (just s)
+     * or:
+     * var svdObj = linalg.svd(jsMat, false); <- compute the Singular Value Decomposition (just u,s,v, when u and v are thin)
+     * or:
+     * var svdObj = linalg.svd(jsMat); <- compute the Singular Value Decomposition (just u,s,v, when u and v are full)
+     * =================
+     *
+     * @param matrix - A real matrix of shape (M, N).
+     * @param full_matrices - bool, optional - If True (default), u and v have the shapes (M, M) and (N, N),
+     *                        respectively. Otherwise, the shapes are (M, K) and (K, N), respectively, where K = min(M, N).
+     * @param compute_uv - bool, optional - Whether or not to compute u and v in addition to s. True by default.
+     * @param out - optional - {u, s, v} holding the matrices (and the typed array for s) to write the results into,
+     *              any of them can be left out to have it allocated
+     * @param algorithm - optional - 'auto' (default) uses divide and conquer (BDCSVD) when both dimensions are above 64
+     *                    and the more accurate but much slower JacobiSVD otherwise, 'jacobi' and 'bdc' force one of them
+     * @returns object contains u, s, v:
+     *          u : Unitary matrices. The actual shape depends on the value of full_matrices.
+     *              Only returned when compute_uv is True.
+     *          s:  The singular values for every matrix, sorted in descending order (a Float64Array,
+     *              or a Float32Array for float32 matrices).
+     *          v: Unitary matrices. The actual shape depends on the value of full_matrices.
+     *          Only returned when compute_uv is True.
+     */
+    svd: function (matrix, full_matrices, compute_uv, out, algorithm) {
+        var outU = null, outS=null, outV=null, k=1;
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+        algorithm = svdAlgorithm(algorithm);
+
+        if(full_matrices === undefined || full_matrices === null){
+            full_matrices = true;
+        }
+        if(compute_uv === undefined || compute_uv === null){
+            compute_uv = true;
+        }
+
+        out = out || {};
+        k = Math.min(matrix.rows, matrix.cols);
+        outS = outArray(out.s, k, matrix.dtype);
+
+        if(compute_uv){
+            if(full_matrices){
+                outU = outMatrix(out.u, matrix.rows, matrix.rows, matrix.dtype);
+                outV = outMatrix(out.v, matrix.cols, matrix.cols, matrix.dtype);
+            }
+            else{
+                outU = outMatrix(out.u, matrix.rows, k, matrix.dtype);
+                outV = outMatrix(out.v, k, matrix.cols, matrix.dtype);
+            }
+        }
+
+        linalg.svd(matrix.data, matrix.rows, matrix.cols, full_matrices, compute_uv,
+                outU ? outU.data : outU, outS, outV ? outV.data : outV, algorithm);
+
+        return {u: outU, s: outS, v: outV};
+    },
+
+    /**
+     * Randomized truncated SVD, the k leading singular values and vectors of a (typically tall-skinny) matrix from
+     * a few products of the matrix with N x (k + oversample) blocks, e.g. for PCA, instead of a full svd.
+     * ========================
+     * usage example:
+     * var res = linalg.svd_k(data, 10); <- data ~ res.u * diag(res.s) * res.v'
+     * var res = linalg.svd_k(data, 10, 20, 4); <- more oversampling and power iterations for slowly decaying spectra
+     * ========================
+     *
+     * @param matrix - the M x N input matrix
+     * @param k - the number of singular triplets, 0 < k <= min(M, N)
+     * @param oversample - optional - the number of extra range samples, 10 by default
+     * @param power_iters - optional - the number of power iterations, 2 by default
+     * @param out - optional - {u, s, v} a M x k matrix, a typed array of k elements and a N x k matrix to write into
+     * @returns {{u, s, v}} - s in descending order, the columns of u and v are the singular vectors
+     */
+    svd_k: function (matrix, k, oversample, power_iters, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+        if (typeof k !== "number" || k % 1 !== 0 || k <= 0 || k > Math.min(matrix.rows, matrix.cols)) {
+            throw new Error("k must be an integer such that 0 < k <= min(M.rows, M.cols)");
+        }
+        if (oversample === undefined || oversample === null) {
+            oversample = 10;
+        }
+        if (power_iters === undefined || power_iters === null) {
+            power_iters = 2;
+        }
+        if (typeof oversample !== "number" || oversample % 1 !== 0 || oversample < 0 || oversample > 0xffffffff) {
+            throw new Error("oversample must be a non negative integer");
+        }
+        if (typeof power_iters !== "number" || power_iters % 1 !== 0 || power_iters < 0 || power_iters > 0xffffffff) {
+            throw new Error("power_iters must be a non negative integer");
+        }
+
+        out = out || {};
+        var outU = outMatrix(out.u, matrix.rows, k, matrix.dtype), outS = outArray(out.s, k, matrix.dtype),
+            outV = outMatrix(out.v, matrix.cols, k, matrix.dtype);
+        linalg.svd_k(matrix.data, matrix.rows, matrix.cols, k, oversample, power_iters, outU.data, outS, outV.data);
+        return {u: outU, s: outS, v: outV};
+    },
+
+    /**
+     * Computes the determinant of a square nxn matrix
+     * =================
+     * usage example:
+     * var inputMat = new linalg.Matrix([1, 1, 1, 1], 2, 2); <- create a new 2X2 ones matrix
+     * var det = linalg.det(inputMat); <- compute return the input matrix determinant value
+     * =================
      *
-     * @param array - an array of data to populate the newly built matrix
-     * @param rows - the newly built matrix number of rows
-     * @param cols - the newly built matrix number of cols
-     * @constructor
+     * @param matrix - the input matrix to compute its determinant
+     * @returns the determinant of the matrix
      */
-    Matrix: function (array, rows, cols, internalData) {
-        this.rows = rows;
-        this.cols = cols;
-        this.data = new Float64Array(rows * cols);
-
-        if (arguments.length > 3 && internalData && internalData["isEmpty"]) return;
+    det: function (matrix) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
 
-        if (array.length === 0) {
-            var defaultValue = (internalData && internalData["isOnes"])? 1.0 : 0.0;
-            for (var j = 0; j < rows * cols; j++) {
-                this.data[j] = defaultValue;
-            }
         }
-        else if (array.length === rows * cols) {
-            for (var i = 0; i < rows * cols; i++) {
-                this.data[i] = array[i];
-            }
-        }
-        else {
-            throw new Error("The array.length !== rows*cols");
+        matrix = dense(matrix);
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
 
         }
+        return linalg.det(matrix.data, matrix.rows, matrix.cols);
     },
 
     /**
-     * Creates a new zero filled matrix with the shape specified by number of rows and cols
-     * =======================
+     * Computes The input matrix rank using SVD method
+     *
+     * =====================
      * usage example:
-     * var newMat = numjs_linalg.zeros(3,4); <- creates a new 3X4 zero filled matrix
-     * var newMat = numjs_linalg.zeros(3); <- creates a new 3X3 zero filled matrix
-     * var zeroVector = numjs_linalg.zeros(1, 4) <- creates a new zero filled vector
-     * var zeroScalar = numjs_linalg.zeros(1) <- creates a 0 value scalar
-     * =======================
+     * var inputMat = new linalg.Matrix([1, 1, 1, 1], 1, 4); <- creates a new 1X4 ones vector
+     * var rank = linalg.matrix_rank(inputMat); <- calculates the rank
+     * =====================
      *
-     * @param rows - the number of rows for the newly built matrix
-     * @param cols - the number of cols for the newly built matrix - OPTIONAL - defaults to rows
-     * @returns {numjs_linalg.Matrix}
+     * @param matrix - the input matrix to compute its rank
+     * @param tol - Number which represents the threshold which SVD values are considered zero.
+     *              If this arg is not given, and input matrix has only singular values,
+     *              and eps is the epsilon value for datatype of the matrix,
+     *              then tol is set to matrix.max() * max(matrix.shape) * eps
+     * @param method - optional - 'svd' (default), or the faster rank revealing 'qr' (column pivoting QR) and
+     *                 'lu' (full pivoting LU) which count the pivots above tol instead of the singular values
      */
-    zeros: function(rows, cols) {
-        if (!rows)  {
-            throw new Error("now input parameters given");
+    matrix_rank: function (matrix, tol, method) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+
+        }
+        if (method !== undefined && !RANK_METHODS.hasOwnProperty(method)) {
+            throw new Error("method must be 'svd', 'qr' or 'lu'");
         }
+        matrix = dense(matrix);
+        return linalg.matrix_rank(matrix.data, matrix.rows, matrix.cols, tol && !isNaN(tol) ? tol : undefined,
+            RANK_METHODS[method || "svd"]);
+    },
 
-        if (!cols) {
-            cols = rows;
+    /**
+     * Least squares solution of A * X = B, of minimum norm when A is rank deficient, by a complete orthogonal
+     * decomposition. A can be non square and B can hold several right hand sides.
+     * ========================
+     * usage example:
+     * var X = linalg.lstsq(A, B); <- A is M x N, B is M x K, X is N x K
+     * var x = linalg.lstsq(A, new Float64Array([1, 2, 3])); <- a typed array b gives a typed array x
+     * ========================
+     *
+     * @param matrix - the M x N matrix A
+     * @param b - a M x K Matrix, or a typed array of M elements (converted to the dtype of matrix)
+     * @param tol - optional - pivots below tol times the largest one are considered zero
+     * @param out - optional - a N x K matrix (or a typed array of N elements) to write X into
+     * @returns {numjs_linalg.Matrix} X, or a typed array when b is one
+     */
+    lstsq: function (matrix, b, tol, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
         }
+        matrix = dense(matrix);
 
-        if (rows <= 0 || cols <= 0) {
-            throw new Error("rows and cols parameters must be positive numbers");
+        var isMatrix = b instanceof numjs_linalg.Matrix, nrhs = isMatrix ? b.cols : 1, data, x;
+        if ((isMatrix ? b.rows : b.length) !== matrix.rows) {
+            throw new Error("matrix and the parameter dimensions must agree.");
+        }
+        if (isMatrix) {
+            commonDtype(matrix, b);
+            data = dense(b).data;
+            x = outMatrix(out, matrix.cols, nrhs, matrix.dtype);
+        }
+        else {
+            data = asDtype(b, matrix.dtype);
+            x = outArray(out, matrix.cols, matrix.dtype);
         }
 
-        return new numjs_linalg.Matrix([], rows, cols);
+        linalg.lstsq(matrix.data, matrix.rows, matrix.cols, data, nrhs, isMatrix ? x.data : x, tol);
+        return x;
     },
 
     /**
-     * Creates a new one-value filled matrix with the shape specified by number of rows and cols
-     * =======================
+     * The Moore-Penrose pseudo inverse of a (possibly non square or rank deficient) matrix, by a complete
+     * orthogonal decomposition instead of an SVD.
+     * ========================
      * usage example:
-     * var newMat = numjs_linalg.ones(3,4); <- creates a new 3X4 one-value filled matrix
-     * var newMat = numjs_linalg.ones(3); <- creates a new 3X3 one-value filled matrix
-     * var oneVector = numjs_linalg.ones(1, 4) <- creates a new ones filled vector
-     * var oneScalar = numjs_linalg.ones(1) <- creates a 1 value scalar
+     * var P = linalg.pinv(A); <- A is M x N, P is N x M
      * ========================
      *
-     * @param rows - the number of rows for the newly built matrix
-     * @param cols - the number of cols for the newly built matrix - optional - defaults to rows
+     * @param matrix - the M x N input matrix
+     * @param tol - optional - pivots below tol times the largest one are considered zero
+     * @param out - optional - a N x M matrix to write the result into
      * @returns {numjs_linalg.Matrix}
      */
-    ones: function(rows, cols) {
-        if (!rows)  {
-            throw new Error("now input parameters given");
+    pinv: function (matrix, tol, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
         }
+        matrix = dense(matrix);
 
-        if (!cols) {
-            cols = rows;
+        out = outMatrix(out, matrix.cols, matrix.rows, matrix.dtype);
+        linalg.pinv(matrix.data, matrix.rows, matrix.cols, out.data, tol);
+        return out;
+    },
+
+    /**
+     * Solve linear equation system
+     * ========================
+     * usage example:
+     * var A = linalg.eye(3,3); <- create a 3x3 eye matrix
+     * var resMat = linalg.matrix_eigen_values(A); <- get the values of x in A*x=b system of equations
+     * ========================
+     *
+     * @param matrix - the matrix whos eigen values we wish to find
+     * @param out - optional - a typed array of the matrix dtype with 2 * matrix.cols elements to write the result into
+     * @returns {Float64Array} such that every pair is the real and imaginary part of an eigen value
+     *          (a Float32Array for float32 matrices).
+     */    
+    matrix_eigen_values: function (matrix, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
         }
+        var eigenTestResult = outArray(out, 2 * matrix.cols, matrix.dtype);
+        linalg.get_eigen_values(matrix.rows, matrix.cols, matrix.data, eigenTestResult);
+        return eigenTestResult;
+    },
 
-        if (rows <= 0 || cols <= 0) {
-            throw new Error("rows and cols parameters must be positive numbers");
+    /**
+     * Eigenvalues and eigenvectors of a symmetric matrix, e.g. a covariance matrix. Real valued and much faster
+     * than matrix_eigen_values, only the lower triangle of matrix is read.
+     * ========================
+     * usage example:
+     * var res = linalg.eigh(cov); <- res.values in increasing order, column i of res.vectors is the eigenvector of values[i]
+     * var values = linalg.eigh(cov, false).values; <- skip the eigenvectors
+     * ========================
+     *
+     * @param matrix - the symmetric matrix
+     * @param compute_vectors - bool, optional - whether to compute the eigenvectors, true by default
+     * @param out - optional - {values, vectors} the typed array (matrix.cols elements) and matrix to write into
+     * @returns {{values, vectors}} - vectors is null when compute_vectors is false
+     */
+    eigh: function (matrix, compute_vectors, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
+        }
+        if (compute_vectors === undefined || compute_vectors === null) {
+            compute_vectors = true;
         }
 
-        return new numjs_linalg.Matrix([], rows, cols, {isOnes:true});
+        out = out || {};
+        var values = outArray(out.values, matrix.cols, matrix.dtype),
+            vectors = compute_vectors ? outMatrix(out.vectors, matrix.rows, matrix.cols, matrix.dtype) : null;
+        linalg.eigh(matrix.data, matrix.rows, compute_vectors, values, vectors ? vectors.data : null);
+        return {values: values, vectors: vectors};
     },
 
+    /**
+     * Eigenvalues and eigenvectors of a general square matrix. Both are complex, stored as (real, imaginary) pairs
+     * like the result of matrix_eigen_values.
+     * ========================
+     * usage example:
+     * var res = linalg.eig(A); <- res.values[2 * i], res.values[2 * i + 1] is eigenvalue i
+     * var re = res.vectors[2 * (j * n + i)]; <- the real part of element i of the eigenvector of eigenvalue j
+     * ========================
+     *
+     * @param matrix - the square matrix
+     * @param out - optional - {values, vectors} typed arrays of 2 * n and 2 * n * n elements to write into
+     * @returns {{values, vectors}} - typed arrays of the matrix dtype
+     */
+    eig: function (matrix, out) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        matrix = dense(matrix);
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
+        }
+
+        out = out || {};
+        var values = outArray(out.values, 2 * matrix.cols, matrix.dtype),
+            vectors = outArray(out.vectors, 2 * matrix.cols * matrix.cols, matrix.dtype);
+        linalg.eig(matrix.data, matrix.rows, values, vectors);
+        return {values: values, vectors: vectors};
+    },
 
     /**
-     * Creates a new empty matrix, with no initialized values within it.
-     * ===================
+     * The k largest (or smallest) eigenpairs of a symmetric Matrix or SparseMatrix by the thick restart Lanczos
+     * method. Only products with the matrix are used, so the leading eigenpairs of a large (or sparse) matrix cost
+     * a small multiple of k products with it instead of a full O(n^3) eigh.
+     * ========================
      * usage example:
-     * var emptyMat = numjs_linalg.empty(3, 3); <- creates a 3x3 empty matrix
-     * var nonSquareEmpty = numjs_linalg.empty(3, 4); <- creates a 3x4 empty matrix
-     * var emptySquareMat = numjs_linalg.empty(5); <-creates a 5x5 empty matrix
-     * ===================
+     * var res = linalg.eigsh(cov, 10); <- res.values largest first, column i of res.vectors (n x 10) goes with values[i]
+     * var fiedler = linalg.eigsh(laplacian, 2, {which: 'smallest'}).vectors; <- smallest first
+     * ========================
      *
-     * @param rows - the number of matrix rows
-     * @param cols - the number of matrix cols - optional - defaults to rows
+     * @param matrix - the symmetric Matrix or SparseMatrix
+     * @param k - the number of eigenpairs, 0 < k < matrix.rows
+     * @param options - optional - {which: 'largest' (default) or 'smallest',
+     *                              ncv: the size of the Krylov basis, k < ncv <= n, defaults to max(2 * k + 1, 20),
+     *                              tol: the relative residual to reach, defaults to 1e-12 (1e-5 for float32),
+     *                              maxIterations: the maximum number of restarts, defaults to 1000,
+     *                              vectors: whether to compute the eigenvectors, true by default,
+     *                              out: {values, vectors} a typed array of k elements and a n x k matrix to write into}
+     * @returns {{values, vectors, converged, iterations}} - not converging is reported, not thrown
      */
-    empty: function(rows, cols) {
-        if (!rows) {
-            throw new Error("input parameters are undefined")
+    eigsh: function (matrix, k, options) {
+        var isSparse = matrix instanceof numjs_linalg.SparseMatrix;
+
+        if (!isSparse && !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix or numjs.SparseMatrix");
+        }
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
+        }
+        if (typeof k !== "number" || k % 1 !== 0 || k <= 0 || k >= matrix.rows) {
+            throw new Error("k must be an integer such that 0 < k < matrix.rows, use eigh for all the eigenpairs");
         }
 
-        if (!cols) {
-            cols = rows;
+        options = options || {};
+        if (options.which && options.which !== "largest" && options.which !== "smallest") {
+            throw new Error("which must be 'largest' or 'smallest'");
         }
 
-        if (rows <= 0 || cols <= 0) {
-            throw new Error("rows and cols parameters must be positive");
+        var out = options.out || {}, which = options.which || "largest",
+            ncv = options.ncv || Math.min(matrix.rows, Math.max(2 * k + 1, 20)),
+            values = outArray(out.values, k, matrix.dtype),
+            vectors = options.vectors === false ? null : outMatrix(out.vectors, matrix.rows, k, matrix.dtype),
+            args = [k, which === "largest", ncv, options.tol || 0,
+                options.maxIterations === undefined ? 1000 : options.maxIterations, values, vectors ? vectors.data : null],
+            res;
+
+        if (isSparse) {
+            res = linalg.sparse_top_eigen.apply(null, sparseArgs(matrix).concat(args));
+        }
+        else {
+            res = linalg.top_eigen.apply(null, [matrix.rows, matrix.cols, matrix.data].concat(args,
+                [leadingDim(matrix), !!matrix.transposed]));
         }
 
-        return new numjs_linalg.Matrix([], rows, cols, {isEmpty: true});
+        res.values = values;
+        res.vectors = vectors;
+        return res;
     },
-
+    
     /**
-     * Computes the Dot product of matrices.
-     * For 2-D matrices it is equivalent to matrix multiplication,
-     * and for 1-D matrix it is equivalent to inner product of vectors
-     * ==================
+     * Solve linear equation system
+     * ========================
      * usage example:
-     * var jsMatLeft = linalg.ones([1, 1, 1, 1], 1, 4); <- creates a ones vector
-     * var jsMatRight = new linalg.Matrix([2, 2, 1, 1], 4, 1); <- creates a custom values vector
-     * var dotproduct = linalg.dot(jsMatLeft, jsMatRight) <- computes the dot product == 6
+     * var A = linalg.eye(3,3); <- create a 3x3 eye matrix
+     * var b = new Float64Array([1,2,3]); <- create the 
+     * var resMat = linalg.matrix_solve_linear(A, b); <- get the values of x in A*x=b system of equations
+     * var X = linalg.matrix_solve_linear(A, B); <- a 3xk matrix B gives the 3xk X of A*X=B, all columns in one call
+     * ========================
      *
-     * var jsMatRight = new linalg.Matrix([2, 2, 1, 1], 2, 2); <- creates a new custom values matrix
-     * var dotproduct = linalg.dot(2, jsMatRight); <- computes the dot product of the matrix with a number
-     * ==================
+     * @param matrix - the matrix defining the coefficients  
+     * @param b - the constraint vector as a Float64Array in the 
+     *            (converted to the dtype of matrix when it is another array type),
+     *            or a Matrix with matrix.rows rows holding one constraint vector per column
+     * @param out - optional - a typed array of the matrix dtype with matrix.cols elements to write x into, may be b itself
+     *              (a matrix.cols x b.cols Matrix when b is a Matrix)
+     * @returns {Float64Array} such every value is the x_i respective value (a Float32Array for float32 matrices),
+     *          or a Matrix of the solutions when b is a Matrix.
+     */    
+    matrix_solve_linear: function (matrix, b, out) {
+        var args = solveArgs(matrix, b, out);
+        linalg.solve_linear_system_householder_qr(matrix.rows, matrix.cols, matrix.data, args.b, args.x,
+            leadingDim(matrix), !!matrix.transposed);
+        return args.result;
+    },
+
+    /**
+     * Multiplies two matrices
+     * ========================
+     * usage example:
+     * var mat1 = linalg.ones(3,3); <- create a 3x3 ones matrix
+     * var mat2 = linalg.ones(3,3); <- create a 3x3 ones matrix
+     * var resMat = linalg.matrix_mul(mat1, mat2); <- create a matrix which is the product of the two matrices multiplication
+     * ========================
      *
-     * @param leftMatrix - The left input matrix to perform dot computation
-     * @param rightMatrix - The right input matrix to perform dot computation
-     * @param out - The dot product of two input matrices
+     * @param matrixA - the first input matrix
+     * @param matrixB - the second input matrix
+     * @param out - optional - a matrixA.rows x matrixB.cols matrix to write the product into, may be one of the inputs
+     * @returns {numjs_linalg.Matrix}
      */
-    dot: function (leftMatrix, rightMatrix, out) {
-        var lrows = 1, lcols = 1, rrows = 1, rcols = 1;
-
-        if (!leftMatrix || !rightMatrix) {
-            throw new Error("The input parameters are undefined");
-
+    matrix_mul: function (matrixA, matrixB, out) {
+        if (!matrixA || !(matrixA instanceof numjs_linalg.Matrix) || !matrixB || !(matrixB instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        if (matrixA.cols !== matrixB.rows) {
+            throw new Error("matrix and the parameter dimensions must agree, i.e. matrixA.cols == matrixB.rows");
         }
+        out = outMatrix(out, matrixA.rows, matrixB.cols, commonDtype(matrixA, matrixB));
+        linalg.mat_mul(matrixA.rows, matrixA.cols, matrixA.data, matrixB.rows, matrixB.cols, matrixB.data, out.data,
+            leadingDim(matrixA), !!matrixA.transposed, leadingDim(matrixB), !!matrixB.transposed);
+        return out;
+    },
 
-        if (!isNaN(leftMatrix) && !isNaN(rightMatrix)) {
-            return leftMatrix * rightMatrix;
+    /**
+     * Views.
+     * block and transpose return matrices which share the data of their input instead of copying it: writes to the
+     * input show through the view. dot, inner, matrix_mul, matrix_solve_linear, the factorizations and expr read
+     * views in place (a transposed view is handed to GEMM as a transpose); the other functions copy a view before
+     * working on it, and views cannot be used as out parameters. copy returns a new dense matrix.
+     * ========================
+     * usage example:
+     * var top = linalg.block(A, 0, 0, 2, A.cols); <- the first two rows of A
+     * var AtB = linalg.matrix_mul(linalg.transpose(A), B); <- A'*B without copying A
+     * var dense = linalg.copy(top); <- a new 2 x A.cols matrix
+     * ========================
+     *
+     * @param matrix - the matrix (or view) to take a view of
+     * @param row - the first row of the block
+     * @param col - the first col of the block
+     * @param rows - the number of rows of the block
+     * @param cols - the number of cols of the block
+     */
+    block: function (matrix, row, col, rows, cols) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        if (!(row >= 0 && col >= 0 && rows > 0 && cols > 0) || row + rows > matrix.rows || col + cols > matrix.cols) {
+            throw new Error("The block must lie inside the matrix");
         }
 
-        if (leftMatrix instanceof numjs_linalg.Matrix) {
-            lrows = leftMatrix.rows;
-            lcols = leftMatrix.cols;
+        var ld = leadingDim(matrix);
+        if (matrix.transposed) {
+            return makeView(matrix, row * ld + col, rows, cols, ld, true);
         }
-        else if (isNaN(leftMatrix)) {
-            throw new Error("The leftMatrix parameter is not instance of Matrix or a number");
+        return makeView(matrix, col * ld + row, rows, cols, ld, false);
+    },
 
+    transpose: function (matrix) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
         }
 
-        if (rightMatrix instanceof numjs_linalg.Matrix) {
-            rrows = rightMatrix.rows;
-            rcols = rightMatrix.cols;
+        return makeView(matrix, 0, matrix.cols, matrix.rows, leadingDim(matrix), !matrix.transposed);
+    },
+
+    copy: function (matrix) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
         }
-        else if (isNaN(rightMatrix)) {
-            throw new Error("The rightMatrix parameter is not instance of Matrix or a number");
 
-        }
+        return toExpr(matrix).eval();
+    },
+
+    /**
+     * Starts a lazily evaluated expression. Nothing is computed until eval, which runs the whole formula in one
+     * native call: products go straight into the result and the other terms are added to it without temporaries.
+     * Expressions support add(x), sub(x), mul(x) (matrix product, or scaling by a number), scale(s) and transpose(),
+     * where x is a Matrix or another expression.
+     * ========================
+     * usage example:
+     * var res = linalg.expr(A).mul(B).add(linalg.expr(C).scale(s)).eval(); <- A*B + s*C
+     * linalg.expr(A).transpose().mul(B).sub(C).eval(out); <- A'*B - C written into out
+     * ========================
+     *
+     * @param matrix - the first operand
+     * @returns an expression object, eval(out) returns the result (written into out when given)
+     */
+    expr: function (matrix) {
+        return toExpr(matrix);
+    },
+
+    /**
+     * In-place variants.
+     * Overwrite the input matrix with the result instead of allocating a new one, the same as passing the
+     * matrix as the out parameter of inv, cholesky, tril, triu and dot. They return the input matrix.
+     * ========================
+     * usage example:
+     * linalg.inv_(mat); <- mat now holds its inverse
+     * linalg.scale_(mat, 0.5); <- halves every element of mat
+     * ========================
+     *
+     * @param matrix - the matrix to overwrite
+     */
+    inv_: function (matrix) {
+        return numjs_linalg.inv(matrix, matrix);
+    },
+
+    cholesky_: function (matrix) {
+        return numjs_linalg.cholesky(matrix, matrix);
+    },
 
-        if (!out) {
-            var newRows = lrows, newCols = rcols;
+    tril_: function (matrix) {
+        return numjs_linalg.tril(matrix, matrix);
+    },
 
-            if (!isNaN(leftMatrix) && isNaN(rightMatrix)) {// scalar*mat
-                newRows = rrows;
-                newCols = rcols;
-            }
-            else if (!isNaN(leftMatrix) && isNaN(rightMatrix)) {// mat*scalar
-                newRows = lrows;
-                newCols = lcols;
-            }
+    triu_: function (matrix) {
+        return numjs_linalg.triu(matrix, matrix);
+    },
 
-            out = new numjs_linalg.Matrix([], newRows, newCols);
+    scale_: function (matrix, scalar) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
         }
-        else if (!out instanceof numjs_linalg.Matrix) {
-            throw new Error("The out parameter is not instance of Matrix");
-
+        if (typeof scalar !== "number") {
+            throw new Error("scalar must be a number");
         }
-
-        var isSuc = linalg.dot(lrows, lcols, leftMatrix.data ? leftMatrix.data : leftMatrix,
-            rrows, rcols, rightMatrix.data ? rightMatrix.data : rightMatrix, out.data);
-
-        if (out.rows * out.cols === 1) {
-            return out.data[0];
+        if (!isDense(matrix)) {
+            throw new Error("The in-place variants need a dense matrix, not a view");
         }
 
-        return out;
+        linalg.dot(1, 1, scalar, matrix.rows, matrix.cols, matrix.data, matrix.data);
+        return matrix;
     },
 
     /**
-     * Computes the ordinary inner product of vectors for 1-D matrices, or in 2 dimensions, computes the sum product
-     * over the last axes. (i.e. sum of left.row[i] * right.row[j])
-     * If a or b are scalars, computes a*b.
-     * NOTE: If a and b are nonscalar, their last dimensions of must match. (i.e. the number of cols)
-     * ==================
+     * Factorizations.
+     * Factorize a matrix once in native memory and solve against it many times, each solve costs O(n^2)
+     * instead of the O(n^3) of matrix_solve_linear. The returned object has:
+     *   rows, cols - the shape of the factorized matrix
+     *   solve(b) - returns x such that A * x = b. b is a Float64Array (Float32Array for float32 matrices) holding
+     *              one or more right hand sides of A.rows elements each, stored one after the other.
+     *   solveInto(b, out) - same as solve, writes x into out (A.cols elements per right hand side)
+     *   determinant() - the determinant of A
+     *   logDeterminant() - log |det(A)|, finite for large matrices whose determinant overflows
+     *   rcond() - an estimate of the reciprocal condition number of A (close to 0 for ill conditioned matrices)
+     *   rankUpdate(v, sigma) - cholesky_factor and ldlt only: refactors A + sigma * v * v' in O(n^2) from the current
+     *              factors, e.g. to add (sigma = 1, the default) or remove (sigma = -1) an observation of a streaming
+     *              least squares fit. v is a typed array of A.rows elements in the dtype of A. A downdate which leaves
+     *              a cholesky_factor matrix not positive definite throws and keeps the factors.
+     * ========================
      * usage example:
-     * Compute the sum product over the second axes of two 2-D matrices
-     * var jsMatLeft = new linalg.Matrix([1, 4, 2, 5, 3, 6], 2, 3); <- creates a new 2x3 matrix
-     * var jsMatRight = new linalg.Matrix([7, 10,8, 11,9, 12], 2, 3); <- creates a new 2x3 matrix
-     * var matrix = linalg.inner(jsMatLeft, jsMatRight); compute the sum product over the second axes
+     * var lu = linalg.lu(A); <- factorize A once
+     * var x = lu.solve(new Float64Array([1, 2, 3])); <- then solve for as many right hand sides as needed
+     * lu.solveInto(b, x); <- reusing the output buffer
+     * var llt = linalg.cholesky_factor(XtX); llt.rankUpdate(x); <- XtX + x * x' without refactorizing
+     * ========================
      *
-     * Compute the inner product of two 1-D matrices
-     * var jsMatLeft = new linalg.Matrix([1, 1, 1, 1], 1, 4); <- creates a new 1x4 matrix (vector)
-     * var jsMatRight = new linalg.Matrix([2, 2, 1, 1], 1, 4); <- creates a new 1x4 matrix (vector)
-     * var innerProduct = linalg.inner(2, jsMatRight); <- computes the inner product of the matrices
-     * ==================
+     * lu - LU decomposition with partial pivoting, A must be square and invertible.
+     * qr - Householder QR decomposition, A can be non square, solve then returns the least squares solution.
+     * cholesky_factor - LLT decomposition, A must be symmetric positive definite (throws otherwise).
+     * ldlt - LDLT decomposition with pivoting, A must be symmetric positive or negative semidefinite.
      *
-     * @param leftMatrix - The left input matrix to perform inner/sum product computation
-     * @param rightMatrix - The right input matrix to perform inner/sum product computation
-     * @param out - The inner/sum product of two input matrices
+     * @param matrix - the matrix to factorize
      */
-    inner: function (leftMatrix, rightMatrix) {
-        var lrows = 1, lcols = 1, rrows = 1, rcols = 1, newRows, newCols, out;
-
-        if (!leftMatrix || !rightMatrix) {
-            throw new Error("The input parameters are undefined");
-        }
-
-        // In case left matrix and right matrix are both scalars
-        if (!isNaN(leftMatrix) && !isNaN(rightMatrix)) {
-            return leftMatrix * rightMatrix;
-        }
-
-        if (leftMatrix instanceof numjs_linalg.Matrix) {
-            lrows = leftMatrix.rows;
-            lcols = leftMatrix.cols;
+    lu: function (matrix) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
         }
-        else if (isNaN(leftMatrix)) {
-            throw new Error("The leftMatrix parameter is not instance of Matrix or a number");
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
         }
 
-        if (rightMatrix instanceof numjs_linalg.Matrix) {
-            rrows = rightMatrix.rows;
-            rcols = rightMatrix.cols;
-        }
-        else if (isNaN(rightMatrix)) {
-            throw new Error("The rightMatrix parameter is not instance of Matrix or a number");
-        }
+        return linalg.lu(matrix.data, matrix.rows, matrix.cols, leadingDim(matrix), !!matrix.transposed);
+    },
 
-        if(isNaN(leftMatrix) && isNaN(rightMatrix) && rightMatrix.cols !== leftMatrix.cols){
-            throw new Error("The last dimensions of left and right matrices must match");
+    qr: function (matrix) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
         }
 
-        newRows = lrows;
-        newCols = rrows;
+        return linalg.qr(matrix.data, matrix.rows, matrix.cols, leadingDim(matrix), !!matrix.transposed);
+    },
 
-        // In case left matrix is scalar
-        if (!isNaN(leftMatrix) && isNaN(rightMatrix)) {// scalar*mat
-            newRows = rrows;
-            newCols = rcols;
+    cholesky_factor: function (matrix) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
         }
-        // In case right matrix is scalar
-        else if (!isNaN(leftMatrix) && isNaN(rightMatrix)) {// mat*scalar
-            newRows = lrows;
-            newCols = lcols;
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
         }
 
-        // Create new matrix for the results
-        out = new numjs_linalg.Matrix([], newRows, newCols);
-
-        var isSuc = linalg.inner(lrows, lcols, leftMatrix.data ? leftMatrix.data : leftMatrix,
-            rrows, rcols, rightMatrix.data ? rightMatrix.data : rightMatrix, out.data);
+        return linalg.cholesky_factor(matrix.data, matrix.rows, matrix.cols, leadingDim(matrix), !!matrix.transposed);
+    },
 
-        if (out.rows * out.cols === 1) {
-            return out.data[0];
+    ldlt: function (matrix) {
+        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+            throw new Error("The first arg must be instanceof numjs.Matrix");
+        }
+        if (matrix.rows !== matrix.cols) {
+            throw new Error("matrix must be square, i.e. M.rows == M.cols");
         }
 
-        return out;
+        return linalg.ldlt(matrix.data, matrix.rows, matrix.cols, leadingDim(matrix), !!matrix.transposed);
     },
 
     /**
-     * Compute the outer product of two 1-D matrices. (i.e. out[i, j] = a[i] * b[j])
-     * If a or b are scalars, computes a*b.
-     * ==================
+     * Accumulates X' * X, the column means, covariance and correlation of a data matrix X of d columns fed in
+     * chunks of rows, without ever holding X: memory is O(d^2) whatever the number of rows. Every chunk is added
+     * by a native symmetric rank-k update (half the flops of X' * X through matrix_mul) in double precision.
+     * The returned object has:
+     *   add(rows) - adds rows, a Matrix of d columns or a typed array or array of whole rows of d elements stored
+     *               one row after the other. Returns the accumulator, so calls can be chained.
+     *   count() - the number of rows added so far
+     *   gram(out) - X' * X as a d x d Matrix
+     *   covariance(ddof, out) - the covariance matrix, divided by count() - ddof (ddof is 1 by default)
+     *   correlation(out) - the correlation matrix, NaN for the columns with no variance
+     *   mean(out) - the column means as a typed array of d elements
+     *   reset() - forgets every row
+     * Results can be read at any time and more rows added afterwards.
+     * ========================
      * usage example:
-     * var jsMatLeft = new linalg.Matrix([1, 1, 1, 1], 1, 4); <- creates a new 1x4 matrix (vector)
-     * var jsMatRight = new linalg.Matrix([2, 2, 1, 1], 1, 4); <- creates a new 1x4 matrix (vector)
-     * var matrix = linalg.outer(jsMatLeft, jsMatRight); <- computes the outer product of the two matrices
-     * ==================
+     * var acc = linalg.gram_accumulator(3);
+     * acc.add(new Float64Array([1, 2, 3, 4, 5, 6])).add(new Float64Array([7, 8, 10])); <- three rows in two chunks
+     * var C = acc.covariance(); <- 3 x 3 Matrix
+     * ========================
      *
-     * @param leftVector - The left input 1-D matrix to perform outer product computation.
-     *                      Input is flattened if not already 1-dimensional.
-     * @param rightVector - The right input 1-D matrix to perform outer product computation.
-     *                      Input is flattened if not already 1-dimensional.
-     * @return The ordinary outer product of two vectors.
+     * @param d - the number of columns of the data
+     * @param dtype - the dtype of the results, 'float64' by default
      */
-    outer: function (leftVector, rightVector, out) {
-        var lrows = 1, lcols = 1, rrows = 1, rcols = 1, newRows, newCols;
-
-        if (!leftVector || !rightVector) {
-            throw new Error("The input parameters are undefined");
+    gram_accumulator: function (d, dtype) {
+        dtype = dtype === undefined || dtype === null ? "float64" : dtype;
+        if (typeof d !== "number" || d < 1 || Math.floor(d) !== d) {
+            throw new Error("d must be a positive integer");
         }
-
-        // In case left matrix and right matrix are both scalars
-        if (!isNaN(leftVector) && !isNaN(rightVector)) {
-            return leftVector * rightVector;
+        if (!dtypes.hasOwnProperty(dtype)) {
+            throw new Error("dtype must be 'float32' or 'float64'");
         }
 
-        if (leftVector instanceof numjs_linalg.Matrix) {
-            lrows = leftVector.rows * leftVector.cols;
-            lcols = 1;
-        }
-        else if (isNaN(leftVector)) {
-            throw new Error("The leftMatrix parameter is not instance of Matrix or a number");
-        }
+        return new GramAccumulator(d, dtype);
+    },
 
-        if (rightVector instanceof numjs_linalg.Matrix) {
-            if (leftVector instanceof numjs_linalg.Matrix){
-                rrows = 1;
-                rcols = rightVector.rows * rightVector.cols;
-            }
-            else {
-                rrows = rightVector.rows;
-                rcols = rightVector.cols;
-            }
-        }
-        else if (isNaN(rightVector)) {
-            throw new Error("The rightMatrix parameter is not instance of Matrix or a number");
+    /**
+     * Builds a SparseMatrix from (row, col, value) triplets in any order, duplicates are summed.
+     * ========================
+     * usage example:
+     * var S = linalg.sparse(3, 3, [0, 1, 2, 0], [0, 1, 2, 0], [1, 2, 3, 1]); <- diag(2, 2, 3), CSC
+     * var R = linalg.sparse(3, 3, rows, cols, values, {format: 'csr', dtype: 'float32'});
+     * ========================
+     *
+     * @param rows - the number of rows of the matrix
+     * @param cols - the number of cols of the matrix
+     * @param rowIndices - the row index of every triplet
+     * @param colIndices - the col index of every triplet
+     * @param values - the value of every triplet
+     * @param internalData - optional - {format: 'csc' | 'csr', dtype: 'float32' | 'float64'}
+     * @returns {numjs_linalg.SparseMatrix}
+     */
+    sparse: function (rows, cols, rowIndices, colIndices, values, internalData) {
+        var format = (internalData && internalData["format"]) || "csc",
+            dtype = (internalData && internalData["dtype"]) || (values instanceof Float32Array ? "float32" : "float64");
+
+        if (!dtypes.hasOwnProperty(dtype)) {
+            throw new Error("dtype must be 'float32' or 'float64'");
         }
 
-        if (!out) {
-            newRows = lrows;
-            newCols = rcols;
+        var res = linalg.sparse_from_triplets(rows, cols, new Int32Array(rowIndices), new Int32Array(colIndices),
+            values instanceof dtypes[dtype] ? values : new dtypes[dtype](values), format === "csr");
+        return new numjs_linalg.SparseMatrix(rows, cols, res.indptr, res.indices, res.values,
+            {format: format, dtype: dtype, isValid: true});
+    },
 
-            // In case left matrix is scalar
-            if (!isNaN(leftVector) && isNaN(rightVector)) {// scalar*mat
-                newRows = rrows;
-                newCols = rcols;
-            }
-            // In case right matrix is scalar
-            else if (!isNaN(leftVector) && isNaN(rightVector)) {// mat*scalar
-                newRows = lrows;
-                newCols = lcols;
-            }
+    /**
+     * Multiplies sparse and dense matrices: sparse * sparse gives a SparseMatrix (in the format of the left
+     * one), sparse * dense and dense * sparse give a dense Matrix.
+     * ========================
+     * usage example:
+     * var y = linalg.sparse_dot(S, x); <- S * x for a sparse S and a dense x
+     * var S2 = linalg.sparse_dot(S, S); <- sparse result
+     * ========================
+     *
+     * @param left - the left SparseMatrix or Matrix
+     * @param right - the right SparseMatrix or Matrix, at least one of them must be sparse
+     * @param out - optional - a dense matrix of the result shape to write a dense result into
+     */
+    sparse_dot: function (left, right, out) {
+        var isLeftSparse = left instanceof numjs_linalg.SparseMatrix, isRightSparse = right instanceof numjs_linalg.SparseMatrix;
 
-            out = new numjs_linalg.Matrix([], newRows, newCols);
+        if (!(isLeftSparse || left instanceof numjs_linalg.Matrix) || !(isRightSparse || right instanceof numjs_linalg.Matrix) ||
+            !(isLeftSparse || isRightSparse)) {
+            throw new Error("The arguments must be SparseMatrix or Matrix instances, at least one of them sparse");
         }
-        else if (!out instanceof numjs_linalg.Matrix) {
-            throw new Error("The out parameter is not instance of Matrix");
+        if (left.cols !== right.rows) {
+            throw new Error("matrix dimensions must agree, i.e. left.cols == right.rows");
         }
 
-        var isSuc = linalg.outer(lrows, lcols, leftVector.data ? leftVector.data : leftVector,
-            rrows, rcols, rightVector.data ? rightVector.data : rightVector, out.data);
+        var dtype = commonDtype(left, right);
 
-        if (out.rows * out.cols === 1) {
-            return out.data[0];
+        if (isLeftSparse && isRightSparse) {
+            var res = linalg.sparse_sparse_mul.apply(null, sparseArgs(left).concat(sparseArgs(right), [left.format === "csr"]));
+            return new numjs_linalg.SparseMatrix(left.rows, right.cols, res.indptr, res.indices, res.values,
+                {format: left.format, dtype: dtype, isValid: true});
         }
 
+        out = outMatrix(out, left.rows, right.cols, dtype);
+        if (isLeftSparse) {
+            right = dense(right);
+            linalg.sparse_dense_mul.apply(null, sparseArgs(left).concat([right.cols, right.data, out.data]));
+        }
+        else {
+            left = dense(left);
+            linalg.dense_sparse_mul.apply(null, [left.rows, left.data].concat(sparseArgs(right), [out.data]));
+        }
         return out;
     },
 
     /**
-     * Creates a square nXn identity matrix - a matrix with ones on the main diagonal
-     * and zeros elsewhere.
-     * =====================
-     * usage example:
-     * var mat = numjs_linalg.identity(3); <- creates a 3x3 identity matrix
-     * var mat2 = numjs_linalg.identity(5); <- creates a 5x5 identity matrix
-     * var scalar = numjs_linalg.identity(1); <- creates a single 1 value (scalar)
-     * =====================
+     * Creates a dense Matrix holding the values of a SparseMatrix
      *
-     * @param n - the dimensions of the nXn matrix
+     * @param matrix - the SparseMatrix to convert
+     * @returns {numjs_linalg.Matrix}
      */
-    identity: function(n) {
-        if (!n || n <= 0) {
-            throw new Error("invalid argument, should be a positive number");
+    sparse_to_dense: function (matrix) {
+        if (!(matrix instanceof numjs_linalg.SparseMatrix)) {
+            throw new Error("The argument must be instanceof numjs.SparseMatrix");
         }
 
-        var out = new numjs_linalg.Matrix([], n, n);
-        linalg.identity(n, out.data);
+        var out = new numjs_linalg.Matrix([], matrix.rows, matrix.cols, {dtype: matrix.dtype}),
+            isCsr = matrix.format === "csr", outer = isCsr ? matrix.rows : matrix.cols;
+        for (var i = 0; i < outer; i++) {
+            for (var j = matrix.indptr[i]; j < matrix.indptr[i + 1]; j++) {
+                out.data[isCsr ? matrix.indices[j] * matrix.rows + i : i * matrix.rows + matrix.indices[j]] = matrix.values[j];
+            }
+        }
         return out;
     },
 
     /**
-     * Creates a matrix with ones on the main diagonal and zeros elsewhere
-     * the matrix can be of any size, not necessarily nXn
-     * =========================
+     * Sparse direct solvers.
+     * Factorize a square SparseMatrix once and solve against it many times, the returned object has the same
+     * rows, cols, solve(b), solveInto(b, out) and determinant() as the dense factorizations (rcond() is NaN).
+     * ========================
      * usage example:
-     * var eyeMat = numjs_linalg.eye(3,4); <- creates a 3x4 eye matrix
-     * var idMat = numjs_linalg.eye(3); <- creates a 3x3 identity matrix
-     * var eyeMat2 = numjs_linalg.eye(5, 5) <- creates a 5x5 indentity matrix
-     * var scalar = numjs_linalg.eye(1) <- creates a scalar with the value of 1.
-     * =========================
+     * var llt = linalg.sparse_cholesky_factor(laplacian); <- fill reducing (AMD) ordering, sparse factors
+     * var x = llt.solve(b); <- b is a Float64Array of laplacian.rows elements per right hand side
+     * ========================
      *
-     * @param n - the number of matrix rows
-     * @param m - the number of matrix cols - optional parameter, defaults to n
+     * sparse_cholesky_factor - SimplicialLLT, the matrix must be symmetric positive definite, only its lower
+     *                          triangle is read.
+     * sparse_ldlt - SimplicialLDLT, for symmetric positive or negative semidefinite matrices, lower triangle only.
+     * sparse_lu - SparseLU with COLAMD ordering, for any invertible square matrix.
+     *
+     * @param matrix - the SparseMatrix to factorize
      */
-    eye: function(n, m) {
-        if (!n) {
-            throw new Error("Undefined arguments")
+    sparse_cholesky_factor: function (matrix) {
+        if (!(matrix instanceof numjs_linalg.SparseMatrix)) {
+            throw new Error("The argument must be instanceof numjs.SparseMatrix");
         }
 
-        if (!m) {
-            m = n;
+        return linalg.sparse_llt.apply(null, sparseArgs(matrix));
+    },
+
+    sparse_ldlt: function (matrix) {
+        if (!(matrix instanceof numjs_linalg.SparseMatrix)) {
+            throw new Error("The argument must be instanceof numjs.SparseMatrix");
         }
 
-        if (n <= 0 || m <= 0) {
-            throw new Error("The rows and cols arguments must be positive");
+        return linalg.sparse_ldlt.apply(null, sparseArgs(matrix));
+    },
+
+    sparse_lu: function (matrix) {
+        if (!(matrix instanceof numjs_linalg.SparseMatrix)) {
+            throw new Error("The argument must be instanceof numjs.SparseMatrix");
         }
 
-        var out = new numjs_linalg.Matrix([], n, m);
-        linalg.eye(n, m, out.data);
-        return out;
+        return linalg.sparse_lu.apply(null, sparseArgs(matrix));
     },
 
     /**
-     * Creates a matrix with ones at and below the main diagonal and zeros elsewhere
-     * matrix size is nXm.
-     * ============================
+     * Iterative solvers.
+     * Solve A * x = b by iterating products with A, each of them O(nonzeros) for a SparseMatrix, until the relative
+     * residual |A * x - b| / |b| drops below tol or maxIterations is reached, so accuracy can be traded for latency.
+     * A is a Matrix (views included) or a SparseMatrix, all of them use a diagonal (Jacobi) preconditioner.
+     * ========================
      * usage example:
-     * var mat = tri(3,3); <- creates a 3x3 lower triagonal matrix
-     * var mat = tri(5,7); <- creates a 5x7 lower triagonal matrix
-     * var scalar = tri(1,1); <- creates a scalar with the value of 1
-     * ============================
+     * var res = linalg.cg(laplacian, b, {tol: 1e-8, maxIterations: 500}); <- res.x, res.error, res.iterations
+     * if (!res.converged) { ... } <- not reaching tol is reported, not thrown
+     * linalg.cg(laplacian, b2, {x0: res.x, out: res.x}); <- warm start from the previous solution, in place
+     * ========================
      *
-     * @param n - the number of matrix rows
-     * @param m - the number of matrix cols
+     * cg - ConjugateGradient, A must be symmetric positive definite, both of its triangles are read.
+     * bicgstab - BiCGSTAB, for any square A.
+     * lscg - LeastSquaresConjugateGradient, for any A, returns the x minimizing |A * x - b|.
+     *
+     * @param matrix - the Matrix or SparseMatrix A
+     * @param b - the right hand side, matrix.rows elements (converted to the dtype of matrix)
+     * @param options - optional - {tol: the relative residual to reach, defaults to the machine epsilon,
+     *                              maxIterations: defaults to 2 * matrix.cols,
+     *                              x0: the initial guess, defaults to zeros,
+     *                              out: a typed array of the matrix dtype with matrix.cols elements for x}
+     * @returns {{x, converged, iterations, error}} - x and the achieved relative residual error
      */
-    tri : function(n, m) {
-        if (!n || !m) {
-            throw new Error("Must specify two arguments - number of rows and number of cols");
-        }
+    cg: function (matrix, b, options) {
+        return iterativeSolve(ITERATIVE_CG, matrix, b, options);
+    },
 
-        if (n <= 0 || m <= 0) {
-            throw new Error("The rows and cols arguments must be positive");
-        }
+    bicgstab: function (matrix, b, options) {
+        return iterativeSolve(ITERATIVE_BICGSTAB, matrix, b, options);
+    },
 
-        var out = new numjs_linalg.Matrix([], n, m);
-        linalg.tri(n,m, out.data);
-        return out;
+    lscg: function (matrix, b, options) {
+        return iterativeSolve(ITERATIVE_LSCG, matrix, b, options);
     },
 
     /**
-     * Creates a copy of a given matrix with all elements above the diagonal zeroed
-     * (a lower triagonal copy of the input)
-     * ==============
+     * Multiplies count pairs of small matrices in a single native call, out[i] = a[i] * b[i].
+     * A batch is one Float64Array holding count matrices stored one after the other, each of them in the same
+     * column-major layout as Matrix.data. Large batches are split across the threads set by set_num_threads.
+     * Float32Array batches run in single precision; all the buffers of a call must have the same type.
+     * ========================
      * usage example:
-     * var mat = new linalg.Matrix([1,2,3,4,5,6,7,8,9], 3, 3); <- input matrix
-     * var trilMat = linalg.tril(mat); <- creates a lower triagonal copy of mat
-     *
-     * var mat = linalg.ones(5); <- creates a 5x5 ones matrix
-     * var trilMat = linalg.tril(mat); <- creates a lower triagonal copy of mat
-     * ==============
+     * var a = new Float64Array(1000 * 9), b = new Float64Array(1000 * 9); <- 1000 3x3 matrices each
+     * var res = linalg.mat_mul_batched(a, b, 1000, 3, 3, 3); <- 1000 3x3 products
+     * linalg.mat_mul_batched(a, b, 1000, 3, 3, 3, res); <- same, reusing the output buffer
+     * ========================
      *
-     * @param matrix - the matrix to convert into a lower triagonal matrix
+     * @param a - Float64Array holding the count left matrices, rowsA x colsA each
+     * @param b - Float64Array holding the count right matrices, colsA x colsB each
+     * @param count - the number of matrices in the batch
+     * @param rowsA - the number of rows of each left matrix
+     * @param colsA - the number of cols of each left matrix (and rows of each right matrix)
+     * @param colsB - the number of cols of each right matrix
+     * @param out - optional Float64Array of count * rowsA * colsB elements for the result
+     * @returns {Float64Array} the count products, rowsA x colsB each
      */
-    tril: function(matrix) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The argument must be instanceof numjs.Matrix");
+    mat_mul_batched: function (a, b, count, rowsA, colsA, colsB, out) {
+        if (!isFloatArray(a) || b.constructor !== a.constructor) {
+            throw new Error("The batches must be Float64Arrays or Float32Arrays of the same type");
+        }
+        if (a.length !== count * rowsA * colsA || b.length !== count * colsA * colsB) {
+            throw new Error("The batch length must be count * rows * cols");
+        }
+        if (!out) {
+            out = allocData(count * rowsA * colsB, a instanceof Float32Array ? "float32" : "float64");
+        }
+        else if (out.constructor !== a.constructor || out.length !== count * rowsA * colsB) {
+            throw new Error("The out parameter must be an array of the batch type with count * rowsA * colsB elements");
         }
 
-        var out = new numjs_linalg.Matrix([], matrix.rows, matrix.cols);
-        linalg.tril(matrix.data, matrix.rows, matrix.cols, out.data);
+        linalg.mat_mul_batched(count, rowsA, colsA, a, colsA, colsB, b, out);
         return out;
     },
 
     /**
-     * Creates a copy of a given matrix with all elements below the diagonal zeroed
-     * ==============
+     * Computes the inverse of count stacked nXn matrices in a single native call.
+     * ========================
      * usage example:
-     * var mat = new linalg.Matrix([1,2,3,4,5,6,7,8,9], 3, 3); <- input matrix
-     * var triMat = linalg.tril(mat); <- creates an upper triagonal matrix of mat
-     *
-     * var mat = linalg.ones(5); <- creates a 5x5 ones matrix
-     * var trilMat = linalg.tril(mat); <- creates an upper triagonal copy of mat
-     * ==============
+     * var inverses = linalg.inv_batched(poses, 1000, 4); <- inverts 1000 4x4 matrices
+     * ========================
      *
-     * @param matrix - the matrix to convert into a lower triagonal matrix
-     */
-    triu: function(matrix) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The argument must be instanceof numjs.Matrix");
+     * @param data - Float64Array holding the count matrices, nXn each
+     * @param count - the number of matrices in the batch
+     * @param n - the dimensions of each matrix
+     * @param out - optional Float64Array of count * n * n elements for the result
+     * @returns {Float64Array} the count inverses
+     */
+    inv_batched: function (data, count, n, out) {
+        if (!isFloatArray(data)) {
+            throw new Error("The batch must be a Float64Array or a Float32Array");
+        }
+        if (data.length !== count * n * n) {
+            throw new Error("The batch length must be count * n * n");
+        }
+        if (!out) {
+            out = allocData(count * n * n, data instanceof Float32Array ? "float32" : "float64");
+        }
+        else if (out.constructor !== data.constructor || out.length !== count * n * n) {
+            throw new Error("The out parameter must be an array of the batch type with count * n * n elements");
         }
 
-        var out = new numjs_linalg.Matrix([], matrix.rows, matrix.cols);
-        linalg.triu(matrix.data, matrix.rows, matrix.cols, out.data);
+        linalg.inv_batched(count, n, data, out);
         return out;
     },
 
     /**
-     * Raise a square matrix to the (integer) power n.
-     * =================
+     * Computes the determinant of count stacked nXn matrices in a single native call.
+     * ========================
      * usage example:
-     * var inputMat = new linalg.Matrix([1, 1, 1, 1], 2, 2); <- create a new input 2x2 ones matrix
-     * var powerMat = linalg.matrix_power(inputMat, 3); <- returns a new matrix raised to the power of 3
-     *
-     * var inputMat = new linalg.Matrix([1,1,1,1, 2, 2); <- create a new input 2x2 ones matrix
-     * var identityMat = linalg.matrix_power(inputMat, 0); <- create identity matrix by raising it to the power of 0
-     * =================
+     * var dets = linalg.det_batched(data, 1000, 3); <- Float64Array with the 1000 determinants
+     * ========================
      *
-     * @param matrix - the input matrix
-     * @param n - number that represents the exponent, can be positive, negative or zero.
+     * @param data - Float64Array holding the count matrices, nXn each
+     * @param count - the number of matrices in the batch
+     * @param n - the dimensions of each matrix
+     * @param out - optional Float64Array of count elements for the result
+     * @returns {Float64Array} one determinant per matrix
      */
-    matrix_power: function (matrix, n) {
-        if (n === 1) {
-            return matrix;
+    det_batched: function (data, count, n, out) {
+        if (!isFloatArray(data)) {
+            throw new Error("The batch must be a Float64Array or a Float32Array");
         }
-
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
+        if (data.length !== count * n * n) {
+            throw new Error("The batch length must be count * n * n");
         }
-
-        if (matrix.rows !== matrix.cols) {
-            throw new Error("matrix must be square, i.e. M.rows == M.cols");
+        if (!out) {
+            out = allocData(count, data instanceof Float32Array ? "float32" : "float64");
+        }
+        else if (out.constructor !== data.constructor || out.length !== count) {
+            throw new Error("The out parameter must be an array of the batch type with count elements");
         }
 
-        var out = new numjs_linalg.Matrix([], matrix.rows, matrix.cols);
-        linalg.matrix_power(matrix.data, matrix.rows, matrix.cols, n, out.data);
+        linalg.det_batched(count, n, data, out);
         return out;
     },
 
-    inv: function (matrix) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
+    /**
+     * Solves count stacked square systems a[i] * x[i] = b[i] in a single native call (LU with partial pivoting).
+     * ========================
+     * usage example:
+     * var x = linalg.solve_batched(a, b, 1000, 3, 1); <- solves 1000 3x3 systems with one right hand side each
+     * ========================
+     *
+     * @param a - Float64Array holding the count coefficient matrices, nXn each
+     * @param b - Float64Array holding the count right hand sides, n x nrhs each
+     * @param count - the number of systems in the batch
+     * @param n - the dimensions of each coefficient matrix
+     * @param nrhs - the number of right hand sides of each system - optional - defaults to 1
+     * @param out - optional Float64Array of count * n * nrhs elements for the result
+     * @returns {Float64Array} the count solutions, n x nrhs each
+     */
+    solve_batched: function (a, b, count, n, nrhs, out) {
+        if (!nrhs) {
+            nrhs = 1;
         }
-
-        if (matrix.rows !== matrix.cols) {
-            throw new Error("matrix must be square, i.e. M.rows == M.cols");
+        if (!isFloatArray(a) || b.constructor !== a.constructor) {
+            throw new Error("The batches must be Float64Arrays or Float32Arrays of the same type");
+        }
+        if (a.length !== count * n * n || b.length !== count * n * nrhs) {
+            throw new Error("The batch length must be count * rows * cols");
+        }
+        if (!out) {
+            out = allocData(count * n * nrhs, a instanceof Float32Array ? "float32" : "float64");
+        }
+        else if (out.constructor !== a.constructor || out.length !== count * n * nrhs) {
+            throw new Error("The out parameter must be an array of the batch type with count * n * nrhs elements");
         }
 
-        var out = new numjs_linalg.Matrix([], matrix.rows, matrix.cols);
-        linalg.inv(matrix.data, matrix.rows, matrix.cols, out.data);
+        linalg.solve_batched(count, n, a, nrhs, b, out);
         return out;
     },
 
     /**
-     * Cholesky decomposition.
-     *
-     * Return the Cholesky decomposition, L * L.H, of the square matrix a, where L is lower-triangular
-     * and .H is the conjugate transpose operator (which is the ordinary transpose if a is real-valued).
-     * a must be Hermitian (symmetric if real-valued) and positive-definite. Only L is actually returned.
-     * =================
+     * Sets the number of threads used by the native kernels (matrix products and the decompositions built on them).
+     * Only has an effect when the addon is built with OpenMP, the default on Linux and Windows and opt-in on macOS
+     * (see the README).
+     * NOTE: the *_async functions run on the libuv threadpool, so every concurrent async call may use n threads.
+     * ========================
      * usage example:
-     * var jsMat = new linalg.Matrix([4, -1, 2, -1, 6, 0, 2, 0, 5], 3, 3); <- create a 3x3 Hermitian and positive-definite matrix
-     * var matrix = linalg.cholesky(jsMat); <-  return the lower-triangular Cholesky factor of jsMat
-     * =================
+     * linalg.set_num_threads(32); <- give GEMM heavy batch jobs all the cores
+     * linalg.set_num_threads(1); <- single threaded kernels for latency sensitive services
+     * ========================
      *
-     * @param matrix - the input matrix. Must be Hermitian (symmetric if all elements are real), positive-definite input matrix.
-     * @return The lower-triangular Cholesky factor of a. Returns a matrix object if a is a matrix object.
+     * @param n - the number of threads, a positive integer
      */
-    cholesky: function (matrix) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
+    set_num_threads: function (n) {
+        if (!n || n <= 0 || Math.floor(n) !== n) {
+            throw new Error("n must be a positive integer");
         }
 
-        if (matrix.rows !== matrix.cols) {
-            throw new Error("matrix must be square, i.e. M.rows == M.cols");
-        }
+        linalg.set_num_threads(n);
+    },
 
-        var out = new numjs_linalg.Matrix([], matrix.rows, matrix.cols);
-        linalg.cholesky(matrix.data, matrix.rows, matrix.cols, out.data);
-        return out;
+    /**
+     * Returns the number of threads used by the native kernels (always 1 when built without OpenMP).
+     */
+    get_num_threads: function () {
+        return linalg.get_num_threads();
     },
 
     /**
-     * Computes The sum along the diagonals of a matrix
-     * =================
+     * Loads a matrix saved by numpy.save (.npy) or the matrices of numpy.savez / numpy.savez_compressed (.npz).
+     * float64 and float32 arrays in C or Fortran order are supported, a one dimensional array is loaded as a
+     * 1 x n vector. With mmap the file is mapped copy on write instead of read: the data is paged in when it is
+     * first touched, so loading multi-GB matrices is immediate, and writes to the matrix never reach the file.
+     * A mapped C order array is returned as a transposed view of the file (see linalg.transpose), which the
+     * functions that do not read views copy on use; save such matrices in Fortran order (np.asfortranarray or
+     * linalg.save) to use them fully in place. Compressed .npz entries are always read.
+     * ========================
      * usage example:
-     * var inputMat = new linalg.Matrix([1, 1, 1, 1], 2, 2); <- create a new 2x2 ones matrix
-     * var trace = linalg.trace(inputMat); <- returns the matrix trace
-     * ================
+     * var W = linalg.load('weights.npy', {mmap: true}); <- maps the file, no copy
+     * var arrays = linalg.load('model.npz'); <- {name: Matrix} for every array of the archive
+     * ========================
      *
-     * @param matrix - the input matrix to compute its trace
+     * @param path - the path of a .npy or .npz file
+     * @param options - optional - {mmap: true} to map the file instead of reading it
+     * @returns {numjs_linalg.Matrix} for a .npy file, an object of matrices by name for a .npz file
      */
-    trace: function(matrix) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
-        }
+    load: function (path, options) {
+        var mmap = !!(options && options.mmap), fd = fs.openSync(path, "r");
 
-        return linalg.trace(matrix.data, matrix.rows, matrix.cols);
+        try {
+            var magic = readAll(fd, Buffer.alloc(4), 0);
+            return magic.readUInt32LE(0) === 0x04034b50 ? loadNpz(fd, path, mmap) : loadNpy(fd, path, 0, mmap);
+        }
+        finally {
+            fs.closeSync(fd);
+        }
     },
 
     /**
-     * Singular Value Decomposition.
-     * Factors the matrix a as u * np.diag(s) * v, where u and v are unitary and s is a 1-d array of as singular values.
-     * =================
+     * Saves a matrix in the .npy format (version 1.0, Fortran order, so numpy.load reads it with the same shape
+     * and linalg.load can map it without a transposed view). The data is written straight from the matrix storage.
+     * ========================
      * usage example:
-     * var jsMat = new linalg.Matrix([0.68, -0.211, 0.566, 0.597, 0.823, -0.605], 3, 2); <- create a new 3X2 matrix
-     * var svdObj = linalg.svd(jsMat, false, false); <- compute the Singular Value Decomposition (just s)
-     * or:
-     * var svdObj = linalg.svd(jsMat, false); <- compute the Singular Value Decomposition (just u,s,v, when u and v are thin)
-     * or:
-     * var svdObj = linalg.svd(jsMat); <- compute the Singular Value Decomposition (just u,s,v, when u and v are full)
-     * =================
+     * linalg.save('weights.npy', W);
+     * ========================
      *
-     * @param matrix - A real matrix of shape (M, N).
-     * @param full_matrices - bool, optional - If True (default), u and v have the shapes (M, M) and (N, N),
-     *                        respectively. Otherwise, the shapes are (M, K) and (K, N), respectively, where K = min(M, N).
-     * @param compute_uv - bool, optional - Whether or not to compute u and v in addition to s. True by default.
-     * @returns object contains u, s, v:
-     *          u : Unitary matrices. The actual shape depends on the value of full_matrices.
-     *              Only returned when compute_uv is True.
-     *          s:  The singular values for every matrix, sorted in descending order (a Float64Array).
-     *          v: Unitary matrices. The actual shape depends on the value of full_matrices.
-     *          Only returned when compute_uv is True.
+     * @param path - the path of the .npy file to write
+     * @param matrix - the matrix to save
      */
-    svd: function (matrix, full_matrices, compute_uv) {
-        var outU = null, outS=null, outV=null, k=1;
+    save: function (path, matrix) {
         if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
+            throw new Error("The second arg must be instanceof numjs.Matrix");
         }
+        matrix = dense(matrix);
 
-        if(full_matrices === undefined || full_matrices === null){
-            full_matrices = true;
+        var fd = fs.openSync(path, "w");
+        try {
+            writeAll(fd, npyHeader(matrix.dtype, matrix.rows, matrix.cols));
+            writeAll(fd, byteView(matrix.data));
         }
-        if(compute_uv === undefined || compute_uv === null){
-            compute_uv = true;
-        }
-
-        k = Math.min(matrix.rows, matrix.cols);
-        outS = new Float64Array(k);
-
-        if(compute_uv){
-            if(full_matrices){
-                outU = new numjs_linalg.Matrix([], matrix.rows, matrix.rows);
-                outV = new numjs_linalg.Matrix([], matrix.cols, matrix.cols);
-            }
-            else{
-                outU = new numjs_linalg.Matrix([], matrix.rows, k);
-                outV = new numjs_linalg.Matrix([], k, matrix.cols);
-            }
+        finally {
+            fs.closeSync(fd);
         }
-
-        linalg.svd(matrix.data, matrix.rows, matrix.cols, full_matrices, compute_uv,
-                outU ? outU.data : outU, outS, outV ? outV.data : outV);
-
-        return {u: outU, s: outS, v: outV};
     },
 
     /**
-     * Computes the determinant of a square nxn matrix
-     * =================
+     * Out-of-core matrix product of two .npy files into a third one, for products that do not fit in memory.
+     * The files are mapped instead of read and C is computed one panel of tile columns at a time from tile x tile
+     * blocks. Finished panels are written to the file and dropped from memory as the product goes, so only one
+     * panel of C is ever dirty; the pages of A and B are file cache the system reclaims whenever memory runs short,
+     * A is streamed once per panel. The blocks of a panel are computed in parallel
+     * by the threads set by set_num_threads. A and B may be in C or Fortran order and must have the same dtype;
+     * C is written in Fortran order (see linalg.save) and can be mapped back with linalg.load.
+     * ========================
      * usage example:
-     * var inputMat = new linalg.Matrix([1, 1, 1, 1], 2, 2); <- create a new 2X2 ones matrix
-     * var det = linalg.det(inputMat); <- compute return the input matrix determinant value
-     * =================
+     * linalg.mat_mul_tiled('a.npy', 'b.npy', 'c.npy'); <- c.npy = a.npy * b.npy
+     * linalg.mat_mul_tiled('x.npy', 'xt.npy', 'gram.npy', 4096); <- tiles of 4096 x 4096 elements
+     * ========================
      *
-     * @param matrix - the input matrix to compute its determinant
-     * @returns the determinant of the matrix
+     * @param aPath - the .npy file of the left matrix
+     * @param bPath - the .npy file of the right matrix
+     * @param cPath - the .npy file to write the product into, it can not be one of the operands
+     * @param tile - optional - the tile size, defaults to 2048
      */
-    det: function (matrix) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
+    mat_mul_tiled: function (aPath, bPath, cPath, tile) {
+        tile = tile === undefined || tile === null ? 2048 : tile;
+        if (!(tile > 0) || Math.floor(tile) !== tile) {
+            throw new Error("tile must be a positive integer");
+        }
+
+        var operands = [aPath, bPath].map(function (path) {
+            var fd = fs.openSync(path, "r");
+            try {
+                var header = readNpyHeader(fd, 0);
+                if (fs.fstatSync(fd).size < header.length + header.rows * header.cols * dtypes[header.dtype].BYTES_PER_ELEMENT) {
+                    throw new Error("The .npy file is truncated");
+                }
+                return header;
+            }
+            finally {
+                fs.closeSync(fd);
+            }
+        });
+        var a = operands[0], b = operands[1];
 
+        if (a.cols !== b.rows) {
+            throw new Error("The left cols and right rows must agree");
+        }
+        if (a.dtype !== b.dtype) {
+            throw new Error("The matrices must have the same dtype");
+        }
+        if (fs.existsSync(cPath) && (fs.realpathSync(cPath) === fs.realpathSync(aPath) || fs.realpathSync(cPath) === fs.realpathSync(bPath))) {
+            throw new Error("The result file can not be one of the operands");
         }
-        if (matrix.rows !== matrix.cols) {
-            throw new Error("matrix must be square, i.e. M.rows == M.cols");
 
+        // the result file is sized up front, its data is only written by the product
+        var header = npyHeader(a.dtype, a.rows, b.cols), fd = fs.openSync(cPath, "w");
+        try {
+            writeAll(fd, header);
+            fs.ftruncateSync(fd, header.length + a.rows * b.cols * dtypes[a.dtype].BYTES_PER_ELEMENT);
         }
-        return linalg.det(matrix.data, matrix.rows, matrix.cols);
+        finally {
+            fs.closeSync(fd);
+        }
+
+        linalg.mat_mul_tiled(aPath, a.length, npyRowMajor(a), bPath, b.length, npyRowMajor(b), cPath, header.length,
+            a.rows, a.cols, b.cols, tile, a.dtype === "float32");
     },
 
     /**
-     * Computes The input matrix rank using SVD method
-     *
-     * =====================
+     * The instruction set of the loaded build of the bindings and the features of the CPU it was picked from.
+     * ========================
      * usage example:
-     * var inputMat = new linalg.Matrix([1, 1, 1, 1], 1, 4); <- creates a new 1X4 ones vector
-     * var rank = linalg.matrix_rank(inputMat); <- calculates the rank
-     * =====================
+     * linalg.cpu_features(); <- {isa: 'avx512', simd: 'AVX512, FMA, AVX2, AVX, SSE, ...', features: {avx2: true, ...}}
+     * ========================
      *
-     * @param matrix - the input matrix to compute its rank
-     * @param tol - Number which represents the threshold which SVD values are considered zero.
-     *              If this arg is not given, and input matrix has only singular values,
-     *              and eps is the epsilon value for datatype of the matrix,
-     *              then tol is set to matrix.max() * max(matrix.shape) * eps
+     * @returns {{isa: string, simd: string, features: Object}} isa is 'sse2', 'avx2' or 'avx512', simd the
+     *          instruction sets Eigen's kernels use in that build and features the cpuid flags (sse2, sse4_2, avx,
+     *          avx2, fma, avx512f, avx512dq, avx512bw, avx512vl), all false on other architectures
      */
-    matrix_rank: function (matrix, tol) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
+    cpu_features: function () {
+        var features = {};
+        Object.keys(loaded.features).forEach(function (name) {
+            features[name] = loaded.features[name];
+        });
 
-        }
-        if (tol && !isNaN(tol)) {
-            return linalg.matrix_rank(matrix.data, matrix.rows, matrix.cols, tol);
-        }
-        else {
-            return linalg.matrix_rank(matrix.data, matrix.rows, matrix.cols);
-        }
+        return {isa: loaded.isa, simd: native.simd_instruction_sets(), features: features};
     },
 
     /**
-     * Solve linear equation system
+     * Turns the per operation instrumentation on or off. It is off by default, or on from the start when the
+     * NUMJS_LINALG_STATS environment variable is set. While it is off the functions run uninstrumented, with no
+     * overhead at all; while on, each call costs a few hundred ns of bookkeeping. References to the exported
+     * functions taken before enabling it (e.g. var inv = linalg.inv) are not instrumented.
      * ========================
      * usage example:
-     * var A = linalg.eye(3,3); <- create a 3x3 eye matrix
-     * var resMat = linalg.matrix_eigen_values(A); <- get the values of x in A*x=b system of equations
+     * linalg.enable_stats(true);
+     * ... serve requests ...
+     * report(linalg.stats()); linalg.reset_stats(); <- e.g. once a minute to the metrics pipeline
      * ========================
      *
-     * @param matrix - the matrix whos eigen values we wish to find
-     * @returns {Float64Array} such that every pair is the real and imaginary part of an eigen value.
-     */    
-    matrix_eigen_values: function (matrix) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
-        }
-        if (matrix.rows !== matrix.cols) {
-            throw new Error("matrix must be square, i.e. M.rows == M.cols");
-        }
-        var eigenTestResult = new Float64Array(2 * matrix.cols);
-        linalg.get_eigen_values(matrix.rows, matrix.cols, matrix.data, eigenTestResult);
-        return eigenTestResult;
+     * @param enabled - true to record stats, false to stop
+     */
+    enable_stats: function (enabled) {
+        setStatsEnabled(!!enabled);
     },
-    
+
     /**
-     * Solve linear equation system
+     * The stats recorded since enable_stats or the last reset_stats:
+     * native: for every native binding called, {calls, timeMs, bytes, latencyUs, elements} where bytes is the total
+     *         size of its typed array arguments (the memory it touched), latencyUs counts the calls by power of two
+     *         bucket of their duration in microseconds and elements by bucket of the length of their largest typed
+     *         array argument. Async bindings are timed until their callback.
+     * functions: for every exported function called, {calls, timeMs, allocatedBytes}, timeMs including its native
+     *         calls and allocatedBytes the storage of the matrices and typed arrays its JS code allocated
+     *         (results, dense copies of views, converted arguments). Exported functions called by other ones are
+     *         accounted to the outermost call.
+     *
+     * @returns {{enabled: boolean, native: Object, functions: Object}} a copy of the stats
+     */
+    stats: function () {
+        var copy = JSON.parse(JSON.stringify(stats));
+        copy.enabled = statsEnabled;
+        return copy;
+    },
+
+    /**
+     * Clears the recorded stats, recording goes on if it is enabled.
+     */
+    reset_stats: function () {
+        stats = {native: {}, functions: {}};
+    },
+
+    /**
+     * Buffer pool.
+     * The matrices and typed arrays returned by the functions (and the dense copies and converted arguments they
+     * make internally) are natively allocated buffers. Buffers given back to the pool are reused for the next
+     * results instead of allocating new ones, so a steady state loop stops allocating and the garbage collector
+     * has nothing to do.
+     * with_pool(fn) - calls fn and gives back every buffer allocated during the call except the storage of its
+     *                 result (a Matrix, a typed array or arrays and objects of them), which is returned. When fn
+     *                 returns a Promise (the async variants), the buffers are given back once it settles. Scopes nest.
+     *                 The buffers of an async call still running when the scope closes (its Promise was not
+     *                 returned) are given back when the call completes, except its result, which is left to the
+     *                 garbage collector.
+     * release(matrix) - gives the storage of a Matrix or typed array back right away. It, and every view sharing
+     *                 its storage, must not be used afterwards. Returns false when it did not come from the pool
+     *                 (e.g. mapped files or typed arrays built in JS) or was already released.
+     * pool_stats() - {hits, misses, releases, discarded, bytes, limit}: allocations served from the pool or not,
+     *                 buffers given back, buffers dropped because the pool was full, and the bytes the pool holds.
+     * clear_pool(limit) - frees the pooled buffers and optionally sets the maximum bytes held (256 MiB by default).
      * ========================
      * usage example:
-     * var A = linalg.eye(3,3); <- create a 3x3 eye matrix
-     * var b = new Float64Array([1,2,3]); <- create the 
-     * var resMat = linalg.matrix_solve_linear(A, b); <- get the values of x in A*x=b system of equations
+     * setInterval(function () {
+     *     var score = linalg.with_pool(function () { <- the inverse and products below reuse the same buffers every tick
+     *         return linalg.det(linalg.matrix_mul(linalg.inv(A), B));
+     *     });
+     * }, 10);
+     * var C = linalg.matrix_mul(A, B); ... linalg.release(C); <- or give buffers back one by one
      * ========================
      *
-     * @param matrix - the matrix defining the coefficients  
-     * @param b - the constraint vector as a Float64Array in the 
-     * @returns {Float64Array} such every value is the x_i respective value.
-     */    
-    matrix_solve_linear: function (matrix, b) {
-        if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
+     * @param fn - the function to run
+     * @returns the result of fn
+     */
+    with_pool: function (fn) {
+        if (typeof fn !== "function") {
+            throw new Error("fn must be a function");
         }
-        if (b.length !== matrix.cols) {
-            throw new Error("matrix and the parameter dimensions must agree.");
+
+        var allocated = [], result;
+        poolScopes.push(allocated);
+        try {
+            result = fn();
         }
-        //TODO: check matrix rank ?
-        var x = new Float64Array(matrix.cols);
-        linalg.solve_linear_system_householder_qr(matrix.rows, matrix.cols, matrix.data, b, x);
-        return x;
+        catch (e) {
+            poolScopes.pop();
+            closeScope(allocated, undefined);
+            throw e;
+        }
+        poolScopes.pop();
+
+        if (result && typeof result.then === "function") {
+            return result.then(function (value) {
+                closeScope(allocated, value);
+                return value;
+            }, function (error) {
+                closeScope(allocated, undefined);
+                throw error;
+            });
+        }
+
+        closeScope(allocated, result);
+        return result;
+    },
+
+    release: function (matrix) {
+        if (matrix instanceof numjs_linalg.Matrix) {
+            return releaseData(matrix.data);
+        }
+        if (!isFloatArray(matrix)) {
+            throw new Error("The argument must be instanceof numjs.Matrix, a Float64Array or a Float32Array");
+        }
+
+        return releaseData(matrix);
+    },
+
+    pool_stats: function () {
+        return {hits: pool.hits, misses: pool.misses, releases: pool.releases, discarded: pool.discarded,
+            bytes: pool.bytes, limit: pool.limit};
+    },
+
+    clear_pool: function (limit) {
+        if (limit !== undefined && limit !== null) {
+            if (typeof limit !== "number" || limit < 0) {
+                throw new Error("limit must be a non negative number");
+            }
+            pool.limit = limit;
+        }
+
+        ["float32", "float64"].forEach(function (dtype) {
+            pool.free[dtype].forEach(function (list) {
+                list.forEach(function (buffer) {
+                    freeBuffers.delete(buffer.buffer);
+                });
+            });
+            pool.free[dtype] = [];
+        });
+        pool.bytes = 0;
     },
 
     /**
-     * Multiplies two matrices
+     * Async variants.
+     * Same arguments (including out) and results as the synchronous functions, but the Eigen work runs on the libuv threadpool
+     * so the event loop stays responsive. Each returns a Promise; argument errors reject it.
      * ========================
      * usage example:
-     * var mat1 = linalg.ones(3,3); <- create a 3x3 ones matrix
-     * var mat2 = linalg.ones(3,3); <- create a 3x3 ones matrix
-     * var resMat = linalg.matrix_mul(mat1, mat2); <- create a matrix which is the product of the two matrices multiplication
+     * linalg.inv_async(mat).then(function (inverse) { ... });
+     * linalg.svd_async(mat, false).then(function (res) { ... res.u, res.s, res.v ... });
      * ========================
-     *
-     * @param matrixA - the first input matrix
-     * @param matrixB - the second input matrix
-     * @returns {numjs_linalg.Matrix}
      */
-    matrix_mul: function (matrixA, matrixB) {
-        if (!matrixA || !(matrixA instanceof numjs_linalg.Matrix) || !matrixB || !(matrixB instanceof numjs_linalg.Matrix)) {
-            throw new Error("The first arg must be instanceof numjs.Matrix");
-        }
-        if (matrixA.cols !== matrixB.rows) {
-            throw new Error("matrix and the parameter dimensions must agree, i.e. matrixA.cols == matrixB.rows");
-        }
-        var res = new Float64Array(matrixA.rows * matrixB.cols);
-        linalg.mat_mul(matrixA.rows, matrixA.cols, matrixA.data, matrixB.rows, matrixB.cols, matrixB.data, res);
-        return new numjs_linalg.Matrix(res, matrixA.rows, matrixB.cols);
+    inv_async: function (matrix, out) {
+        return new Promise(function (resolve, reject) {
+            if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+                throw new Error("The first arg must be instanceof numjs.Matrix");
+            }
+            matrix = dense(matrix);
+
+            if (matrix.rows !== matrix.cols) {
+                throw new Error("matrix must be square, i.e. M.rows == M.cols");
+            }
+
+            out = outMatrix(out, matrix.rows, matrix.cols, matrix.dtype);
+            whileBusy([matrix.data, out.data], out, function (done) {
+                linalg.inv_async(matrix.data, matrix.rows, matrix.cols, out.data, done);
+            }, function (err) {
+                err ? reject(err) : resolve(out);
+            });
+        });
+    },
+
+    cholesky_async: function (matrix, out) {
+        return new Promise(function (resolve, reject) {
+            if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+                throw new Error("The first arg must be instanceof numjs.Matrix");
+            }
+            matrix = dense(matrix);
+
+            if (matrix.rows !== matrix.cols) {
+                throw new Error("matrix must be square, i.e. M.rows == M.cols");
+            }
+
+            out = outMatrix(out, matrix.rows, matrix.cols, matrix.dtype);
+            whileBusy([matrix.data, out.data], out, function (done) {
+                linalg.cholesky_async(matrix.data, matrix.rows, matrix.cols, out.data, done);
+            }, function (err) {
+                err ? reject(err) : resolve(out);
+            });
+        });
+    },
+
+    svd_async: function (matrix, full_matrices, compute_uv, out, algorithm) {
+        return new Promise(function (resolve, reject) {
+            var outU = null, outS = null, outV = null, k = 1;
+            if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+                throw new Error("The first arg must be instanceof numjs.Matrix");
+            }
+            matrix = dense(matrix);
+            algorithm = svdAlgorithm(algorithm);
+
+            if (full_matrices === undefined || full_matrices === null) {
+                full_matrices = true;
+            }
+            if (compute_uv === undefined || compute_uv === null) {
+                compute_uv = true;
+            }
+
+            out = out || {};
+            k = Math.min(matrix.rows, matrix.cols);
+            outS = outArray(out.s, k, matrix.dtype);
+
+            if (compute_uv) {
+                if (full_matrices) {
+                    outU = outMatrix(out.u, matrix.rows, matrix.rows, matrix.dtype);
+                    outV = outMatrix(out.v, matrix.cols, matrix.cols, matrix.dtype);
+                }
+                else {
+                    outU = outMatrix(out.u, matrix.rows, k, matrix.dtype);
+                    outV = outMatrix(out.v, k, matrix.cols, matrix.dtype);
+                }
+            }
+
+            var result = {u: outU, s: outS, v: outV};
+            whileBusy([matrix.data, outU && outU.data, outS, outV && outV.data], result, function (done) {
+                linalg.svd_async(matrix.data, matrix.rows, matrix.cols, full_matrices, compute_uv,
+                    outU ? outU.data : outU, outS, outV ? outV.data : outV, done, algorithm);
+            }, function (err) {
+                err ? reject(err) : resolve(result);
+            });
+        });
+    },
+
+    matrix_eigen_values_async: function (matrix, out) {
+        return new Promise(function (resolve, reject) {
+            if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+                throw new Error("The first arg must be instanceof numjs.Matrix");
+            }
+            matrix = dense(matrix);
+            if (matrix.rows !== matrix.cols) {
+                throw new Error("matrix must be square, i.e. M.rows == M.cols");
+            }
+            var eigenResult = outArray(out, 2 * matrix.cols, matrix.dtype);
+            whileBusy([matrix.data, eigenResult], eigenResult, function (done) {
+                linalg.get_eigen_values_async(matrix.rows, matrix.cols, matrix.data, eigenResult, done);
+            }, function (err) {
+                err ? reject(err) : resolve(eigenResult);
+            });
+        });
+    },
+
+    matrix_solve_linear_async: function (matrix, b, out) {
+        return new Promise(function (resolve, reject) {
+            if (!matrix || !(matrix instanceof numjs_linalg.Matrix)) {
+                throw new Error("The first arg must be instanceof numjs.Matrix");
+            }
+            matrix = dense(matrix);
+            var args = solveArgs(matrix, b, out);
+            whileBusy([matrix.data, args.b, args.x], args.result, function (done) {
+                linalg.solve_linear_system_householder_qr_async(matrix.rows, matrix.cols, matrix.data, args.b, args.x, done);
+            }, function (err) {
+                err ? reject(err) : resolve(args.result);
+            });
+        });
+    },
+
+    matrix_mul_async: function (matrixA, matrixB, out) {
+        return new Promise(function (resolve, reject) {
+            if (!matrixA || !(matrixA instanceof numjs_linalg.Matrix) || !matrixB || !(matrixB instanceof numjs_linalg.Matrix)) {
+                throw new Error("The first arg must be instanceof numjs.Matrix");
+            }
+            if (matrixA.cols !== matrixB.rows) {
+                throw new Error("matrix and the parameter dimensions must agree, i.e. matrixA.cols == matrixB.rows");
+            }
+            matrixA = dense(matrixA);
+            matrixB = dense(matrixB);
+            out = outMatrix(out, matrixA.rows, matrixB.cols, commonDtype(matrixA, matrixB));
+            whileBusy([matrixA.data, matrixB.data, out.data], out, function (done) {
+                linalg.mat_mul_async(matrixA.rows, matrixA.cols, matrixA.data, matrixB.rows, matrixB.cols, matrixB.data,
+                    out.data, done);
+            }, function (err) {
+                err ? reject(err) : resolve(out);
+            });
+        });
     }
 };
 
+if (process.env.NUMJS_LINALG_STATS) {
+    setStatsEnabled(true);
+}
+
 module.exports = numjs_linalg;
\ No newline at end of file
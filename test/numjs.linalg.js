@@ -730,6 +730,43 @@ describe('numjs.linalg - native extension to support linear algebra via the Eige
             expect(matrix.data["2"]).to.equal(-1);
             expect(matrix.data["3"]).to.equal(0);
         })
+
+        it('should raise to large powers and reject non integer exponents', function () {
+            var fibonacci = new linalg.Matrix([1, 1, 1, 0], 2, 2);
+            var matrix = linalg.matrix_power(fibonacci, 40);
+            expect(matrix.data[0]).to.equal(165580141);
+            expect(matrix.data[1]).to.equal(102334155);
+            expect(matrix.data[3]).to.equal(63245986);
+            expect(function () { linalg.matrix_power(fibonacci, 2.5); }).to.throw(Error);
+        })
+    })
+
+    describe('expm, logm and sqrtm', function () {
+        it('should compute the exponential of a rotation generator', function () {
+            var matrix = linalg.expm(new linalg.Matrix([0, -1, 1, 0], 2, 2));
+            expect(matrix.data[0]).to.be.closeTo(Math.cos(1), 1e-12);
+            expect(matrix.data[1]).to.be.closeTo(-Math.sin(1), 1e-12);
+            expect(matrix.data[2]).to.be.closeTo(Math.sin(1), 1e-12);
+            expect(matrix.data[3]).to.be.closeTo(Math.cos(1), 1e-12);
+        })
+
+        it('should invert expm with logm and square sqrtm', function () {
+            var A = new linalg.Matrix([4, 0, 1, 9], 2, 2);
+            var back = linalg.expm(linalg.logm(A)), root = linalg.sqrtm(A), square = linalg.matrix_mul(root, root);
+            for (var i = 0; i < 4; i++) {
+                expect(back.data[i]).to.be.closeTo(A.data[i], 1e-10);
+                expect(square.data[i]).to.be.closeTo(A.data[i], 1e-10);
+            }
+            expect(root.data[0]).to.be.closeTo(2, 1e-12);
+            expect(root.data[3]).to.be.closeTo(3, 1e-12);
+        })
+
+        it('should reject matrices without a real logarithm or square root', function () {
+            var A = new linalg.Matrix([-1, 0, 0, 1], 2, 2);
+            expect(function () { linalg.logm(A); }).to.throw(Error);
+            expect(function () { linalg.sqrtm(A); }).to.throw(Error);
+            expect(function () { linalg.expm(linalg.ones(2, 3)); }).to.throw(Error);
+        })
     })
 
     describe('trace', function() {
@@ -838,6 +875,63 @@ describe('numjs.linalg - native extension to support linear algebra via the Eige
             var rank = linalg.matrix_rank(jsMat, 0.3);
             expect(rank).to.equal(3);
         })
+
+        it('should count the pivots of the rank revealing QR and LU', function () {
+            // the second row is twice the first
+            var jsMat = new linalg.Matrix([1, 2, 1, 0, 2, 4, 0, 1, 3, 6, 1, 1], 4, 3);
+            expect(linalg.matrix_rank(jsMat)).to.equal(2);
+            expect(linalg.matrix_rank(jsMat, undefined, 'qr')).to.equal(2);
+            expect(linalg.matrix_rank(jsMat, undefined, 'lu')).to.equal(2);
+
+            var diag = new linalg.Matrix([1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0.3], 4, 4);
+            expect(linalg.matrix_rank(diag, 0.2, 'qr')).to.equal(4);
+            expect(linalg.matrix_rank(diag, 0.3, 'lu')).to.equal(3);
+            expect(function () { linalg.matrix_rank(diag, 0.2, 'cholesky'); }).to.throw(Error);
+        })
+    })
+
+    describe('lstsq and pinv', function () {
+        // a rank 2, 4 x 3 matrix, the second row is twice the first
+        var A = new linalg.Matrix([1, 2, 1, 0, 2, 4, 0, 1, 3, 6, 1, 1], 4, 3);
+
+        it('should fit an overdetermined system with several right hand sides', function () {
+            // y = 1 + 2 t sampled at t = 0..3, and y = t
+            var T = new linalg.Matrix([1, 1, 1, 1, 0, 1, 2, 3], 4, 2), B = new linalg.Matrix([1, 3, 5, 7, 0, 1, 2, 3], 4, 2);
+            var X = linalg.lstsq(T, B);
+            expect(X.rows).to.equal(2);
+            expect(X.cols).to.equal(2);
+            expect(X.data[0]).to.be.closeTo(1, 1e-12);
+            expect(X.data[1]).to.be.closeTo(2, 1e-12);
+            expect(X.data[2]).to.be.closeTo(0, 1e-12);
+            expect(X.data[3]).to.be.closeTo(1, 1e-12);
+
+            var x = linalg.lstsq(T, [1, 3, 5, 7]);
+            expect(x).to.be.an.instanceof(Float64Array);
+            expect(x[1]).to.be.closeTo(2, 1e-12);
+        })
+
+        it('should return the minimum norm solution of a rank deficient system', function () {
+            var b = linalg.matrix_mul(A, new linalg.Matrix([1, 1, 1], 3, 1)).data;
+            var x = linalg.lstsq(A, b), pinvX = linalg.matrix_mul(linalg.pinv(A), new linalg.Matrix(b, 4, 1)).data;
+            var Ax = linalg.matrix_mul(A, new linalg.Matrix(x, 3, 1)).data;
+            for (var i = 0; i < 4; i++) {
+                expect(Ax[i]).to.be.closeTo(b[i], 1e-10);
+            }
+            for (i = 0; i < 3; i++) {
+                expect(x[i]).to.be.closeTo(pinvX[i], 1e-10);
+            }
+        })
+
+        it('should satisfy the Moore-Penrose conditions', function () {
+            var P = linalg.pinv(A);
+            expect(P.rows).to.equal(3);
+            expect(P.cols).to.equal(4);
+            var APA = linalg.matrix_mul(linalg.matrix_mul(A, P), A);
+            for (var i = 0; i < 12; i++) {
+                expect(APA.data[i]).to.be.closeTo(A.data[i], 1e-10);
+            }
+            expect(function () { linalg.lstsq(A, [1, 2]); }).to.throw(Error);
+        })
     })
 
     describe('cholesky', function () {
@@ -948,6 +1042,58 @@ describe('numjs.linalg - native extension to support linear algebra via the Eige
             //check v
             expect(svdObj.v).to.be.null;
         })
+
+        it('should give the same singular values with the jacobi and divide and conquer engines', function () {
+            var data = [];
+            for (var i = 0; i < 100 * 80; i++) {
+                data.push(Math.sin(i * 0.37) + (i % 13) * 0.01);
+            }
+            var jsMat = new linalg.Matrix(data, 100, 80);
+            var jacobi = linalg.svd(jsMat, false, false, null, 'jacobi').s, bdc = linalg.svd(jsMat, false, false, null, 'bdc').s,
+                auto = linalg.svd(jsMat, false, false).s;
+            for (i = 0; i < 80; i++) {
+                expect(bdc[i]).to.be.closeTo(jacobi[i], 1e-9);
+                expect(auto[i]).to.be.closeTo(jacobi[i], 1e-9);
+            }
+            expect(function () { linalg.svd(jsMat, false, false, null, 'lapack'); }).to.throw(Error);
+        })
+    })
+
+    describe('svd_k', function () {
+        it('should find the leading singular triplets of a tall low rank matrix', function () {
+            // the rank 2 matrix u1 * 5 * v1' + u2 * 2 * v2', 400 x 30
+            var rows = 400, cols = 30, data = new Float64Array(rows * cols);
+            for (var j = 0; j < cols; j++) {
+                for (var i = 0; i < rows; i++) {
+                    data[j * rows + i] = 5 * Math.cos(i) * Math.cos(j) + 2 * Math.sin(2 * i) * Math.sin(3 * j);
+                }
+            }
+            var jsMat = new linalg.Matrix(data, rows, cols), exact = linalg.svd(jsMat, false, false).s;
+            var res = linalg.svd_k(jsMat, 2);
+            expect(res.u.rows).to.equal(rows);
+            expect(res.u.cols).to.equal(2);
+            expect(res.v.rows).to.equal(cols);
+            expect(res.v.cols).to.equal(2);
+            expect(res.s[0]).to.be.closeTo(exact[0], 1e-8);
+            expect(res.s[1]).to.be.closeTo(exact[1], 1e-8);
+
+            // the first column of u * diag(s) * v' reproduces the first column of the matrix
+            for (i = 0; i < rows; i++) {
+                expect(res.u.data[i] * res.s[0] * res.v.data[0] + res.u.data[rows + i] * res.s[1] * res.v.data[cols])
+                    .to.be.closeTo(data[i], 1e-8);
+            }
+            expect(function () { linalg.svd_k(jsMat, 31); }).to.throw(Error);
+        })
+
+        it('should clamp a huge oversample and reject invalid oversample or power_iters', function () {
+            var jsMat = new linalg.Matrix([4, 0, 0, 0, 0, 3, 0, 0, 0, 0, 1, 0], 4, 3);
+            var res = linalg.svd_k(jsMat, 1, 0xffffffff);
+            expect(res.s[0]).to.be.closeTo(4, 1e-10);
+            expect(function () { linalg.svd_k(jsMat, 1, -1); }).to.throw(Error);
+            expect(function () { linalg.svd_k(jsMat, 1, 1.5); }).to.throw(Error);
+            expect(function () { linalg.svd_k(jsMat, 1, 10, -2); }).to.throw(Error);
+            expect(function () { linalg.svd_k(jsMat, 1, 10, 0.5); }).to.throw(Error);
+        })
     })
 
     describe('inv', function () {
@@ -957,10 +1103,10 @@ describe('numjs.linalg - native extension to support linear algebra via the Eige
             expect(matrix).to.have.property('rows').equal(2);
             expect(matrix).to.have.property('cols').equal(2);
             expect(matrix).to.have.property('data');
-            expect(matrix.data["0"]).to.equal(-1.9999999999999996);
-            expect(matrix.data["1"]).to.equal(1.4999999999999998);
-            expect(matrix.data["2"]).to.equal(0.9999999999999998);
-            expect(matrix.data["3"]).to.equal(-0.4999999999999999);
+            expect(matrix.data["0"]).to.equal(-2);
+            expect(matrix.data["1"]).to.equal(1.5);
+            expect(matrix.data["2"]).to.equal(1);
+            expect(matrix.data["3"]).to.equal(-0.5);
         })
 
         it('should return the id matrix (inverse of id)', function () {
@@ -990,6 +1136,58 @@ describe('numjs.linalg - native extension to support linear algebra via the Eige
         })
     })
 
+    describe('eigh, eig and eigsh', function () {
+        // a symmetric tridiagonal matrix with diagonal 1..n, its eigenvalues are well separated
+        var n = 60, rows = [], cols = [], vals = [];
+        for (var i = 0; i < n; i++) {
+            rows.push(i); cols.push(i); vals.push(i + 1);
+            if (i > 0) { rows.push(i); cols.push(i - 1); vals.push(0.1); rows.push(i - 1); cols.push(i); vals.push(0.1); }
+        }
+        var S = linalg.sparse(n, n, rows, cols, vals), A = linalg.sparse_to_dense(S);
+
+        it('should compute the real eigenpairs of a symmetric matrix', function () {
+            var res = linalg.eigh(new linalg.Matrix([2, 1, 1, 2], 2, 2));
+            expect(res.values[0]).to.be.closeTo(1, 1e-12);
+            expect(res.values[1]).to.be.closeTo(3, 1e-12);
+            expect(Math.abs(res.vectors.data[2])).to.be.closeTo(Math.SQRT1_2, 1e-12);
+            expect(res.vectors.data[2]).to.be.closeTo(res.vectors.data[3], 1e-12);
+            expect(linalg.eigh(A, false).vectors).to.equal(null);
+        })
+
+        it('should compute the complex eigenpairs of a general matrix', function () {
+            var res = linalg.eig(new linalg.Matrix([0, 1, -1, 0], 2, 2));
+            expect(res.values.length).to.equal(4);
+            expect(res.vectors.length).to.equal(8);
+            expect(res.values[0]).to.be.closeTo(0, 1e-12);
+            expect(Math.abs(res.values[1])).to.be.closeTo(1, 1e-12);
+            expect(res.values[3]).to.be.closeTo(-res.values[1], 1e-12);
+        })
+
+        it('should find the leading eigenpairs of dense and sparse matrices', function () {
+            var all = linalg.eigh(A, false).values;
+            [A, S].forEach(function (matrix) {
+                var top = linalg.eigsh(matrix, 4), bottom = linalg.eigsh(matrix, 3, {which: 'smallest', vectors: false});
+                expect(top.converged).to.equal(true);
+                expect(top.vectors.rows).to.equal(n);
+                expect(top.vectors.cols).to.equal(4);
+                expect(bottom.vectors).to.equal(null);
+                for (var i = 0; i < 4; i++) {
+                    expect(top.values[i]).to.be.closeTo(all[n - 1 - i], 1e-9);
+                }
+                for (i = 0; i < 3; i++) {
+                    expect(bottom.values[i]).to.be.closeTo(all[i], 1e-9);
+                }
+
+                var x = linalg.block(top.vectors, 0, 0, n, 1), Ax = linalg.matrix_mul(A, linalg.copy(x));
+                for (i = 0; i < n; i++) {
+                    expect(Ax.data[i]).to.be.closeTo(top.values[0] * top.vectors.data[i], 1e-8);
+                }
+            });
+            expect(function () { linalg.eigsh(A, n); }).to.throw(Error);
+            expect(function () { linalg.eigsh(A, 2, {which: 'middle'}); }).to.throw(Error);
+        })
+    })
+
     describe('matrix_solve_linear', function () {
         it('Should find the solution for \n\t\t\t({{0.8147,0.9134,0.2785},{0.9058,0.6324,0.5469},{0.1270,0.0975,0.9575}} X = {1,2,3})', function () {
             var da = new Float64Array([0.8147, 0.9058, 0.1270, 0.9134, 0.6324, 0.0975, 0.2785, 0.5469, 0.9575]);
@@ -1000,6 +1198,36 @@ describe('numjs.linalg - native extension to support linear algebra via the Eige
             expect(res[1]).to.be.within(-0.4 - EPS, -0.4 + EPS);
             expect(res[2]).to.be.within(3.0 - EPS, 3.0 + EPS);
         })
+
+        it('should solve every column of a matrix of right hand sides', function () {
+            var A = new linalg.Matrix([4, -1, 2, -1, 6, 0, 2, 0, 5], 3, 3);
+            var B = new linalg.Matrix([5, 5, 7, 4, -1, 2, 1, 0, 0], 3, 3);
+            var X = linalg.matrix_solve_linear(A, B);
+            expect(X).to.have.property('rows').equal(3);
+            expect(X).to.have.property('cols').equal(3);
+            var AX = linalg.matrix_mul(A, X);
+            for (var i = 0; i < 9; i++) {
+                expect(AX.data[i]).to.be.closeTo(B.data[i], 1e-12);
+            }
+            expect(linalg.matrix_solve_linear(A, B, B)).to.equal(B);
+            expect(B.data[0]).to.be.closeTo(1, 1e-12);
+            expect(B.data[3]).to.be.closeTo(1, 1e-12);
+        })
+
+        it('should solve a float32 least squares system with several right hand sides', function () {
+            var A = new linalg.Matrix([1, 1, 1, 0, 1, 2], 3, 2, {dtype: 'float32'});
+            var B = new linalg.Matrix([1, 3, 5, 2, 2, 2], 3, 2, {dtype: 'float32'});
+            var X = linalg.matrix_solve_linear(A, B);
+            expect(X.data).to.be.instanceof(Float32Array);
+            expect(X.rows).to.equal(2);
+            expect(X.cols).to.equal(2);
+            expect(X.data[0]).to.be.closeTo(1, 1e-5);
+            expect(X.data[1]).to.be.closeTo(2, 1e-5);
+            expect(X.data[2]).to.be.closeTo(2, 1e-5);
+            expect(X.data[3]).to.be.closeTo(0, 1e-5);
+            expect(function () { linalg.matrix_solve_linear(A, linalg.ones(2)); }).to.throw(Error);
+            expect(function () { linalg.matrix_solve_linear(A, linalg.ones(3, 2)); }).to.throw(Error);
+        })
     })
 
     describe('matrix_mul', function () {
@@ -1020,4 +1248,1042 @@ describe('numjs.linalg - native extension to support linear algebra via the Eige
             expect(res.data[8]).to.be.within(0.9 - EPS, 0.9 + EPS);
         })
     })
+
+    describe('async variants', function () {
+        it('inv_async should resolve with the inverse of a matrix [[1,2], [3,4]]', function () {
+            var jsMat = new linalg.Matrix([1, 3, 2, 4], 2, 2);
+            return linalg.inv_async(jsMat).then(function (matrix) {
+                var expected = linalg.inv(jsMat);
+                expect(matrix).to.have.property('rows').equal(2);
+                expect(matrix).to.have.property('cols').equal(2);
+                for (var i = 0; i < 4; i++) {
+                    expect(matrix.data[i]).to.equal(expected.data[i]);
+                }
+            });
+        })
+
+        it('inv_async should reject a non square matrix', function () {
+            var jsMat = new linalg.Matrix([1, 2, 3, 4, 5, 6], 2, 3);
+            return linalg.inv_async(jsMat).then(function () {
+                throw new Error("should have been rejected");
+            }, function (err) {
+                expect(err.message).to.equal("matrix must be square, i.e. M.rows == M.cols");
+            });
+        })
+
+        it('cholesky_async should resolve with the lower-triangular Cholesky factor', function () {
+            var jsMat = new linalg.Matrix([4, -1, 2, -1, 6, 0, 2, 0, 5], 3, 3);
+            return linalg.cholesky_async(jsMat).then(function (matrix) {
+                var expected = linalg.cholesky(jsMat);
+                for (var i = 0; i < 9; i++) {
+                    expect(matrix.data[i]).to.equal(expected.data[i]);
+                }
+            });
+        })
+
+        it('cholesky_async should reject a matrix which is not positive definite', function () {
+            var jsMat = new linalg.Matrix([1, 2, 2, 1], 2, 2);
+            return linalg.cholesky_async(jsMat).then(function () {
+                throw new Error("should have been rejected");
+            }, function (err) {
+                expect(err.message).to.equal("Matrix is not positive definite");
+            });
+        })
+
+        it('svd_async should resolve with u, s, v as full matrices', function () {
+            var jsMat = new linalg.Matrix([0.68, -0.211, 0.566, 0.597, 0.823, -0.605], 3, 2);
+            return linalg.svd_async(jsMat).then(function (res) {
+                var expected = linalg.svd(jsMat);
+                expect(res.u).to.have.property('rows').equal(3);
+                expect(res.v).to.have.property('rows').equal(2);
+                for (var i = 0; i < 2; i++) {
+                    expect(res.s[i]).to.equal(expected.s[i]);
+                }
+                for (var j = 0; j < 9; j++) {
+                    expect(res.u.data[j]).to.equal(expected.u.data[j]);
+                }
+            });
+        })
+
+        it('svd_async should resolve with only s when compute_uv is false', function () {
+            var jsMat = new linalg.Matrix([0.68, -0.211, 0.566, 0.597, 0.823, -0.605], 3, 2);
+            return linalg.svd_async(jsMat, false, false).then(function (res) {
+                expect(res.u).to.equal(null);
+                expect(res.v).to.equal(null);
+                expect(res.s[0]).to.be.within(1.1 - EPS, 1.1 + EPS);
+            });
+        })
+
+        it('matrix_eigen_values_async should resolve with the eigen values of ({{1,2,3},{4,5,6},{7,8,9}})', function () {
+            var mat = new linalg.Matrix(new Float64Array([1, 2, 3, 4, 5, 6, 7, 8, 9]), 3, 3);
+            return linalg.matrix_eigen_values_async(mat).then(function (res) {
+                expect(res[0]).to.be.within(16.1, 16.2);
+                expect(res[2]).to.be.within(-1.2, -1.1);
+            });
+        })
+
+        it('matrix_solve_linear_async should resolve with the solution of A*x = b', function () {
+            var da = new Float64Array([0.8147, 0.9058, 0.1270, 0.9134, 0.6324, 0.0975, 0.2785, 0.5469, 0.9575]);
+            var mat = new linalg.Matrix(da, 3, 3);
+            var b = new Float64Array([1, 2, 3]);
+            return linalg.matrix_solve_linear_async(mat, b).then(function (res) {
+                expect(res[0]).to.be.within(0.62 - EPS, 0.62 + EPS);
+                expect(res[1]).to.be.within(-0.4 - EPS, -0.4 + EPS);
+                expect(res[2]).to.be.within(3.0 - EPS, 3.0 + EPS);
+            });
+        })
+
+        it('matrix_mul_async should resolve with the product of two matrices', function () {
+            var A = new linalg.Matrix([1, 3, 2, 4], 2, 2);
+            var B = new linalg.Matrix([5, 7, 6, 8], 2, 2);
+            return linalg.matrix_mul_async(A, B).then(function (res) {
+                expect(res).to.have.property('rows').equal(2);
+                expect(res).to.have.property('cols').equal(2);
+                expect(res.data[0]).to.equal(19);
+                expect(res.data[1]).to.equal(43);
+                expect(res.data[2]).to.equal(22);
+                expect(res.data[3]).to.equal(50);
+            });
+        })
+    })
+
+    describe('set_num_threads / get_num_threads', function () {
+        it('should use at least one thread', function () {
+            expect(linalg.get_num_threads()).to.be.at.least(1);
+        })
+
+        it('should cap the native kernels at one thread', function () {
+            var previous = linalg.get_num_threads();
+            linalg.set_num_threads(1);
+            expect(linalg.get_num_threads()).to.equal(1);
+            linalg.set_num_threads(previous);
+            expect(linalg.get_num_threads()).to.equal(previous);
+        })
+
+        it('should throw when the number of threads is not a positive integer', function () {
+            expect(function () { linalg.set_num_threads(0); }).to.throw(Error);
+            expect(function () { linalg.set_num_threads(-2); }).to.throw(Error);
+            expect(function () { linalg.set_num_threads(1.5); }).to.throw(Error);
+        })
+    })
+
+    describe('batched functions', function () {
+        it('mat_mul_batched should multiply every pair of stacked matrices', function () {
+            var a = new Float64Array([1, 3, 2, 4, 1, 0, 0, 1]);
+            var b = new Float64Array([5, 7, 6, 8, 2, 3, 4, 5]);
+            var res = linalg.mat_mul_batched(a, b, 2, 2, 2, 2);
+            expect(res.length).to.equal(8);
+            expect(res[0]).to.equal(19);
+            expect(res[1]).to.equal(43);
+            expect(res[2]).to.equal(22);
+            expect(res[3]).to.equal(50);
+            expect(res[4]).to.equal(2);
+            expect(res[5]).to.equal(3);
+            expect(res[6]).to.equal(4);
+            expect(res[7]).to.equal(5);
+        })
+
+        it('mat_mul_batched and inv_batched should accept an input as out', function () {
+            var a = new Float64Array([1, 3, 2, 4, 1, 0, 0, 1]);
+            var b = new Float64Array([5, 7, 6, 8, 2, 3, 4, 5]);
+            expect(linalg.mat_mul_batched(a, b, 2, 2, 2, 2, a)).to.equal(a);
+            expect(Array.prototype.slice.call(a)).to.deep.equal([19, 43, 22, 50, 2, 3, 4, 5]);
+
+            var m = new Float64Array([4, 3, 6, 3]);
+            linalg.inv_batched(m, 1, 2, m);
+            expect(m[0]).to.be.closeTo(-0.5, 1e-12);
+            expect(m[1]).to.be.closeTo(0.5, 1e-12);
+            expect(m[2]).to.be.closeTo(1, 1e-12);
+            expect(m[3]).to.be.closeTo(-2 / 3, 1e-12);
+        })
+
+        it('mat_mul_batched should match matrix_mul on a large batch', function () {
+            var count = 200, a = new Float64Array(count * 12), b = new Float64Array(count * 8);
+            for (var i = 0; i < a.length; i++) a[i] = Math.sin(i);
+            for (var j = 0; j < b.length; j++) b[j] = Math.cos(j);
+            var out = new Float64Array(count * 6);
+            var res = linalg.mat_mul_batched(a, b, count, 3, 4, 2, out);
+            expect(res).to.equal(out);
+            var k = 137;
+            var expected = linalg.matrix_mul(new linalg.Matrix(a.subarray(k * 12, k * 12 + 12), 3, 4),
+                new linalg.Matrix(b.subarray(k * 8, k * 8 + 8), 4, 2));
+            for (var e = 0; e < 6; e++) {
+                expect(res[k * 6 + e]).to.be.closeTo(expected.data[e], 1e-12);
+            }
+        })
+
+        it('inv_batched should invert every stacked matrix', function () {
+            var data = new Float64Array([1, 3, 2, 4, 1, 0, 0, 1]);
+            var res = linalg.inv_batched(data, 2, 2);
+            expect(res[0]).to.be.closeTo(-2, 1e-12);
+            expect(res[1]).to.be.closeTo(1.5, 1e-12);
+            expect(res[2]).to.be.closeTo(1, 1e-12);
+            expect(res[3]).to.be.closeTo(-0.5, 1e-12);
+            expect(res[4]).to.equal(1);
+            expect(res[5]).to.equal(0);
+            expect(res[6]).to.equal(0);
+            expect(res[7]).to.equal(1);
+        })
+
+        it('det_batched should return one determinant per stacked matrix', function () {
+            var data = new Float64Array([1, 3, 2, 4, 2, 0, 0, 2, 1, 1, 1, 1]);
+            var res = linalg.det_batched(data, 3, 2);
+            expect(res.length).to.equal(3);
+            expect(res[0]).to.be.closeTo(-2, 1e-12);
+            expect(res[1]).to.be.closeTo(4, 1e-12);
+            expect(res[2]).to.be.closeTo(0, 1e-12);
+        })
+
+        it('solve_batched should solve every stacked system', function () {
+            var a = new Float64Array([2, 0, 0, 4, 1, 3, 2, 4]);
+            var b = new Float64Array([2, 8, 5, 11]);
+            var res = linalg.solve_batched(a, b, 2, 2);
+            expect(res[0]).to.be.closeTo(1, 1e-12);
+            expect(res[1]).to.be.closeTo(2, 1e-12);
+            expect(res[2]).to.be.closeTo(1, 1e-12);
+            expect(res[3]).to.be.closeTo(2, 1e-12);
+        })
+
+        it('should throw when the batch length does not match the shape', function () {
+            expect(function () { linalg.inv_batched(new Float64Array(7), 2, 2); }).to.throw(Error);
+            expect(function () { linalg.det_batched(new Float64Array(8), 2, 2, new Float64Array(3)); }).to.throw(Error);
+        })
+    })
+
+    describe('fixed size paths', function () {
+        it('inv should invert a 3X3 and a 4X4 matrix', function () {
+            [3, 4].forEach(function (n) {
+                var values = [];
+                for (var i = 0; i < n * n; i++) values.push(Math.sin(i + 1) + (i % (n + 1) === 0 ? n : 0));
+                var jsMat = new linalg.Matrix(values, n, n);
+                var product = linalg.matrix_mul(jsMat, linalg.inv(jsMat));
+                for (var r = 0; r < n; r++) {
+                    for (var c = 0; c < n; c++) {
+                        expect(product.data[c * n + r]).to.be.closeTo(r === c ? 1 : 0, 1e-12);
+                    }
+                }
+            });
+        })
+
+        it('det should return the determinant of a 3X3 and a 4X4 matrix', function () {
+            assert.closeTo(linalg.det(new linalg.Matrix([2, 0, 1, 1, 3, 0, 0, 1, 4], 3, 3)), 25, 1e-12);
+            assert.closeTo(linalg.det(new linalg.Matrix([1, 0, 0, 0, 0, 2, 0, 0, 0, 0, 3, 0, 5, 6, 7, 4], 4, 4)), 24, 1e-12);
+        })
+
+        it('matrix_mul should multiply a 4X4 matrix by a 4X1 vector', function () {
+            var A = linalg.identity(4);
+            var v = new linalg.Matrix([1, 2, 3, 4], 4, 1);
+            var res = linalg.matrix_mul(A, v);
+            expect(res).to.have.property('rows').equal(4);
+            expect(res).to.have.property('cols').equal(1);
+            for (var i = 0; i < 4; i++) {
+                expect(res.data[i]).to.equal(i + 1);
+            }
+        })
+
+        it('dot should multiply two 3X3 matrices', function () {
+            var A = new linalg.Matrix([1, 0, 0, 0, 2, 0, 0, 0, 3], 3, 3);
+            var B = linalg.ones(3);
+            var res = linalg.dot(A, B);
+            expect(res.data[0]).to.equal(1);
+            expect(res.data[1]).to.equal(2);
+            expect(res.data[2]).to.equal(3);
+            expect(res.data[8]).to.equal(3);
+        })
+
+        it('cholesky should return the lower-triangular factor of a 2X2 matrix', function () {
+            var res = linalg.cholesky(new linalg.Matrix([4, 2, 2, 5], 2, 2));
+            expect(res.data[0]).to.be.closeTo(2, 1e-12);
+            expect(res.data[1]).to.be.closeTo(1, 1e-12);
+            expect(res.data[2]).to.equal(0);
+            expect(res.data[3]).to.be.closeTo(2, 1e-12);
+        })
+
+        it('matrix_solve_linear should solve a 4X4 system', function () {
+            var A = new linalg.Matrix([2, 0, 0, 0, 0, 4, 0, 0, 0, 0, 5, 0, 1, 0, 0, 1], 4, 4);
+            var x = linalg.matrix_solve_linear(A, new Float64Array([3, 8, 10, 1]));
+            expect(x[0]).to.be.closeTo(1, 1e-12);
+            expect(x[1]).to.be.closeTo(2, 1e-12);
+            expect(x[2]).to.be.closeTo(2, 1e-12);
+            expect(x[3]).to.be.closeTo(1, 1e-12);
+        })
+    })
+
+    describe('float32 matrices', function () {
+        it('Matrix should take the dtype from the options or from a Float32Array', function () {
+            var single = new linalg.Matrix([1, 2, 3, 4], 2, 2, {dtype: 'float32'});
+            expect(single.dtype).to.equal('float32');
+            expect(single.data).to.be.an.instanceof(Float32Array);
+            expect(new linalg.Matrix(new Float32Array([1, 2, 3, 4]), 2, 2).dtype).to.equal('float32');
+            expect(new linalg.Matrix([1, 2, 3, 4], 2, 2).data).to.be.an.instanceof(Float64Array);
+            expect(function () { new linalg.Matrix([], 2, 2, {dtype: 'int8'}); }).to.throw(Error);
+        })
+
+        it('zeros, ones, empty, identity and eye should accept a dtype', function () {
+            expect(linalg.zeros(2, 3, 'float32').data).to.be.an.instanceof(Float32Array);
+            expect(linalg.ones(2, 2, 'float32').data[3]).to.equal(1);
+            expect(linalg.empty(4, null, 'float32').data.length).to.equal(16);
+            expect(linalg.identity(3, 'float32').data[4]).to.equal(1);
+            expect(linalg.eye(2, 3, 'float32').dtype).to.equal('float32');
+        })
+
+        it('matrix_mul and dot should multiply in single precision', function () {
+            var A = new linalg.Matrix([1, 3, 2, 4], 2, 2, {dtype: 'float32'});
+            var B = new linalg.Matrix([5, 7, 6, 8], 2, 2, {dtype: 'float32'});
+            var res = linalg.matrix_mul(A, B);
+            expect(res.data).to.be.an.instanceof(Float32Array);
+            expect(Array.prototype.slice.call(res.data)).to.deep.equal([19, 43, 22, 50]);
+            expect(Array.prototype.slice.call(linalg.dot(A, B).data)).to.deep.equal([19, 43, 22, 50]);
+            expect(Array.prototype.slice.call(linalg.dot(2, A).data)).to.deep.equal([2, 6, 4, 8]);
+        })
+
+        it('should refuse to mix float32 and float64 matrices', function () {
+            var A = new linalg.Matrix([1, 3, 2, 4], 2, 2, {dtype: 'float32'});
+            expect(function () { linalg.matrix_mul(A, linalg.ones(2)); }).to.throw(Error);
+            expect(function () { linalg.mat_mul_batched(new Float32Array(4), new Float64Array(4), 1, 2, 2, 2); }).to.throw(Error);
+        })
+
+        it('inv, det, cholesky and solve should run on float32 matrices', function () {
+            var A = new linalg.Matrix([4, 2, 2, 5], 2, 2, {dtype: 'float32'});
+            var inverse = linalg.inv(A);
+            expect(inverse.dtype).to.equal('float32');
+            expect(inverse.data[0]).to.be.closeTo(5 / 16, 1e-6);
+            expect(inverse.data[1]).to.be.closeTo(-2 / 16, 1e-6);
+            expect(linalg.det(A)).to.be.closeTo(16, 1e-5);
+            expect(linalg.cholesky(A).data[3]).to.be.closeTo(2, 1e-6);
+
+            var x = linalg.matrix_solve_linear(new linalg.Matrix([2, 0, 1, 1, 3, 0, 0, 1, 4], 3, 3, {dtype: 'float32'}), [3, 4, 5]);
+            expect(x).to.be.an.instanceof(Float32Array);
+            expect(x[0] * 2 + x[1] * 1).to.be.closeTo(3, 1e-5);
+            expect(x[1] * 3 + x[2] * 1).to.be.closeTo(4, 1e-5);
+            expect(x[0] * 1 + x[2] * 4).to.be.closeTo(5, 1e-5);
+        })
+
+        it('svd and matrix_eigen_values should return Float32Arrays', function () {
+            var A = new linalg.Matrix([3, 0, 0, 0, 2, 0, 0, 0, 1], 3, 3, {dtype: 'float32'});
+            var res = linalg.svd(A);
+            expect(res.s).to.be.an.instanceof(Float32Array);
+            expect(res.u.dtype).to.equal('float32');
+            expect(res.s[0]).to.be.closeTo(3, 1e-6);
+            expect(res.s[2]).to.be.closeTo(1, 1e-6);
+            var eigenValues = linalg.matrix_eigen_values(A);
+            expect(eigenValues).to.be.an.instanceof(Float32Array);
+            expect(eigenValues.length).to.equal(6);
+        })
+
+        it('the batched and async variants should keep the float32 type', function () {
+            var dets = linalg.det_batched(new Float32Array([1, 3, 2, 4, 2, 0, 0, 2]), 2, 2);
+            expect(dets).to.be.an.instanceof(Float32Array);
+            expect(dets[0]).to.be.closeTo(-2, 1e-6);
+            expect(dets[1]).to.be.closeTo(4, 1e-6);
+
+            return linalg.inv_async(new linalg.Matrix([2, 0, 0, 4], 2, 2, {dtype: 'float32'})).then(function (inverse) {
+                expect(inverse.data).to.be.an.instanceof(Float32Array);
+                expect(inverse.data[3]).to.equal(0.25);
+            });
+        })
+    })
+
+    describe('factorizations', function () {
+        var A = new linalg.Matrix([4, 1, 2, 1, 5, 0, 2, 0, 6], 3, 3);
+
+        it('lu, qr, cholesky_factor and ldlt should solve against the factorized matrix', function () {
+            [linalg.lu(A), linalg.qr(A), linalg.cholesky_factor(A), linalg.ldlt(A)].forEach(function (factor) {
+                expect(factor.rows).to.equal(3);
+                var x = factor.solve(new Float64Array([7, 6, 8]));
+                expect(x).to.be.an.instanceof(Float64Array);
+                expect(x[0]).to.be.closeTo(1, 1e-12);
+                expect(x[1]).to.be.closeTo(1, 1e-12);
+                expect(x[2]).to.be.closeTo(1, 1e-12);
+                assert.closeTo(factor.determinant(), 94, 1e-10);
+                expect(factor.rcond()).to.be.above(0).and.at.most(1);
+            });
+        })
+
+        it('solve should accept several right hand sides and solveInto should fill out', function () {
+            var lu = linalg.lu(A);
+            var x = lu.solve(new Float64Array([7, 6, 8, 4, 1, 2]));
+            expect(x.length).to.equal(6);
+            expect(x[3]).to.be.closeTo(1, 1e-12);
+            expect(x[4]).to.be.closeTo(0, 1e-12);
+
+            var b = new Float64Array([7, 6, 8]);
+            expect(lu.solveInto(b, b)).to.equal(true);
+            expect(b[2]).to.be.closeTo(1, 1e-12);
+            expect(function () { lu.solve(new Float64Array(4)); }).to.throw(Error);
+            expect(function () { lu.solveInto(new Float64Array(3), new Float64Array(2)); }).to.throw(Error);
+        })
+
+        it('determinant should keep the sign of the QR factorization', function () {
+            var B = new linalg.Matrix([0, 1, 1, 0], 2, 2);
+            assert.closeTo(linalg.qr(B).determinant(), -1, 1e-12);
+            assert.closeTo(linalg.lu(B).determinant(), -1, 1e-12);
+        })
+
+        it('qr should return the least squares solution of a non square system', function () {
+            var qr = linalg.qr(new linalg.Matrix([1, 1, 1, 0, 1, 2], 3, 2));
+            var x = qr.solve(new Float64Array([1, 2, 3]));
+            expect(x.length).to.equal(2);
+            expect(x[0]).to.be.closeTo(1, 1e-12);
+            expect(x[1]).to.be.closeTo(1, 1e-12);
+            expect(function () { qr.determinant(); }).to.throw(Error);
+        })
+
+        it('cholesky_factor should throw for a matrix which is not positive definite', function () {
+            expect(function () { linalg.cholesky_factor(new linalg.Matrix([1, 2, 2, 1], 2, 2)); }).to.throw(Error);
+            expect(function () { linalg.lu(new linalg.Matrix([1, 2, 3, 4, 5, 6], 2, 3)); }).to.throw(Error);
+        })
+
+        it('should factorize float32 matrices in single precision', function () {
+            var lu = linalg.lu(new linalg.Matrix([4, 1, 2, 1, 5, 0, 2, 0, 6], 3, 3, {dtype: 'float32'}));
+            var x = lu.solve(new Float32Array([7, 6, 8]));
+            expect(x).to.be.an.instanceof(Float32Array);
+            expect(x[1]).to.be.closeTo(1, 1e-5);
+            expect(function () { lu.solve(new Float64Array([7, 6, 8])); }).to.throw(Error);
+        })
+
+        it('logDeterminant should match the log of the determinant', function () {
+            [linalg.lu(A), linalg.qr(A), linalg.cholesky_factor(A), linalg.ldlt(A)].forEach(function (factor) {
+                assert.closeTo(factor.logDeterminant(), Math.log(94), 1e-12);
+            });
+        })
+
+        it('rankUpdate should update and downdate the cholesky factors in place', function () {
+            var v = new Float64Array([1, -2, 0.5]), updated = new linalg.Matrix([], 3, 3);
+            for (var i = 0; i < 3; i++) {
+                for (var j = 0; j < 3; j++) {
+                    updated.data[i + 3 * j] = A.data[i + 3 * j] + 2 * v[i] * v[j];
+                }
+            }
+            var b = new Float64Array([1, 2, 3]), expected = linalg.lu(updated).solve(b);
+
+            [linalg.cholesky_factor(A), linalg.ldlt(A)].forEach(function (factor) {
+                expect(factor.rankUpdate(v, 2)).to.equal(true);
+                var x = factor.solve(b);
+                for (var k = 0; k < 3; k++) {
+                    expect(x[k]).to.be.closeTo(expected[k], 1e-12);
+                }
+                assert.closeTo(factor.logDeterminant(), Math.log(linalg.det(updated)), 1e-12);
+                expect(factor.rcond()).to.be.above(0).and.at.most(1);
+
+                factor.rankUpdate(v, -2);
+                assert.closeTo(factor.determinant(), 94, 1e-10);
+            });
+            expect(linalg.lu(A).rankUpdate).to.equal(undefined);
+        })
+
+        it('a failed downdate should throw and keep the factors', function () {
+            var llt = linalg.cholesky_factor(A);
+            expect(function () { llt.rankUpdate(new Float64Array([10, 0, 0]), -1); }).to.throw(Error);
+            expect(function () { llt.rankUpdate(new Float64Array([1, 0])); }).to.throw(Error);
+            assert.closeTo(llt.determinant(), 94, 1e-10);
+        })
+    })
+
+    describe('native storage', function () {
+        it('matrices should be allocated on a 64 byte boundary', function () {
+            [linalg.zeros(3, 5), linalg.ones(7, null, 'float32'), linalg.empty(2), new linalg.Matrix([1, 2, 3], 1, 3)].forEach(function (mat) {
+                expect(mat.data.byteOffset).to.equal(0);
+                expect(mat.data.buffer.byteLength).to.equal(mat.rows * mat.cols * mat.data.BYTES_PER_ELEMENT);
+            });
+        })
+
+        it('zeros, ones and full should be filled natively', function () {
+            var zeros = linalg.zeros(30, 80), ones = linalg.ones(30, 80, 'float32'), full = linalg.full(30, 80, 2.5);
+            for (var i = 0; i < 30 * 80; i++) {
+                expect(zeros.data[i]).to.equal(0);
+                expect(ones.data[i]).to.equal(1);
+                expect(full.data[i]).to.equal(2.5);
+            }
+            expect(linalg.full(2, null, -1, 'float32').data).to.be.an.instanceof(Float32Array);
+            expect(function () { linalg.full(2, 2); }).to.throw(Error);
+        })
+
+        it('should copy the given values and reject a wrong length', function () {
+            var mat = new linalg.Matrix(new Float64Array([1, 2, 3, 4]), 2, 2);
+            expect(Array.prototype.slice.call(mat.data)).to.deep.equal([1, 2, 3, 4]);
+            expect(function () { new linalg.Matrix([1, 2, 3], 2, 2); }).to.throw(Error);
+        })
+
+        it('should scale aligned and unaligned buffers', function () {
+            var res = linalg.dot(linalg.full(5, 7, 3), 2);
+            expect(res.data[34]).to.equal(6);
+
+            var unaligned = new Float64Array(new ArrayBuffer(8 * 36), 8, 35);
+            unaligned.fill(1);
+            var mat = linalg.empty(5, 7);
+            mat.data = unaligned;
+            expect(linalg.dot(2, mat).data[34]).to.equal(2);
+        })
+    })
+
+    describe('out parameters and in-place variants', function () {
+        it('should write into a given out matrix and return it', function () {
+            var a = new linalg.Matrix([4, -1, 2, -1, 6, 0, 2, 0, 5], 3, 3), out = linalg.empty(3, 3);
+            expect(linalg.matrix_mul(a, a, out)).to.equal(out);
+            expect(out.data[0]).to.be.closeTo(21, 1e-12);
+            expect(linalg.inv(a, out)).to.equal(out);
+            expect(linalg.matrix_mul(a, out).data[4]).to.be.closeTo(1, 1e-12);
+            expect(linalg.tril(a, out).data[3]).to.equal(0);
+            expect(linalg.dot(a, 2, out).data[0]).to.equal(8);
+            expect(linalg.matrix_power(a, 1, out).data[8]).to.equal(5);
+        })
+
+        it('should reject an out parameter of the wrong shape or dtype', function () {
+            var a = linalg.ones(3);
+            expect(function () { linalg.inv(a, linalg.empty(2, 3)); }).to.throw(Error);
+            expect(function () { linalg.tril(a, linalg.empty(3, 3, 'float32')); }).to.throw(Error);
+            expect(function () { linalg.matrix_solve_linear(a, [1, 2, 3], new Float64Array(2)); }).to.throw(Error);
+            expect(function () { linalg.matrix_mul(a, a, {rows: 3, cols: 3}); }).to.throw(Error);
+        })
+
+        it('should fill the svd, eigen values and solve outputs', function () {
+            var a = new linalg.Matrix([4, -1, 2, -1, 6, 0, 2, 0, 5], 3, 3);
+            var u = linalg.empty(3, 3), s = new Float64Array(3), x = new Float64Array(3);
+            var res = linalg.svd(a, true, true, {u: u, s: s});
+            expect(res.u).to.equal(u);
+            expect(res.s).to.equal(s);
+            expect(s[0]).to.be.above(0);
+            expect(linalg.matrix_eigen_values(a, new Float64Array(6))).to.have.length(6);
+            expect(linalg.matrix_solve_linear(a, new Float64Array([4, -1, 2]), x)).to.equal(x);
+            expect(x[0]).to.be.closeTo(1, 1e-12);
+        })
+
+        it('should invert, factorize and scale in place', function () {
+            [2, 3, 4, 7].forEach(function (n) {
+                var a = linalg.full(n, n, -1), copy;
+                for (var i = 0; i < n; i++) { a.data[i * n + i] = 2 * n; }
+                copy = new linalg.Matrix(a.data, n, n);
+
+                expect(linalg.inv_(a)).to.equal(a);
+                var product = linalg.matrix_mul(copy, a);
+                for (var j = 0; j < n * n; j++) {
+                    expect(product.data[j]).to.be.closeTo(j % (n + 1) === 0 ? 1 : 0, 1e-12);
+                }
+
+                a = new linalg.Matrix(copy.data, n, n);
+                var factor = linalg.cholesky(copy);
+                linalg.cholesky_(a);
+                for (var k = 0; k < n * n; k++) {
+                    expect(a.data[k]).to.be.closeTo(factor.data[k], 1e-12);
+                }
+            });
+
+            var m = new linalg.Matrix([1, 2, 3, 4], 2, 2, {dtype: 'float32'});
+            expect(Array.prototype.slice.call(linalg.scale_(m, 0.5).data)).to.deep.equal([0.5, 1, 1.5, 2]);
+            expect(Array.prototype.slice.call(linalg.triu_(m).data)).to.deep.equal([0.5, 0, 1.5, 2]);
+            expect(Array.prototype.slice.call(linalg.tril_(m).data)).to.deep.equal([0.5, 0, 0, 2]);
+        })
+
+        it('should raise a matrix to a power into its own buffer', function () {
+            var a = new linalg.Matrix([1, 1, 0, 1], 2, 2);
+            linalg.matrix_power(a, 3, a);
+            expect(Array.prototype.slice.call(a.data)).to.deep.equal([1, 3, 0, 1]);
+        })
+
+        it('should accept out in the async variants', function () {
+            var a = new linalg.Matrix([2, 0, 0, 2], 2, 2), out = linalg.empty(2, 2);
+            return linalg.inv_async(a, out).then(function (res) {
+                expect(res).to.equal(out);
+                expect(out.data[0]).to.equal(0.5);
+            });
+        })
+    })
+
+    describe('expr', function () {
+        var A = new linalg.Matrix([1, 2, 3, 4, 5, 6], 2, 3), B = new linalg.Matrix([1, 0, 2, 1, 0, 3], 3, 2),
+            C = new linalg.Matrix([1, 1, 1, 1], 2, 2);
+
+        function expected(mat) {
+            return Array.prototype.slice.call(mat.data);
+        }
+
+        it('should evaluate A*B + s*C in one call', function () {
+            var reference = linalg.matrix_mul(A, B);
+            for (var i = 0; i < 4; i++) { reference.data[i] += 0.5; }
+            var res = linalg.expr(A).mul(B).add(linalg.expr(C).scale(0.5)).eval();
+            expect(expected(res)).to.deep.equal(expected(reference));
+        })
+
+        it('should support transposes, differences and nested products', function () {
+            var AtA = linalg.matrix_mul(linalg.matrix_mul(new linalg.Matrix([1, 3, 5, 2, 4, 6], 3, 2), A), B);
+            var res = linalg.expr(A).transpose().mul(A).mul(B).sub(B).eval();
+            for (var i = 0; i < 6; i++) {
+                expect(res.data[i]).to.be.closeTo(AtA.data[i] - B.data[i], 1e-12);
+            }
+
+            var sum = linalg.expr(C).add(C).add(C).add(linalg.expr(C).transpose()).mul(2).eval();
+            expect(expected(sum)).to.deep.equal([8, 8, 8, 8]);
+        })
+
+        it('should write into out, even when out is an operand', function () {
+            var out = linalg.ones(2, 2);
+            expect(linalg.expr(A).mul(B).add(out).eval(out)).to.equal(out);
+            var reference = linalg.matrix_mul(A, B);
+            expect(out.data[3]).to.equal(reference.data[3] + 1);
+        })
+
+        it('should throw for mismatching shapes and dtypes', function () {
+            expect(function () { linalg.expr(A).add(B); }).to.throw(Error);
+            expect(function () { linalg.expr(A).mul(A); }).to.throw(Error);
+            expect(function () { linalg.expr(C).add(linalg.ones(2, 2, 'float32')); }).to.throw(Error);
+            expect(function () { linalg.expr([1, 2]); }).to.throw(Error);
+        })
+
+        it('should evaluate float32 expressions', function () {
+            var a = linalg.full(4, 4, 2, 'float32');
+            var res = linalg.expr(a).mul(a).sub(a).eval();
+            expect(res.data).to.be.an.instanceof(Float32Array);
+            expect(res.data[5]).to.equal(14);
+        })
+    })
+
+    describe('views', function () {
+        // 4x3 matrix with A(i, j) = 10 * i + j
+        var A = new linalg.Matrix([0, 10, 20, 30, 1, 11, 21, 31, 2, 12, 22, 32], 4, 3);
+
+        function values(mat) {
+            return Array.prototype.slice.call(linalg.copy(mat).data);
+        }
+
+        it('block and transpose should share the data of their input', function () {
+            var block = linalg.block(A, 1, 1, 2, 2), t = linalg.transpose(A);
+            expect(values(block)).to.deep.equal([11, 21, 12, 22]);
+            expect(values(t)).to.deep.equal([0, 1, 2, 10, 11, 12, 20, 21, 22, 30, 31, 32]);
+            expect(values(linalg.block(t, 1, 2, 2, 1))).to.deep.equal([21, 22]);
+            expect(block.data.buffer).to.equal(A.data.buffer);
+            expect(function () { linalg.block(A, 3, 0, 2, 1); }).to.throw(Error);
+        })
+
+        it('matrix_mul and dot should multiply views without copying them', function () {
+            var AtA = linalg.matrix_mul(linalg.transpose(A), A), reference = linalg.matrix_mul(linalg.copy(linalg.transpose(A)), A);
+            expect(Array.prototype.slice.call(AtA.data)).to.deep.equal(Array.prototype.slice.call(reference.data));
+
+            var rows = linalg.block(A, 1, 0, 2, 3), cols = linalg.block(A, 0, 1, 3, 2);
+            var product = linalg.dot(rows, cols), expected = linalg.matrix_mul(linalg.copy(rows), linalg.copy(cols));
+            expect(Array.prototype.slice.call(product.data)).to.deep.equal(Array.prototype.slice.call(expected.data));
+            expect(values(linalg.dot(2, rows))).to.deep.equal([20, 40, 22, 42, 24, 44]);
+        })
+
+        it('inner should read views in place', function () {
+            var left = linalg.block(A, 0, 1, 2, 2), right = linalg.transpose(linalg.block(A, 2, 0, 2, 2));
+            var res = linalg.inner(left, right), expected = linalg.inner(linalg.copy(left), linalg.copy(right));
+            expect(Array.prototype.slice.call(res.data)).to.deep.equal(Array.prototype.slice.call(expected.data));
+        })
+
+        it('solvers and factorizations should accept views', function () {
+            var M = new linalg.Matrix([4, 1, 0, 9, 1, 3, 0, 9, 0, 0, 2, 9], 4, 3), b = new Float64Array([1, 2, 3]);
+            var top = linalg.block(M, 0, 0, 3, 3), topT = linalg.transpose(top);
+            var x = linalg.matrix_solve_linear(topT, b), expected = linalg.matrix_solve_linear(linalg.copy(topT), b);
+            for (var i = 0; i < 3; i++) {
+                expect(x[i]).to.be.closeTo(expected[i], 1e-12);
+            }
+            expect(linalg.lu(top).determinant()).to.be.closeTo(22, 1e-12);
+            expect(linalg.cholesky_factor(topT).solve(b)[2]).to.be.closeTo(1.5, 1e-12);
+        })
+
+        it('other functions should copy views, out parameters must be dense', function () {
+            var block = linalg.block(A, 0, 0, 2, 2);
+            expect(linalg.trace(block)).to.equal(11);
+            expect(linalg.det(linalg.transpose(block))).to.equal(-10);
+            expect(values(linalg.expr(block).add(linalg.transpose(block)).eval())).to.deep.equal([0, 11, 11, 22]);
+            expect(function () { linalg.inv(linalg.eye(2), block); }).to.throw(Error);
+            expect(function () { linalg.scale_(block, 2); }).to.throw(Error);
+        })
+    })
+
+    describe('sparse matrices', function () {
+        // [[4, 0, 1], [0, 3, 0], [1, 0, 5]] in CSC
+        var S = new linalg.SparseMatrix(3, 3, [0, 2, 3, 5], [0, 2, 1, 0, 2], [4, 1, 3, 1, 5]);
+
+        function values(mat) {
+            return Array.prototype.slice.call(mat.data);
+        }
+
+        it('should validate the compressed arrays', function () {
+            expect(S.nnz).to.equal(5);
+            expect(S.indptr).to.be.an.instanceof(Int32Array);
+            expect(function () { new linalg.SparseMatrix(3, 3, [0, 2, 3], [0, 2, 1], [4, 1, 3]); }).to.throw(Error);
+            expect(function () { new linalg.SparseMatrix(3, 3, [0, 2, 3, 5], [2, 0, 1, 0, 2], [4, 1, 3, 1, 5]); }).to.throw(Error);
+            expect(function () { new linalg.SparseMatrix(3, 3, [0, 2, 3, 5], [0, 3, 1, 0, 2], [4, 1, 3, 1, 5]); }).to.throw(Error);
+        })
+
+        it('should build matrices from triplets and convert them to dense', function () {
+            var T = linalg.sparse(3, 3, [2, 0, 1, 0, 2, 0], [0, 0, 1, 2, 2, 0], [1, 2, 3, 1, 5, 2], {format: 'csr'});
+            expect(T.format).to.equal('csr');
+            expect(values(linalg.sparse_to_dense(T))).to.deep.equal(values(linalg.sparse_to_dense(S)));
+            expect(values(linalg.sparse_to_dense(S))).to.deep.equal([4, 0, 1, 0, 3, 0, 1, 0, 5]);
+            expect(function () { linalg.sparse(2, 2, [2], [0], [1]); }).to.throw(Error);
+        })
+
+        it('should multiply sparse and dense matrices', function () {
+            var D = new linalg.Matrix([1, 2, 3, 4, 5, 6], 3, 2), dense = linalg.sparse_to_dense(S);
+            expect(values(linalg.sparse_dot(S, D))).to.deep.equal(values(linalg.matrix_mul(dense, D)));
+
+            var L = new linalg.Matrix([1, 2, 3, 4, 5, 6], 2, 3), out = linalg.empty(2, 3);
+            expect(linalg.sparse_dot(L, S, out)).to.equal(out);
+            expect(values(out)).to.deep.equal(values(linalg.matrix_mul(L, dense)));
+
+            var S2 = linalg.sparse_dot(S, linalg.sparse(3, 3, [0, 1, 2], [0, 1, 2], [1, 2, 3], {format: 'csr'}));
+            expect(S2).to.be.an.instanceof(linalg.SparseMatrix);
+            expect(values(linalg.sparse_to_dense(S2))).to.deep.equal([4, 0, 1, 0, 6, 0, 3, 0, 15]);
+            expect(function () { linalg.sparse_dot(S, linalg.ones(2)); }).to.throw(Error);
+        })
+
+        it('should factorize and solve with the sparse direct solvers', function () {
+            var b = new Float64Array([7, 6, 16]);
+            ['sparse_cholesky_factor', 'sparse_ldlt', 'sparse_lu'].forEach(function (name) {
+                var factor = linalg[name](S), x = factor.solve(b);
+                expect(x[0]).to.be.closeTo(1, 1e-12);
+                expect(x[1]).to.be.closeTo(2, 1e-12);
+                expect(x[2]).to.be.closeTo(3, 1e-12);
+                expect(factor.determinant()).to.be.closeTo(57, 1e-9);
+                expect(isNaN(factor.rcond())).to.equal(true);
+            });
+            expect(function () { linalg.sparse_cholesky_factor(linalg.sparse(2, 2, [0, 1], [0, 1], [-1, -1])); }).to.throw(Error);
+        })
+
+        it('should handle a large sparse system in float32 and float64', function () {
+            var n = 100000, rows = [], cols = [], vals = [];
+            for (var i = 0; i < n; i++) {
+                rows.push(i); cols.push(i); vals.push(4);
+                if (i > 0) { rows.push(i); cols.push(i - 1); vals.push(-1); rows.push(i - 1); cols.push(i); vals.push(-1); }
+            }
+            ['float64', 'float32'].forEach(function (dtype) {
+                var A = linalg.sparse(n, n, rows, cols, vals, {dtype: dtype});
+                var ones = new linalg.Matrix([], n, 1, {isOnes: true, dtype: dtype});
+                var b = linalg.sparse_dot(A, ones).data;
+                var x = linalg.sparse_cholesky_factor(A).solve(b);
+                expect(x).to.be.an.instanceof(dtype === 'float32' ? Float32Array : Float64Array);
+                expect(x[n / 2]).to.be.closeTo(1, 1e-4);
+            });
+        })
+    })
+
+    describe('iterative solvers', function () {
+        // [[4, 0, 1], [0, 3, 0], [1, 0, 5]], symmetric positive definite, x = [1, 2, 3] for b = [7, 6, 16]
+        var S = new linalg.SparseMatrix(3, 3, [0, 2, 3, 5], [0, 2, 1, 0, 2], [4, 1, 3, 1, 5]),
+            A = linalg.sparse_to_dense(S), b = new Float64Array([7, 6, 16]);
+
+        function expectSolution(x) {
+            expect(x[0]).to.be.closeTo(1, 1e-8);
+            expect(x[1]).to.be.closeTo(2, 1e-8);
+            expect(x[2]).to.be.closeTo(3, 1e-8);
+        }
+
+        it('should solve dense and sparse systems', function () {
+            ['cg', 'bicgstab', 'lscg'].forEach(function (name) {
+                [A, S, linalg.transpose(A)].forEach(function (matrix) {
+                    var res = linalg[name](matrix, b, {tol: 1e-12});
+                    expect(res.converged).to.equal(true);
+                    expect(res.error).to.be.below(1e-10);
+                    expectSolution(res.x);
+                });
+            });
+        })
+
+        it('should start from the initial guess and stop at the iteration cap', function () {
+            var res = linalg.cg(S, b, {x0: [1, 2, 3]});
+            expect(res.iterations).to.equal(0);
+            expectSolution(res.x);
+
+            var out = new Float64Array(3);
+            res = linalg.cg(A, b, {maxIterations: 1, out: out});
+            expect(res.x).to.equal(out);
+            expect(res.iterations).to.equal(1);
+            expect(res.converged).to.equal(false);
+        })
+
+        it('should solve overdetermined systems in the least squares sense', function () {
+            var T = linalg.sparse(4, 2, [0, 1, 2, 3], [0, 1, 0, 1], [1, 1, 1, 1]);
+            var res = linalg.lscg(T, [1, 2, 3, 4], {tol: 1e-12});
+            expect(res.x[0]).to.be.closeTo(2, 1e-8);
+            expect(res.x[1]).to.be.closeTo(3, 1e-8);
+            expect(function () { linalg.cg(T, [1, 2, 3, 4]); }).to.throw(Error);
+            expect(function () { linalg.cg(S, [1, 2]); }).to.throw(Error);
+        })
+    })
+
+    describe('npy files', function () {
+        var fs = require('fs'), os = require('os'), path = require('path');
+        var dir = fs.mkdtempSync(path.join(os.tmpdir(), 'numjs-linalg-'));
+
+        it('should save and load float64 and float32 matrices', function () {
+            var A = new linalg.Matrix([1, 2, 3, 4, 5, 6], 2, 3), B = new linalg.Matrix([1.5, -2, 3, 0.25], 2, 2, {dtype: 'float32'});
+            linalg.save(path.join(dir, 'a.npy'), A);
+            linalg.save(path.join(dir, 'b.npy'), B);
+            [false, true].forEach(function (mmap) {
+                var a = linalg.load(path.join(dir, 'a.npy'), {mmap: mmap}), b = linalg.load(path.join(dir, 'b.npy'), {mmap: mmap});
+                expect(a.rows).to.equal(2);
+                expect(a.cols).to.equal(3);
+                expect(Array.prototype.slice.call(a.data)).to.deep.equal([1, 2, 3, 4, 5, 6]);
+                expect(b.data).to.be.instanceof(Float32Array);
+                expect(Array.prototype.slice.call(b.data)).to.deep.equal([1.5, -2, 3, 0.25]);
+            });
+        })
+
+        it('should map a file copy on write', function () {
+            var file = path.join(dir, 'w.npy');
+            linalg.save(file, linalg.full(4, 4, 2));
+            var W = linalg.load(file, {mmap: true});
+            W.data[0] = 7;
+            expect(linalg.matrix_mul(W, linalg.eye(4)).data[0]).to.equal(7);
+            expect(linalg.load(file).data[0]).to.equal(2);
+        })
+
+        it('should load C order arrays and reject unsupported ones', function () {
+            var file = path.join(dir, 'c.npy'), dict = "{'descr': '<f8', 'fortran_order': False, 'shape': (2, 3), }";
+            var header = Buffer.alloc(64, ' ');
+            header.write('\x93NUMPY\x01\x00', 0, 'latin1');
+            header.writeUInt16LE(54, 8);
+            header.write(dict, 10, 'latin1');
+            header[63] = 0x0a;
+            fs.writeFileSync(file, Buffer.concat([header, Buffer.from(new Float64Array([1, 2, 3, 4, 5, 6]).buffer)]));
+            [false, true].forEach(function (mmap) {
+                var C = linalg.copy(linalg.load(file, {mmap: mmap}));
+                expect(C.rows).to.equal(2);
+                expect(C.cols).to.equal(3);
+                expect(Array.prototype.slice.call(C.data)).to.deep.equal([1, 4, 2, 5, 3, 6]);
+            });
+
+            fs.writeFileSync(file, Buffer.concat([Buffer.from(header.toString('latin1').replace('<f8', '<i8'), 'latin1'), Buffer.alloc(48)]));
+            expect(function () { linalg.load(file); }).to.throw(Error);
+            fs.writeFileSync(file, header);
+            expect(function () { linalg.load(file, {mmap: true}); }).to.throw(Error);
+        })
+
+        it('mat_mul_tiled should multiply .npy files block by block', function () {
+            var A = new linalg.Matrix([], 7, 5), B = new linalg.Matrix([], 5, 6);
+            for (var i = 0; i < A.data.length; i++) { A.data[i] = Math.sin(i); }
+            for (i = 0; i < B.data.length; i++) { B.data[i] = Math.cos(i); }
+            linalg.save(path.join(dir, 'ta.npy'), A);
+            linalg.save(path.join(dir, 'tb.npy'), B);
+
+            [1, 2, 3, 16].forEach(function (tile) {
+                linalg.mat_mul_tiled(path.join(dir, 'ta.npy'), path.join(dir, 'tb.npy'), path.join(dir, 'tc.npy'), tile);
+                var C = linalg.load(path.join(dir, 'tc.npy')), expected = linalg.matrix_mul(A, B);
+                expect(C.rows).to.equal(7);
+                expect(C.cols).to.equal(6);
+                for (var j = 0; j < expected.data.length; j++) {
+                    expect(C.data[j]).to.be.closeTo(expected.data[j], 1e-12);
+                }
+            });
+
+            expect(function () { linalg.mat_mul_tiled(path.join(dir, 'tb.npy'), path.join(dir, 'tb.npy'), path.join(dir, 'tc.npy')); }).to.throw(Error);
+            expect(function () { linalg.mat_mul_tiled(path.join(dir, 'ta.npy'), path.join(dir, 'tb.npy'), path.join(dir, 'tb.npy')); }).to.throw(Error);
+        })
+
+        it('the native mapping should refuse a region past the end of the file', function () {
+            // the wrappers check the sizes too, the bindings must not fault when called directly
+            var native = require('../build/Release/numjs.linalg'), file = path.join(dir, 'short.bin');
+            fs.writeFileSync(file, Buffer.alloc(64));
+            expect(native.map_file(file, 0, 8, false).length).to.equal(8);
+            expect(function () { native.map_file(file, 8, 8, false); }).to.throw(Error);
+            expect(function () { native.map_file(file, 0, 9, false); }).to.throw(Error);
+        })
+    })
+
+    describe('gram_accumulator', function () {
+        // 5 rows of 3 columns, far from zero so a naive sum of squares would lose the covariance
+        var rows = [[1e6 + 1, 2, 3], [1e6 + 4, 5, 7], [1e6 + 2, 8, 1], [1e6 + 6, 3, 9], [1e6 + 5, 7, 4]];
+        var X = linalg.copy(linalg.transpose(new linalg.Matrix([].concat.apply([], rows), 3, 5)));
+
+        function chunk(from, to) {
+            return new Float64Array([].concat.apply([], rows.slice(from, to)));
+        }
+
+        it('should accumulate the Gram matrix, means and covariance over several chunks', function () {
+            var acc = linalg.gram_accumulator(3);
+            expect(acc.add(chunk(0, 2)).add(chunk(2, 3)).add(linalg.block(X, 3, 0, 2, 3)).count()).to.equal(5);
+
+            var gram = acc.gram(), expected = linalg.matrix_mul(linalg.transpose(X), X);
+            expect(gram.rows).to.equal(3);
+            for (var i = 0; i < 9; i++) {
+                expect(gram.data[i]).to.be.closeTo(expected.data[i], 1e-9 * Math.abs(expected.data[i]) + 1e-9);
+            }
+
+            var mean = acc.mean();
+            expect(mean[0]).to.be.closeTo(1e6 + 3.6, 1e-6);
+            expect(mean[1]).to.be.closeTo(5, 1e-12);
+            expect(mean[2]).to.be.closeTo(4.8, 1e-12);
+
+            var covariance = acc.covariance();
+            expect(covariance.data[0]).to.be.closeTo(4.3, 1e-9);
+            expect(covariance.data[4]).to.be.closeTo(6.5, 1e-9);
+            expect(covariance.data[3]).to.be.closeTo(0.25, 1e-9);
+            expect(covariance.data[1]).to.equal(covariance.data[3]);
+            expect(covariance.data[7]).to.be.closeTo(-4, 1e-9);
+            expect(acc.covariance(0).data[4]).to.be.closeTo(5.2, 1e-9);
+
+            var correlation = acc.correlation();
+            expect(correlation.data[0]).to.be.closeTo(1, 1e-12);
+            expect(correlation.data[3]).to.be.closeTo(0.25 / Math.sqrt(4.3 * 6.5), 1e-9);
+        })
+
+        it('should write into out, accept plain arrays and float32 results and reset', function () {
+            var acc = linalg.gram_accumulator(3, 'float32').add([].concat.apply([], rows)), out = linalg.empty(3, 3, 'float32');
+            expect(acc.covariance(1, out)).to.equal(out);
+            expect(out.data[4]).to.be.closeTo(6.5, 1e-5);
+            expect(acc.mean()).to.be.an.instanceof(Float32Array);
+            expect(function () { acc.gram(linalg.empty(3, 3)); }).to.throw(Error);
+
+            acc.reset();
+            expect(acc.count()).to.equal(0);
+            expect(function () { acc.covariance(); }).to.throw(Error);
+            expect(function () { acc.add(new Float64Array(4)); }).to.throw(Error);
+            expect(function () { linalg.gram_accumulator(0); }).to.throw(Error);
+        })
+    })
+
+    describe('stats', function () {
+        afterEach(function () {
+            linalg.enable_stats(false);
+            linalg.reset_stats();
+        })
+
+        it('should record nothing while disabled', function () {
+            linalg.inv(linalg.eye(3));
+            var stats = linalg.stats();
+            expect(stats.enabled).to.equal(false);
+            expect(stats.native).to.deep.equal({});
+            expect(stats.functions).to.deep.equal({});
+        })
+
+        it('should record calls, native time, bytes and wrapper allocations', function () {
+            var a = new linalg.Matrix([4, -1, 2, -1, 6, 0, 2, 0, 5], 3, 3);
+            linalg.enable_stats(true);
+            linalg.inv(a);
+            linalg.inv(a);
+            linalg.inv_(linalg.copy(a));
+            linalg.matrix_solve_linear(a, [1, 2, 3]);
+
+            var stats = linalg.stats();
+            expect(stats.enabled).to.equal(true);
+            expect(stats.native.inv.calls).to.equal(3);
+            expect(stats.native.inv.bytes).to.equal(3 * 2 * 9 * 8);
+            expect(stats.native.inv.elements).to.deep.equal({16: 3});
+            expect(stats.native.inv.timeMs).to.be.at.least(0);
+            expect(stats.functions.inv.calls).to.equal(2);
+            expect(stats.functions.inv.allocatedBytes).to.equal(2 * 9 * 8);
+            expect(stats.functions.inv_.calls).to.equal(1);
+            expect(stats.functions.matrix_solve_linear.allocatedBytes).to.equal(2 * 3 * 8);
+
+            linalg.reset_stats();
+            expect(linalg.stats().native).to.deep.equal({});
+        })
+
+        it('should time async bindings until their callback', function () {
+            linalg.enable_stats(true);
+            return linalg.inv_async(linalg.eye(4)).then(function () {
+                var stats = linalg.stats();
+                expect(stats.native.inv_async.calls).to.equal(1);
+                expect(stats.functions.inv_async.calls).to.equal(1);
+                return linalg.svd_async(linalg.eye(4), false);
+            }).then(function (res) {
+                // svd_async takes its callback before the algorithm argument
+                expect(res.s[0]).to.be.closeTo(1, 1e-12);
+                expect(linalg.stats().native.svd_async.calls).to.equal(1);
+            });
+        })
+    })
+
+    describe('buffer pool', function () {
+        afterEach(function () {
+            linalg.clear_pool();
+        })
+
+        it('release should give the storage of a matrix to the next allocation', function () {
+            var a = linalg.inv(linalg.eye(3)), before = linalg.pool_stats();
+            expect(linalg.release(a)).to.equal(true);
+            expect(linalg.release(a)).to.equal(false);
+            expect(linalg.release(new Float64Array(9))).to.equal(false);
+
+            var b = linalg.zeros(2, 4);
+            expect(b.data.buffer).to.equal(a.data.buffer);
+            expect(b.data.length).to.equal(8);
+            expect(Array.prototype.slice.call(b.data)).to.deep.equal([0, 0, 0, 0, 0, 0, 0, 0]);
+            expect(linalg.pool_stats().hits).to.equal(before.hits + 1);
+            expect(linalg.pool_stats().releases).to.equal(before.releases + 1);
+        })
+
+        it('with_pool should keep the result and reuse every other buffer', function () {
+            var A = new linalg.Matrix([4, 1, 2, 1, 5, 0, 2, 0, 6], 3, 3), results = [];
+            for (var i = 0; i < 5; i++) {
+                results.push(linalg.with_pool(function () {
+                    return linalg.matrix_mul(linalg.inv(A), A);
+                }));
+            }
+
+            var stats = linalg.pool_stats();
+            expect(stats.hits).to.be.at.least(4);
+            expect(stats.bytes).to.equal(9 * 8);
+            results.forEach(function (result) {
+                expect(result.data[0]).to.be.closeTo(1, 1e-12);
+                expect(result.data[1]).to.be.closeTo(0, 1e-12);
+            });
+            expect(results[0].data.buffer).to.not.equal(results[1].data.buffer);
+        })
+
+        it('with_pool should wait for a returned promise and rethrow errors', function () {
+            expect(function () {
+                linalg.with_pool(function () { linalg.empty(4, 4); throw new Error('boom'); });
+            }).to.throw('boom');
+            expect(linalg.pool_stats().bytes).to.equal(16 * 8);
+
+            var hits = linalg.pool_stats().hits;
+            // eye reuses the buffer released by the failed scope, given back again once the inverse is computed
+            return linalg.with_pool(function () {
+                return linalg.inv_async(linalg.eye(4));
+            }).then(function (inverse) {
+                expect(inverse.data[0]).to.equal(1);
+                expect(linalg.pool_stats().hits).to.equal(hits + 1);
+                expect(linalg.pool_stats().bytes).to.equal(16 * 8);
+            });
+        })
+
+        it('with_pool should not give back the buffers of an async call still running', function () {
+            linalg.clear_pool();
+            var A = new linalg.Matrix([2, 0, 0, 4], 2, 2), inverse, pending;
+            linalg.with_pool(function () {
+                pending = linalg.inv_async(linalg.matrix_mul(A, linalg.eye(2))).then(function (result) {
+                    // the product is back in the pool by now, the result is not: same size allocations get other buffers
+                    var product = linalg.matrix_mul(result, A), zeros = linalg.zeros(2, 2), more = linalg.zeros(2, 2);
+                    [product, zeros, more].forEach(function (matrix) {
+                        expect(matrix.data.buffer).to.not.equal(result.data.buffer);
+                    });
+                    inverse = Array.prototype.slice.call(result.data);
+                });
+                return 1;
+            });
+
+            // only the buffer of eye is free, the product and the inverse are still in use by the worker
+            expect(linalg.pool_stats().bytes).to.equal(4 * 8);
+            var hits = linalg.pool_stats().hits;
+            linalg.zeros(2, 2);
+            linalg.zeros(2, 2);
+            expect(linalg.pool_stats().hits).to.equal(hits + 1);
+
+            return pending.then(function () {
+                expect(inverse).to.deep.equal([0.5, 0, 0, 0.25]);
+                expect(linalg.pool_stats().hits).to.equal(hits + 2);
+                expect(linalg.pool_stats().bytes).to.equal(0);
+            });
+        })
+    })
+
+    describe('cpu_features', function () {
+        it('should report the instruction set of the loaded build', function () {
+            var cpu = linalg.cpu_features();
+            expect(['sse2', 'avx2', 'avx512']).to.include(cpu.isa);
+            expect(cpu.simd).to.be.a('string');
+            expect(cpu.features).to.have.all.keys('sse2', 'sse4_2', 'avx', 'avx2', 'fma', 'avx512f', 'avx512dq', 'avx512bw', 'avx512vl');
+            if (cpu.isa === 'avx512') {
+                expect(cpu.features.avx512f).to.equal(true);
+                expect(cpu.simd).to.contain('AVX512');
+            }
+            if (cpu.isa === 'avx2') {
+                expect(cpu.features.avx2).to.equal(true);
+            }
+        })
+    })
 })
\ No newline at end of file